@@ -0,0 +1,73 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <string>
+#include <benchmark/benchmark.h>
+
+#include "csgp4/SGP4.h"
+#include "csgp4/Eci.h"
+#include "csgp4/Observer.h"
+#include "csgp4/CoordTopocentric.h"
+#include "csgp4/DateTime.h"
+#include "csgp4/SolarPosition.h"
+
+#include "common.h"
+
+static void BM_Eci_ToGeodetic(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    const csgp4::Eci eci = sgp4.FindPosition(60.0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(eci.ToGeodetic());
+    }
+}
+BENCHMARK(BM_Eci_ToGeodetic);
+
+static void BM_Observer_GetLookAngle(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    csgp4::Observer observer(obs_lat, obs_lon, obs_hgt);
+    const csgp4::Eci eci = sgp4.FindPosition(60.0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(observer.GetLookAngle(eci));
+    }
+}
+BENCHMARK(BM_Observer_GetLookAngle);
+
+static void BM_DateTime_ToGreenwichSiderealTime(benchmark::State& state)
+{
+    const csgp4::DateTime date(2022, 11, 10, 12, 0, 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(date.ToGreenwichSiderealTime());
+    }
+}
+BENCHMARK(BM_DateTime_ToGreenwichSiderealTime);
+
+static void BM_SolarPosition_FindPosition(benchmark::State& state)
+{
+    const csgp4::DateTime date(2022, 11, 10, 12, 0, 0);
+    csgp4::SolarPosition sun;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sun.FindPosition(date));
+    }
+}
+BENCHMARK(BM_SolarPosition_FindPosition);
@@ -0,0 +1,308 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "csgp4/SGP4.h"
+#include "csgp4/SGP4Batch.h"
+#include "csgp4/SGP4BatchFloat.h"
+#include "csgp4/SGP4Stepper.h"
+#include "csgp4/Kepler.h"
+#include "csgp4/ChebyshevEphemeris.h"
+#include "csgp4/CatalogPropagator.h"
+
+#include "common.h"
+
+
+static void BM_FindPosition_leo(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sgp4.FindPosition(tsince));
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_FindPosition_leo);
+
+static void BM_FindPositionOnly_leo(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sgp4.FindPositionOnly(tsince));
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_FindPositionOnly_leo);
+
+static void BM_FindPosition_geo(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(geo_tle1, geo_tle2));
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sgp4.FindPosition(tsince));
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_FindPosition_geo);
+
+static void BM_FindPositionOnly_geo(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(geo_tle1, geo_tle2));
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sgp4.FindPositionOnly(tsince));
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_FindPositionOnly_geo);
+
+static void BM_FindPosition_meo(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(gps_tle1, gps_tle2));
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sgp4.FindPosition(tsince));
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_FindPosition_meo);
+
+static void BM_FindPosition_molniya(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(molniya_tle1, molniya_tle2));
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sgp4.FindPosition(tsince));
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_FindPosition_molniya);
+
+static void BM_FindPositionJacobian_leo(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    csgp4::SGP4::StateJacobian jacobian;
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sgp4.FindPositionJacobian(tsince, jacobian));
+        benchmark::DoNotOptimize(jacobian);
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_FindPositionJacobian_leo);
+
+static void BM_FindPositionJacobian_geo(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(geo_tle1, geo_tle2));
+    csgp4::SGP4::StateJacobian jacobian;
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(sgp4.FindPositionJacobian(tsince, jacobian));
+        benchmark::DoNotOptimize(jacobian);
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_FindPositionJacobian_geo);
+
+static void BM_SGP4Stepper_near(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    csgp4::SGP4Stepper stepper(sgp4, 0.0, 1.0 / 60.0);
+    csgp4::Vector position;
+    csgp4::Vector velocity;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(stepper.Next(position, velocity));
+        benchmark::DoNotOptimize(position);
+    }
+}
+BENCHMARK(BM_SGP4Stepper_near);
+
+static void BM_ChebyshevEphemeris_near(benchmark::State& state)
+{
+    const csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    const csgp4::ChebyshevEphemeris ephemeris =
+        csgp4::ChebyshevEphemeris::Fit(sgp4, 0.0, 1440.0, 1.0e-3);
+    csgp4::Vector position;
+    csgp4::Vector velocity;
+    double tsince = 0.0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ephemeris.Evaluate(tsince, position, velocity));
+        benchmark::DoNotOptimize(position);
+        tsince = tsince < 1440.0 ? tsince + 1.0 : 0.0;
+    }
+}
+BENCHMARK(BM_ChebyshevEphemeris_near);
+
+static std::vector<csgp4::Tle> near_catalog(size_t n)
+{
+    return std::vector<csgp4::Tle>(n, csgp4::Tle(iss_tle1, iss_tle2));
+}
+
+static void BM_SGP4Batch_FindPositions(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const csgp4::SGP4Batch batch(near_catalog(n));
+    std::vector<double> tsince(n, 0.0);
+    std::vector<double> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    std::vector<csgp4::PropagationStatus> status(n);
+    for (auto _ : state) {
+        batch.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+            xdot.data(), ydot.data(), zdot.data(), status.data());
+        benchmark::ClobberMemory();
+        for (auto& t : tsince) {
+            t = t < 1440.0 ? t + 1.0 : 0.0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SGP4Batch_FindPositions)->Arg(1024);
+
+static void BM_SGP4Batch_FindPositionsOnly(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const csgp4::SGP4Batch batch(near_catalog(n));
+    std::vector<double> tsince(n, 0.0);
+    std::vector<double> x(n), y(n), z(n);
+    std::vector<csgp4::PropagationStatus> status(n);
+    for (auto _ : state) {
+        batch.FindPositions(tsince.data(), x.data(), y.data(), z.data(), status.data());
+        benchmark::ClobberMemory();
+        for (auto& t : tsince) {
+            t = t < 1440.0 ? t + 1.0 : 0.0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SGP4Batch_FindPositionsOnly)->Arg(1024);
+
+static void BM_SGP4BatchFloat_FindPositions(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const csgp4::SGP4BatchFloat batch(near_catalog(n));
+    std::vector<double> tsince(n, 0.0);
+    std::vector<float> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    std::vector<csgp4::PropagationStatus> status(n);
+    for (auto _ : state) {
+        batch.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+            xdot.data(), ydot.data(), zdot.data(), status.data());
+        benchmark::ClobberMemory();
+        for (auto& t : tsince) {
+            t = t < 1440.0 ? t + 1.0 : 0.0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SGP4BatchFloat_FindPositions)->Arg(1024);
+
+static void BM_SGP4BatchFloat_FindPositionsOnly(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    const csgp4::SGP4BatchFloat batch(near_catalog(n));
+    std::vector<double> tsince(n, 0.0);
+    std::vector<float> x(n), y(n), z(n);
+    std::vector<csgp4::PropagationStatus> status(n);
+    for (auto _ : state) {
+        batch.FindPositions(tsince.data(), x.data(), y.data(), z.data(), status.data());
+        benchmark::ClobberMemory();
+        for (auto& t : tsince) {
+            t = t < 1440.0 ? t + 1.0 : 0.0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SGP4BatchFloat_FindPositionsOnly)->Arg(1024);
+
+/*
+ * The Kepler solve on its own, one call per satellite against kLanes in
+ * lockstep, which is where the double batch gains over FindPosition()
+ */
+struct KeplerInputs
+{
+    explicit KeplerInputs(size_t n)
+        : capu(n), axn(n), ayn(n), elsq(n),
+          sinepw(n), cosepw(n), ecose(n), esine(n)
+    {
+        for (size_t i = 0; i < n; i++) {
+            capu[i] = -6.0 + 12.0 * static_cast<double>(i) / static_cast<double>(n);
+            axn[i] = 0.1 * static_cast<double>(i % 7) / 7.0;
+            ayn[i] = 0.1 * static_cast<double>(i % 5) / 5.0;
+            elsq[i] = axn[i] * axn[i] + ayn[i] * ayn[i];
+        }
+    }
+    std::vector<double> capu, axn, ayn, elsq;
+    std::vector<double> sinepw, cosepw, ecose, esine;
+};
+
+static void BM_Kepler_Solve(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    KeplerInputs k(n);
+    for (auto _ : state) {
+        for (size_t i = 0; i < n; i++) {
+            csgp4::Kepler::Solve(k.capu[i], k.axn[i], k.ayn[i], k.elsq[i],
+                k.sinepw[i], k.cosepw[i], k.ecose[i], k.esine[i]);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Kepler_Solve)->Arg(1024);
+
+static void BM_Kepler_SolveLanes(benchmark::State& state)
+{
+    const size_t n = static_cast<size_t>(state.range(0));
+    KeplerInputs k(n);
+    for (auto _ : state) {
+        csgp4::Kepler::SolveLanes(n, k.capu.data(), k.axn.data(), k.ayn.data(),
+            k.elsq.data(), k.sinepw.data(), k.cosepw.data(), k.ecose.data(),
+            k.esine.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Kepler_SolveLanes)->Arg(1024);
+
+static void BM_CatalogPropagator_Propagate(benchmark::State& state)
+{
+    const std::vector<csgp4::Tle> tles = near_catalog(1024);
+    const std::vector<csgp4::SGP4> models(tles.begin(), tles.end());
+    const csgp4::CatalogPropagator propagator(static_cast<unsigned int>(state.range(0)));
+    const size_t steps = 60;
+    const size_t n = models.size() * steps;
+    std::vector<double> tsince(steps);
+    for (size_t k = 0; k < steps; k++) {
+        tsince[k] = static_cast<double>(k);
+    }
+    std::vector<double> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    std::vector<csgp4::PropagationStatus> status(n);
+    for (auto _ : state) {
+        propagator.Propagate(models, tsince.data(), steps, x.data(), y.data(), z.data(),
+            xdot.data(), ydot.data(), zdot.data(), status.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_CatalogPropagator_Propagate)->Arg(1)->Arg(4)->UseRealTime();
@@ -0,0 +1,382 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "csgp4/Tle.h"
+#include "csgp4/TleCatalog.h"
+#include "csgp4/OmmCsvReader.h"
+#include "csgp4/OmmJsonReader.h"
+#include "csgp4/OmmKvnReader.h"
+#include "csgp4/OmmXmlReader.h"
+#include "csgp4/OrbitalElements.h"
+#include "csgp4/SGP4.h"
+#include "csgp4/SGP4Snapshot.h"
+
+#include "common.h"
+
+// every allocation in the benchmark program is counted, so a benchmark
+// can report its allocations per item. The replacements are kept out of
+// line; once inlined, GCC pairs the malloc in one with the free in the
+// other and warns -Wmismatched-new-delete
+
+static std::atomic<size_t> allocations(0);
+
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    void* p = std::malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
+static void BM_Tle_construct(benchmark::State& state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(csgp4::Tle(iss_tle1, iss_tle2));
+    }
+}
+BENCHMARK(BM_Tle_construct);
+
+// decoding into an existing Tle, which should not allocate at all
+
+static void BM_Tle_SetLines(benchmark::State& state)
+{
+    csgp4::Tle tle(iss_tle1, iss_tle2);
+    const size_t before = allocations.load();
+    for (auto _ : state) {
+        tle.SetLines(iss_tle1, iss_tle2);
+        benchmark::ClobberMemory();
+    }
+    state.counters["allocs_per_record"] = benchmark::Counter(
+        static_cast<double>(allocations.load() - before) / static_cast<double>(state.iterations()));
+}
+BENCHMARK(BM_Tle_SetLines);
+
+// a 3LE text of 100000 records, parsed with 1 and 4 threads
+
+static void BM_TleCatalog_Parse(benchmark::State& state)
+{
+    const std::vector<const std::string*> lines = {
+        &iss_tle1, &iss_tle2, &gps_tle1, &gps_tle2,
+        &geo_tle1, &geo_tle2, &molniya_tle1, &molniya_tle2
+    };
+    const size_t records = 100000;
+    std::string text;
+    for (size_t n = 0; n < records; n++) {
+        text += "0 SATELLITE\n";
+        text += *lines[2 * (n % 4)] + "\n" + *lines[2 * (n % 4) + 1] + "\n";
+    }
+    const unsigned int threads = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(csgp4::TleCatalog::Parse(text.data(), text.size(), threads));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records));
+}
+BENCHMARK(BM_TleCatalog_Parse)->Arg(1)->Arg(4)->UseRealTime();
+
+// 100000 records of Celestrak GP JSON, fed in 64 KiB pieces as a file
+// would be read
+
+static void BM_OmmJsonReader_Feed(benchmark::State& state)
+{
+    const std::string record =
+        "{\n"
+        "    \"OBJECT_NAME\": \"ISS (ZARYA)\",\n"
+        "    \"OBJECT_ID\": \"1998-067A\",\n"
+        "    \"EPOCH\": \"2022-11-10T12:05:22.994304\",\n"
+        "    \"MEAN_MOTION\": 15.49917581,\n"
+        "    \"ECCENTRICITY\": 0.0006814,\n"
+        "    \"INCLINATION\": 51.6436,\n"
+        "    \"RA_OF_ASC_NODE\": 331.7596,\n"
+        "    \"ARG_OF_PERICENTER\": 57.2751,\n"
+        "    \"MEAN_ANOMALY\": 98.3376,\n"
+        "    \"EPHEMERIS_TYPE\": 0,\n"
+        "    \"CLASSIFICATION_TYPE\": \"U\",\n"
+        "    \"NORAD_CAT_ID\": 25544,\n"
+        "    \"ELEMENT_SET_NO\": 999,\n"
+        "    \"REV_AT_EPOCH\": 36787,\n"
+        "    \"BSTAR\": 0.000263,\n"
+        "    \"MEAN_MOTION_DOT\": 0.00014546,\n"
+        "    \"MEAN_MOTION_DDOT\": 0\n"
+        "}";
+    const size_t records = 100000;
+    std::string text = "[";
+    for (size_t n = 0; n < records; n++) {
+        text += n ? "," : "";
+        text += record;
+    }
+    text += "]";
+
+    const size_t piece = 64 * 1024;
+    for (auto _ : state) {
+        size_t read = 0;
+        csgp4::OmmJsonReader reader(
+            [&read](const csgp4::Tle&) { read++; },
+            [](const csgp4::TleCatalog::Error&) {});
+        for (size_t pos = 0; pos < text.size(); pos += piece) {
+            reader.Feed(text.data() + pos, std::min(piece, text.size() - pos));
+        }
+        reader.Finish();
+        benchmark::DoNotOptimize(read);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_OmmJsonReader_Feed);
+
+// the same 100000 records as Celestrak GP CSV, KVN and XML
+
+static const size_t omm_records = 100000;
+
+static const std::string omm_csv_row =
+    "ISS (ZARYA),1998-067A,2022-11-10T12:05:22.994304,15.49917581,.0006814,51.6436,331.7596,"
+    "57.2751,98.3376,0,U,25544,999,36787,.263E-3,.14546E-3,0\r\n";
+
+static std::string OmmCsvText()
+{
+    std::string text =
+        "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,"
+        "ARG_OF_PERICENTER,MEAN_ANOMALY,EPHEMERIS_TYPE,CLASSIFICATION_TYPE,NORAD_CAT_ID,"
+        "ELEMENT_SET_NO,REV_AT_EPOCH,BSTAR,MEAN_MOTION_DOT,MEAN_MOTION_DDOT\r\n";
+    for (size_t n = 0; n < omm_records; n++) {
+        text += omm_csv_row;
+    }
+    return text;
+}
+
+template <typename Reader>
+static void FeedOmm(benchmark::State& state, const std::string& text)
+{
+    const size_t piece = 64 * 1024;
+    for (auto _ : state) {
+        size_t read = 0;
+        Reader reader(
+            [&read](const csgp4::Tle&) { read++; },
+            [](const csgp4::TleCatalog::Error&) {});
+        for (size_t pos = 0; pos < text.size(); pos += piece) {
+            reader.Feed(text.data() + pos, std::min(piece, text.size() - pos));
+        }
+        reader.Finish();
+        benchmark::DoNotOptimize(read);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(omm_records));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+static void BM_OmmCsvReader_Feed(benchmark::State& state)
+{
+    FeedOmm<csgp4::OmmCsvReader>(state, OmmCsvText());
+}
+BENCHMARK(BM_OmmCsvReader_Feed);
+
+// the CSV in memory, read in chunks with 1 and 4 threads
+
+static void BM_TleCatalog_ParseOmmCsv(benchmark::State& state)
+{
+    const std::string text = OmmCsvText();
+    const unsigned int threads = static_cast<unsigned int>(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(csgp4::TleCatalog::ParseOmmCsv(text.data(), text.size(), threads));
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(omm_records));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+BENCHMARK(BM_TleCatalog_ParseOmmCsv)->Arg(1)->Arg(4)->UseRealTime();
+
+static void BM_OmmKvnReader_Feed(benchmark::State& state)
+{
+    const std::string record =
+        "CCSDS_OMM_VERS = 2.0\n"
+        "CREATION_DATE = 2022-11-10T18:00:00\n"
+        "ORIGINATOR = 18 SPCS\n"
+        "OBJECT_NAME = ISS (ZARYA)\n"
+        "OBJECT_ID = 1998-067A\n"
+        "CENTER_NAME = EARTH\n"
+        "REF_FRAME = TEME\n"
+        "TIME_SYSTEM = UTC\n"
+        "MEAN_ELEMENT_THEORY = SGP4\n"
+        "EPOCH = 2022-11-10T12:05:22.994304\n"
+        "MEAN_MOTION = 15.49917581 [rev/day]\n"
+        "ECCENTRICITY = .00068140\n"
+        "INCLINATION = 51.6436 [deg]\n"
+        "RA_OF_ASC_NODE = 331.7596 [deg]\n"
+        "ARG_OF_PERICENTER = 57.2751 [deg]\n"
+        "MEAN_ANOMALY = 98.3376 [deg]\n"
+        "EPHEMERIS_TYPE = 0\n"
+        "CLASSIFICATION_TYPE = U\n"
+        "NORAD_CAT_ID = 25544\n"
+        "ELEMENT_SET_NO = 999\n"
+        "REV_AT_EPOCH = 36787\n"
+        "BSTAR = .26300000E-3 [1/ER]\n"
+        "MEAN_MOTION_DOT = .14546000E-3 [rev/day**2]\n"
+        "MEAN_MOTION_DDOT = 0.0 [rev/day**3]\n";
+    std::string text;
+    for (size_t n = 0; n < omm_records; n++) {
+        text += record;
+    }
+    FeedOmm<csgp4::OmmKvnReader>(state, text);
+}
+BENCHMARK(BM_OmmKvnReader_Feed);
+
+static void BM_OmmXmlReader_Feed(benchmark::State& state)
+{
+    const std::string record =
+        "<omm id=\"CCSDS_OMM_VERS\" version=\"2.0\"><header><CREATION_DATE/><ORIGINATOR/></header>"
+        "<body><segment><metadata><OBJECT_NAME>ISS (ZARYA)</OBJECT_NAME><OBJECT_ID>1998-067A</OBJECT_ID>"
+        "<CENTER_NAME>EARTH</CENTER_NAME><REF_FRAME>TEME</REF_FRAME><TIME_SYSTEM>UTC</TIME_SYSTEM>"
+        "<MEAN_ELEMENT_THEORY>SGP4</MEAN_ELEMENT_THEORY></metadata><data><meanElements>"
+        "<EPOCH>2022-11-10T12:05:22.994304</EPOCH><MEAN_MOTION>15.49917581</MEAN_MOTION>"
+        "<ECCENTRICITY>.0006814</ECCENTRICITY><INCLINATION>51.6436</INCLINATION>"
+        "<RA_OF_ASC_NODE>331.7596</RA_OF_ASC_NODE><ARG_OF_PERICENTER>57.2751</ARG_OF_PERICENTER>"
+        "<MEAN_ANOMALY>98.3376</MEAN_ANOMALY></meanElements><tleParameters>"
+        "<EPHEMERIS_TYPE>0</EPHEMERIS_TYPE><CLASSIFICATION_TYPE>U</CLASSIFICATION_TYPE>"
+        "<NORAD_CAT_ID>25544</NORAD_CAT_ID><ELEMENT_SET_NO>999</ELEMENT_SET_NO>"
+        "<REV_AT_EPOCH>36787</REV_AT_EPOCH><BSTAR>.263E-3</BSTAR><MEAN_MOTION_DOT>.14546E-3</MEAN_MOTION_DOT>"
+        "<MEAN_MOTION_DDOT>0</MEAN_MOTION_DDOT></tleParameters></data></segment></body></omm>\n";
+    std::string text = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<ndm>\n";
+    for (size_t n = 0; n < omm_records; n++) {
+        text += record;
+    }
+    text += "</ndm>\n";
+    FeedOmm<csgp4::OmmXmlReader>(state, text);
+}
+BENCHMARK(BM_OmmXmlReader_Feed);
+
+static void BM_OrbitalElements_construct(benchmark::State& state)
+{
+    const csgp4::Tle tle(iss_tle1, iss_tle2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(csgp4::OrbitalElements(tle));
+    }
+}
+BENCHMARK(BM_OrbitalElements_construct);
+
+// SGP4::Initialise is private; SetTle runs it on an existing object
+// without the allocation of a new one
+
+static void BM_SGP4_Initialise_near(benchmark::State& state)
+{
+    const csgp4::Tle tle(iss_tle1, iss_tle2);
+    csgp4::SGP4 sgp4(tle);
+    for (auto _ : state) {
+        sgp4.SetTle(tle);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_SGP4_Initialise_near);
+
+static void BM_SGP4_Initialise_deep(benchmark::State& state)
+{
+    const csgp4::Tle tle(molniya_tle1, molniya_tle2);
+    csgp4::SGP4 sgp4(tle);
+    for (auto _ : state) {
+        sgp4.SetTle(tle);
+        benchmark::ClobberMemory();
+    }
+}
+BENCHMARK(BM_SGP4_Initialise_deep);
+
+static void BM_SGP4_construct(benchmark::State& state)
+{
+    const csgp4::Tle tle(iss_tle1, iss_tle2);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(csgp4::SGP4(tle));
+    }
+}
+BENCHMARK(BM_SGP4_construct);
+
+// the start up of a process propagating 100000 satellites, from 3LE text
+// and from a snapshot of the initialised propagators
+
+static std::string StartupText(size_t records)
+{
+    const std::vector<const std::string*> lines = {
+        &iss_tle1, &iss_tle2, &gps_tle1, &gps_tle2,
+        &geo_tle1, &geo_tle2, &molniya_tle1, &molniya_tle2
+    };
+    std::string text;
+    for (size_t n = 0; n < records; n++) {
+        text += *lines[2 * (n % 4)] + "\n" + *lines[2 * (n % 4) + 1] + "\n";
+    }
+    return text;
+}
+
+static void BM_Startup_tle(benchmark::State& state)
+{
+    const size_t records = 100000;
+    const std::string text = StartupText(records);
+    for (auto _ : state) {
+        const csgp4::TleCatalog catalog = csgp4::TleCatalog::Parse(text.data(), text.size(), 1);
+        std::vector<csgp4::SGP4> models;
+        models.reserve(catalog.Size());
+        for (const csgp4::Tle& tle : catalog.Tles()) {
+            models.emplace_back(tle);
+        }
+        benchmark::DoNotOptimize(models.data());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records));
+}
+BENCHMARK(BM_Startup_tle)->Unit(benchmark::kMillisecond);
+
+static void BM_Startup_snapshot(benchmark::State& state)
+{
+    const size_t records = 100000;
+    const std::string text = StartupText(records);
+    const csgp4::TleCatalog catalog = csgp4::TleCatalog::Parse(text.data(), text.size(), 1);
+    std::vector<csgp4::SGP4> models;
+    std::vector<unsigned int> norad_numbers;
+    for (const csgp4::Tle& tle : catalog.Tles()) {
+        models.emplace_back(tle);
+        norad_numbers.push_back(tle.NoradNumber());
+    }
+    const std::string path = "csgp4_bench_snapshot.bin";
+    csgp4::SGP4Snapshot::Save(path, models, norad_numbers);
+
+    for (auto _ : state) {
+        const csgp4::SGP4Snapshot snapshot = csgp4::SGP4Snapshot::Load(path);
+        const std::vector<csgp4::SGP4> restored = snapshot.Models();
+        benchmark::DoNotOptimize(restored.data());
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(records));
+}
+BENCHMARK(BM_Startup_snapshot)->Unit(benchmark::kMillisecond);
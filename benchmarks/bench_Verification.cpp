@@ -0,0 +1,62 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "csgp4/SGP4.h"
+
+#include "sgp4_ver.h"
+
+// Throughput over the SGP4-VER grids of one orbit regime, reported as
+// positions per second
+
+static void BM_Verification(benchmark::State& state, Regime regime)
+{
+    std::vector<csgp4::SGP4> models;
+    std::vector<std::vector<double>> grids;
+    int64_t positions = 0;
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        if (kVerificationCases[i].regime == regime) {
+            models.emplace_back(VerificationTle(kVerificationCases[i]));
+            grids.push_back(VerificationGrid(kVerificationCases[i]));
+            positions += static_cast<int64_t>(grids.back().size());
+        }
+    }
+
+    csgp4::Vector position;
+    csgp4::Vector velocity;
+    for (auto _ : state) {
+        for (size_t i = 0; i < models.size(); i++) {
+            csgp4::SGP4::IntegratorParams integ;
+            for (double t : grids[i]) {
+                benchmark::DoNotOptimize(models[i].TryFindPosition(t, integ, position, velocity));
+            }
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * positions);
+}
+BENCHMARK_CAPTURE(BM_Verification, near_space, REGIME_NEAR_SPACE);
+BENCHMARK_CAPTURE(BM_Verification, deep_space, REGIME_DEEP_SPACE);
+BENCHMARK_CAPTURE(BM_Verification, resonant_12h, REGIME_RESONANT_12H);
+BENCHMARK_CAPTURE(BM_Verification, synchronous_24h, REGIME_SYNCHRONOUS_24H);
@@ -0,0 +1,39 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <string>
+
+// One element set per orbit class; the deep space ones cover each branch
+// of SDP4: no resonance, 12 hour resonance and 24 hour synchronous
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string gps_tle1("1 24876U 97035A   06176.56480213  .00000023  00000-0  10000-3 0  3320");
+static std::string gps_tle2("2 24876  55.6071 146.5633 0038512  83.7398 276.7389  2.00563720 65477");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+static std::string molniya_tle1("1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813");
+static std::string molniya_tle2("2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+
+static const double obs_lat = 51.0;
+static const double obs_lon = -3.0;
+static const double obs_hgt = 10.0;
@@ -0,0 +1,341 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csgp4/CatalogPropagator.h"
+
+#include "csgp4/Vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace
+{
+    /*
+     * relative cost of a grid time against a near space satellite, as
+     * measured over a week of one minute steps
+     */
+    const double kDeepSpaceCost = 1.3;
+    const double kResonantCost = 1.8;
+
+    /*
+     * task indices are packed two to a 64 bit word
+     */
+    const size_t kMaxTasks = 0x7fffffff;
+
+    struct Task
+    {
+        size_t satellite;
+        size_t first;
+        size_t count;
+    };
+
+    /*
+     * the tasks [begin, end) still to be run by one worker, packed as
+     * end << 32 | begin so that the owner taking from the front and
+     * thieves taking from the back agree through a single word
+     */
+    struct alignas(64) TaskRange
+    {
+        std::atomic<uint64_t> bounds;
+    };
+
+    inline uint64_t Pack(const uint64_t begin, const uint64_t end)
+    {
+        return end << 32 | begin;
+    }
+
+    inline bool TakeFront(TaskRange& range, size_t& task)
+    {
+        uint64_t bounds = range.bounds.load();
+
+        for (;;)
+        {
+            const uint64_t begin = bounds & 0xffffffff;
+            const uint64_t end = bounds >> 32;
+
+            if (begin >= end)
+            {
+                return false;
+            }
+
+            if (range.bounds.compare_exchange_weak(bounds, Pack(begin + 1, end)))
+            {
+                task = static_cast<size_t>(begin);
+                return true;
+            }
+        }
+    }
+
+    /*
+     * move the back half of the busiest other worker to range self
+     */
+    inline bool Steal(TaskRange* ranges, const unsigned int workers,
+            const unsigned int self)
+    {
+        for (;;)
+        {
+            unsigned int victim = self;
+            uint64_t victim_bounds = 0;
+            uint64_t most = 0;
+
+            for (unsigned int w = 0; w < workers; w++)
+            {
+                const uint64_t bounds = ranges[w].bounds.load();
+                const uint64_t begin = bounds & 0xffffffff;
+                const uint64_t end = bounds >> 32;
+
+                if (w != self && end > begin && end - begin > most)
+                {
+                    victim = w;
+                    victim_bounds = bounds;
+                    most = end - begin;
+                }
+            }
+
+            if (most == 0)
+            {
+                return false;
+            }
+
+            const uint64_t begin = victim_bounds & 0xffffffff;
+            const uint64_t end = victim_bounds >> 32;
+            const uint64_t split = end - (most + 1) / 2;
+
+            if (ranges[victim].bounds.compare_exchange_strong(victim_bounds,
+                        Pack(begin, split)))
+            {
+                ranges[self].bounds.store(Pack(split, end));
+                return true;
+            }
+        }
+    }
+
+    inline void PinThread(const unsigned int cpu)
+    {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        /*
+         * a processor that is not available leaves the thread unpinned
+         */
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)cpu;
+#endif
+    }
+}
+
+namespace csgp4
+{
+
+const size_t CatalogPropagator::kBlockSteps;
+
+CatalogPropagator::CatalogPropagator(unsigned int threads)
+    : threads_(threads),
+      deep_space_cost_(kDeepSpaceCost),
+      resonant_cost_(kResonantCost)
+{
+    if (threads_ == 0)
+    {
+        threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+void CatalogPropagator::Propagate(const std::vector<SGP4>& models,
+                                  const double* tsince,
+                                  size_t steps,
+                                  double* x,
+                                  double* y,
+                                  double* z,
+                                  double* xdot,
+                                  double* ydot,
+                                  double* zdot,
+                                  PropagationStatus* status) const
+{
+    Run(models, tsince, nullptr, steps, x, y, z, xdot, ydot, zdot, status);
+}
+
+void CatalogPropagator::Propagate(const std::vector<SGP4>& models,
+                                  const DateTime* dates,
+                                  size_t steps,
+                                  double* x,
+                                  double* y,
+                                  double* z,
+                                  double* xdot,
+                                  double* ydot,
+                                  double* zdot,
+                                  PropagationStatus* status) const
+{
+    Run(models, nullptr, dates, steps, x, y, z, xdot, ydot, zdot, status);
+}
+
+double CatalogPropagator::Cost(const SGP4& model) const
+{
+    if (!model.use_deep_space_)
+    {
+        return 1.0;
+    }
+
+    if (model.deepspace_consts_->shape == SGP4::DeepSpaceConstants::NONE)
+    {
+        return deep_space_cost_;
+    }
+
+    return resonant_cost_;
+}
+
+void CatalogPropagator::Run(const std::vector<SGP4>& models,
+                            const double* tsince,
+                            const DateTime* dates,
+                            size_t steps,
+                            double* x,
+                            double* y,
+                            double* z,
+                            double* xdot,
+                            double* ydot,
+                            double* zdot,
+                            PropagationStatus* status) const
+{
+    if (models.empty() || steps == 0)
+    {
+        return;
+    }
+
+    /*
+     * cut the work into tasks, satellite by satellite, with blocks
+     * growing only if there would be too many to index
+     */
+    size_t block = kBlockSteps;
+    while (models.size() * ((steps + block - 1) / block) > kMaxTasks)
+    {
+        block *= 2;
+    }
+
+    std::vector<Task> tasks;
+    std::vector<double> cost;
+    tasks.reserve(models.size() * ((steps + block - 1) / block));
+    cost.reserve(tasks.capacity());
+    double total = 0.0;
+
+    for (size_t i = 0; i < models.size(); i++)
+    {
+        const double weight = Cost(models[i]);
+
+        for (size_t first = 0; first < steps; first += block)
+        {
+            const size_t count = std::min(block, steps - first);
+            tasks.push_back(Task{i, first, count});
+            cost.push_back(weight * static_cast<double>(count));
+            total += cost.back();
+        }
+    }
+
+    const unsigned int workers = static_cast<unsigned int>(
+            std::min<size_t>(threads_, tasks.size()));
+
+    /*
+     * give each worker a contiguous run of about equal cost
+     */
+    std::vector<TaskRange> ranges(workers);
+    size_t begin = 0;
+    double sum = 0.0;
+
+    for (unsigned int w = 0; w < workers; w++)
+    {
+        const double target = total * (w + 1) / workers;
+        size_t end = begin;
+
+        while (end < tasks.size() && (w + 1 == workers || sum + 0.5 * cost[end] < target))
+        {
+            sum += cost[end++];
+        }
+
+        ranges[w].bounds.store(Pack(begin, end));
+        begin = end;
+    }
+
+    auto run_task = [&](const Task& task)
+    {
+        const SGP4& model = models[task.satellite];
+        const DateTime epoch = model.elements_.Epoch();
+        SGP4::IntegratorParams integ;
+
+        for (size_t k = task.first; k < task.first + task.count; k++)
+        {
+            const double t = dates != nullptr
+                ? (dates[k] - epoch).TotalMinutes() : tsince[k];
+            const size_t slot = task.satellite * steps + k;
+            Vector position;
+            Vector velocity;
+
+            status[slot] = model.TryFindPosition(t, integ, position, velocity);
+            x[slot] = position.x;
+            y[slot] = position.y;
+            z[slot] = position.z;
+            xdot[slot] = velocity.x;
+            ydot[slot] = velocity.y;
+            zdot[slot] = velocity.z;
+        }
+    };
+
+    auto worker = [&](unsigned int self)
+    {
+        if (!cpus_.empty())
+        {
+            PinThread(cpus_[self % cpus_.size()]);
+        }
+
+        size_t task;
+
+        do
+        {
+            while (TakeFront(ranges[self], task))
+            {
+                run_task(tasks[task]);
+            }
+        }
+        while (Steal(ranges.data(), workers, self));
+    };
+
+    /*
+     * the calling thread is worker 0, unless the workers are pinned, when
+     * it only waits so that its own affinity is left alone
+     */
+    const unsigned int first = cpus_.empty() ? 1 : 0;
+    std::vector<std::thread> pool;
+    for (unsigned int w = first; w < workers; w++)
+    {
+        pool.emplace_back(worker, w);
+    }
+    if (first == 1)
+    {
+        worker(0);
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+}
+
+}; // end namespace csgp4
@@ -0,0 +1,311 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csgp4/ChebyshevEphemeris.h"
+
+#include "csgp4/Globals.h"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+
+namespace
+{
+    /*
+     * x, y, z, xdot, ydot, zdot
+     */
+    const size_t kComponents = 6;
+
+    /*
+     * segments are never shorter than an orbit / 2^kMaxHalvings in Fit()
+     */
+    const int kMaxHalvings = 6;
+
+    /*
+     * sum of c[j] * T_j(x) for j < n
+     */
+    inline double Clenshaw(const double* c, const size_t n, const double x)
+    {
+        const double x2 = 2.0 * x;
+        double b1 = 0.0;
+        double b2 = 0.0;
+
+        for (size_t j = n - 1; j > 0; j--)
+        {
+            const double b0 = x2 * b1 - b2 + c[j];
+            b2 = b1;
+            b1 = b0;
+        }
+
+        return x * b1 - b2 + c[0];
+    }
+}
+
+namespace csgp4
+{
+
+const unsigned int ChebyshevEphemeris::kDefaultDegree;
+
+ChebyshevEphemeris::ChebyshevEphemeris(const SGP4& sgp4,
+                                       double start,
+                                       double end,
+                                       double segment,
+                                       unsigned int degree)
+    : epoch_(sgp4.elements_.Epoch()),
+      start_(start),
+      segment_(0.0),
+      segments_(0),
+      degree_(degree),
+      max_position_error_(0.0),
+      max_velocity_error_(0.0)
+{
+    if (!(end > start) || !(segment > 0.0))
+    {
+        throw std::invalid_argument("Error: ephemeris span is empty");
+    }
+
+    if (degree == 0)
+    {
+        throw std::invalid_argument("Error: ephemeris degree must be at least one");
+    }
+
+    /*
+     * a whole number of segments, allowing for rounding in the division
+     */
+    const double count = ceil((end - start) / segment - 1.0e-9);
+    segments_ = std::max(static_cast<size_t>(count), static_cast<size_t>(1));
+    segment_ = (end - start) / static_cast<double>(segments_);
+
+    coefficients_.resize(segments_ * kComponents * (degree_ + 1));
+    position_errors_.resize(segments_);
+
+    SGP4::IntegratorParams integ;
+
+    for (size_t i = 0; i < segments_; i++)
+    {
+        FitSegment(sgp4, i, integ);
+    }
+}
+
+ChebyshevEphemeris ChebyshevEphemeris::Fit(const SGP4& sgp4,
+                                           double start,
+                                           double end,
+                                           double tolerance,
+                                           unsigned int degree)
+{
+    const double period = kTWOPI / sgp4.elements_.RecoveredMeanMotion();
+
+    ChebyshevEphemeris best(sgp4, start, end, period, degree);
+
+    for (int i = 1; i <= kMaxHalvings
+            && best.MaxPositionError() > tolerance; i++)
+    {
+        ChebyshevEphemeris fit(sgp4, start, end, period / (1 << i), degree);
+
+        if (fit.MaxPositionError() < best.MaxPositionError())
+        {
+            best = std::move(fit);
+        }
+    }
+
+    return best;
+}
+
+size_t ChebyshevEphemeris::MemoryUsage() const
+{
+    return sizeof(*this)
+        + coefficients_.capacity() * sizeof(double)
+        + position_errors_.capacity() * sizeof(double);
+}
+
+Eci ChebyshevEphemeris::FindPosition(const DateTime& date) const
+{
+    return FindPosition((date - epoch_).TotalMinutes());
+}
+
+Eci ChebyshevEphemeris::FindPosition(double tsince) const
+{
+    Vector position;
+    Vector velocity;
+
+    if (!Evaluate(tsince, position, velocity))
+    {
+        throw std::out_of_range("Error: time is outside the ephemeris");
+    }
+
+    return Eci(epoch_.AddMinutes(tsince), position, velocity);
+}
+
+bool ChebyshevEphemeris::Evaluate(double tsince,
+                                  Vector& position,
+                                  Vector& velocity) const noexcept
+{
+    double x;
+    const double* c = Locate(tsince, x);
+
+    if (c == nullptr)
+    {
+        return false;
+    }
+
+    const size_t n = degree_ + 1;
+
+    position.x = Clenshaw(c, n, x);
+    position.y = Clenshaw(c + n, n, x);
+    position.z = Clenshaw(c + 2 * n, n, x);
+    position.w = 0.0;
+    velocity.x = Clenshaw(c + 3 * n, n, x);
+    velocity.y = Clenshaw(c + 4 * n, n, x);
+    velocity.z = Clenshaw(c + 5 * n, n, x);
+    velocity.w = 0.0;
+
+    return true;
+}
+
+bool ChebyshevEphemeris::Evaluate(double tsince,
+                                  Vector& position) const noexcept
+{
+    double x;
+    const double* c = Locate(tsince, x);
+
+    if (c == nullptr)
+    {
+        return false;
+    }
+
+    const size_t n = degree_ + 1;
+
+    position.x = Clenshaw(c, n, x);
+    position.y = Clenshaw(c + n, n, x);
+    position.z = Clenshaw(c + 2 * n, n, x);
+    position.w = 0.0;
+
+    return true;
+}
+
+const double* ChebyshevEphemeris::Locate(double tsince,
+                                         double& x) const noexcept
+{
+    if (!Contains(tsince))
+    {
+        return nullptr;
+    }
+
+    /*
+     * the end of the span belongs to the last segment
+     */
+    const double u = (tsince - start_) / segment_;
+    const size_t i = std::min(static_cast<size_t>(u), segments_ - 1);
+
+    x = 2.0 * (u - static_cast<double>(i)) - 1.0;
+
+    return &coefficients_[i * kComponents * (degree_ + 1)];
+}
+
+void ChebyshevEphemeris::FitSegment(const SGP4& sgp4,
+                                    size_t segment,
+                                    SGP4::IntegratorParams& integ)
+{
+    const size_t n = degree_ + 1;
+    const double half = 0.5 * segment_;
+    const double mid = start_ + segment_ * static_cast<double>(segment) + half;
+    double* c = &coefficients_[segment * kComponents * n];
+
+    std::fill(c, c + kComponents * n, 0.0);
+
+    /*
+     * sample at the roots of T_n in time order and project onto each
+     * T_j, which is exact by the discrete orthogonality of the roots
+     */
+    for (size_t k = 0; k < n; k++)
+    {
+        const double xk = -cos(kPI * (static_cast<double>(k) + 0.5)
+                / static_cast<double>(n));
+        const Eci eci = sgp4.FindPosition(mid + half * xk, integ);
+        const double f[kComponents] = {
+            eci.Position().x, eci.Position().y, eci.Position().z,
+            eci.Velocity().x, eci.Velocity().y, eci.Velocity().z
+        };
+
+        /*
+         * T_j(xk) by the three term recurrence
+         */
+        double tprev = 1.0;
+        double tj = 1.0;
+
+        for (size_t j = 0; j < n; j++)
+        {
+            for (size_t m = 0; m < kComponents; m++)
+            {
+                c[m * n + j] += f[m] * tj;
+            }
+
+            const double next = j == 0 ? xk : 2.0 * xk * tj - tprev;
+            tprev = tj;
+            tj = next;
+        }
+    }
+
+    for (size_t m = 0; m < kComponents; m++)
+    {
+        for (size_t j = 0; j < n; j++)
+        {
+            c[m * n + j] *= (j == 0 ? 1.0 : 2.0) / static_cast<double>(n);
+        }
+    }
+
+    /*
+     * check the ends and half way between neighbouring nodes
+     */
+    double position_error = 0.0;
+
+    for (size_t k = 0; k <= n; k++)
+    {
+        double xk;
+
+        if (k == 0)
+        {
+            xk = -1.0;
+        }
+        else if (k == n)
+        {
+            xk = 1.0;
+        }
+        else
+        {
+            xk = -0.5 * (cos(kPI * (static_cast<double>(k) - 0.5)
+                        / static_cast<double>(n))
+                    + cos(kPI * (static_cast<double>(k) + 0.5)
+                        / static_cast<double>(n)));
+        }
+
+        const Eci eci = sgp4.FindPosition(mid + half * xk, integ);
+        const Vector dp(Clenshaw(c, n, xk) - eci.Position().x,
+                        Clenshaw(c + n, n, xk) - eci.Position().y,
+                        Clenshaw(c + 2 * n, n, xk) - eci.Position().z);
+        const Vector dv(Clenshaw(c + 3 * n, n, xk) - eci.Velocity().x,
+                        Clenshaw(c + 4 * n, n, xk) - eci.Velocity().y,
+                        Clenshaw(c + 5 * n, n, xk) - eci.Velocity().z);
+
+        position_error = std::max(position_error, dp.Magnitude());
+        max_velocity_error_ = std::max(max_velocity_error_, dv.Magnitude());
+    }
+
+    position_errors_[segment] = position_error;
+    max_position_error_ = std::max(max_position_error_, position_error);
+}
+
+}; // end namespace csgp4
@@ -17,3 +17,20 @@
 
 
 #include "csgp4/DecayedException.h"
+#include "csgp4/Stats.h"
+
+namespace csgp4
+{
+
+DecayedException::DecayedException(const DateTime& dt,
+                                   const Vector& pos,
+                                   const Vector& vel)
+    : runtime_error("Satellite decayed")
+    , _dt(dt)
+    , _pos(pos)
+    , _vel(vel)
+{
+    CSGP4_STATS_INC(DECAYED_EXCEPTIONS);
+}
+
+}; // end namespace csgp4
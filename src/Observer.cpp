@@ -16,10 +16,24 @@
 
 #include "csgp4/Observer.h"
 #include "csgp4/CoordTopocentric.h"
+#include "csgp4/Stats.h"
 
 namespace csgp4
 {
 
+void Observer::Update(const DateTime &dt)
+{
+    if (m_eci != dt)
+    {
+        CSGP4_STATS_INC(OBSERVER_CACHE_MISSES);
+        m_eci.Update(dt, m_geo);
+    }
+    else
+    {
+        CSGP4_STATS_INC(OBSERVER_CACHE_HITS);
+    }
+}
+
 /*
  * calculate lookangle between the observer and the passed in Eci object
  */
@@ -0,0 +1,337 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "csgp4/OmmCsvReader.h"
+#include "csgp4/Simd.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace
+{
+    /*
+     * blocks classified at a time
+     */
+    static const size_t kRun = 16;
+
+    /*
+     * bit i of masks[b] is set when byte i of block b is a comma, quote or
+     * line end. The flags are worked out a byte per lane, then packed 8 to
+     * a word with a multiply that moves byte j to bit 56 + j.
+     */
+    CSGP4_SIMD_CLONES
+    void DelimiterMasks(const char* data, size_t blocks, uint64_t* masks)
+    {
+        for (size_t b = 0; b < blocks; b++)
+        {
+            const unsigned char* block = reinterpret_cast<const unsigned char*>(data + 64 * b);
+            unsigned char flags[64];
+
+            CSGP4_PRAGMA_SIMD
+            for (int i = 0; i < 64; i++)
+            {
+                const unsigned char c = block[i];
+                flags[i] = static_cast<unsigned char>(c == ',' ? 1 : c == '"' ? 1 : c == '\n' ? 1 : 0);
+            }
+
+            uint64_t mask = 0;
+            for (int k = 0; k < 8; k++)
+            {
+                uint64_t word;
+                memcpy(&word, flags + 8 * k, 8);
+                mask |= ((word * 0x0102040810204080ull) >> 56) << (8 * k);
+            }
+            masks[b] = mask;
+        }
+    }
+
+    int LowestBit(uint64_t mask)
+    {
+#if defined(__GNUC__)
+        return __builtin_ctzll(mask);
+#else
+        int bit = 0;
+        while (!(mask & 1))
+        {
+            mask >>= 1;
+            bit++;
+        }
+        return bit;
+#endif
+    }
+
+    /**
+     * @brief Finds the commas, quotes and line ends of a piece of text
+     */
+    class Delimiters
+    {
+    public:
+        Delimiters(const char* data, size_t size)
+            : data_(data)
+            , size_(size)
+        {
+        }
+
+        /**
+         * @returns the first delimiter at or after pos, or the size
+         */
+        size_t Next(size_t pos)
+        {
+            while (pos < size_)
+            {
+                const size_t block = pos / 64;
+                if (block < first_ || block >= first_ + count_)
+                {
+                    Fill(block);
+                }
+
+                const uint64_t mask = masks_[block - first_] & (~0ull << (pos % 64));
+                if (mask)
+                {
+                    return block * 64 + static_cast<size_t>(LowestBit(mask));
+                }
+                pos = (block + 1) * 64;
+            }
+            return size_;
+        }
+
+    private:
+        void Fill(size_t block)
+        {
+            const size_t full = size_ / 64;
+            first_ = block;
+            count_ = std::min(kRun, (size_ + 63) / 64 - block);
+
+            const size_t whole = block < full ? std::min(count_, full - block) : 0;
+            DelimiterMasks(data_ + block * 64, whole, masks_);
+
+            if (whole < count_)
+            {
+                /*
+                 * the last, short block is padded out
+                 */
+                char tail[64] = {};
+                memcpy(tail, data_ + full * 64, size_ - full * 64);
+                DelimiterMasks(tail, 1, masks_ + whole);
+            }
+        }
+
+        const char* data_;
+        size_t size_;
+        size_t first_{};
+        size_t count_{};
+        uint64_t masks_[kRun];
+    };
+}
+
+namespace csgp4
+{
+
+OmmCsvReader::OmmCsvReader(RecordHandler on_record, ErrorHandler on_error)
+    : on_record_(std::move(on_record))
+    , on_error_(std::move(on_error))
+{
+}
+
+void OmmCsvReader::Feed(const char* data, size_t size)
+{
+    /*
+     * finish a row left over from the last piece
+     */
+    if (!carry_.empty())
+    {
+        const void* nl = memchr(data, '\n', size);
+        if (nl == nullptr)
+        {
+            carry_.append(data, size);
+            return;
+        }
+
+        const size_t length = static_cast<size_t>(static_cast<const char*>(nl) - data) + 1;
+        carry_.append(data, length);
+        ReadRows(carry_.data(), carry_.size());
+        carry_.clear();
+        data += length;
+        size -= length;
+    }
+
+    const size_t used = ReadRows(data, size);
+    carry_.assign(data + used, size - used);
+}
+
+bool OmmCsvReader::Finish()
+{
+    if (!carry_.empty())
+    {
+        carry_ += '\n';
+        ReadRows(carry_.data(), carry_.size());
+        carry_.clear();
+    }
+    return header_;
+}
+
+void OmmCsvReader::ContinueFrom(const OmmCsvReader& other, size_t first_line)
+{
+    header_ = other.header_;
+    columns_ = other.columns_;
+    line_ = first_line;
+}
+
+/**
+ * Read the whole rows of a piece of text
+ * @returns the length of the rows read
+ */
+size_t OmmCsvReader::ReadRows(const char* data, size_t size)
+{
+    Delimiters delimiters(data, size);
+    size_t row = 0;
+    size_t pos = 0;
+    size_t column = 0;
+
+    while (pos < size)
+    {
+        if (column == 0 && header_)
+        {
+            record_.Begin(line_);
+        }
+
+        std::string_view value;
+        size_t end;
+
+        if (data[pos] == '"')
+        {
+            /*
+             * quoted, with "" for a quote, up to the line end
+             */
+            const void* nl = memchr(data + pos, '\n', size - pos);
+            if (nl == nullptr)
+            {
+                return row;
+            }
+            const size_t line_end = static_cast<size_t>(static_cast<const char*>(nl) - data);
+
+            size_t close = pos + 1;
+            bool doubled = false;
+            for (;;)
+            {
+                const void* quote = memchr(data + close, '"', line_end - close);
+                close = quote ? static_cast<size_t>(static_cast<const char*>(quote) - data) : line_end;
+                if (close + 1 < line_end && data[close + 1] == '"')
+                {
+                    doubled = true;
+                    close += 2;
+                    continue;
+                }
+                break;
+            }
+
+            value = std::string_view(data + pos + 1, close - pos - 1);
+            if (doubled)
+            {
+                unquoted_.clear();
+                for (size_t i = 0; i < value.size(); i++)
+                {
+                    unquoted_ += value[i];
+                    if (value[i] == '"')
+                    {
+                        i++;
+                    }
+                }
+                value = unquoted_;
+            }
+            if (close == line_end)
+            {
+                record_.Fail("Unterminated quote");
+                close--;
+            }
+
+            end = delimiters.Next(close + 1);
+            while (end < size && data[end] == '"')
+            {
+                end = delimiters.Next(end + 1);
+            }
+        }
+        else
+        {
+            end = delimiters.Next(pos);
+            while (end < size && data[end] == '"')
+            {
+                end = delimiters.Next(end + 1);
+            }
+            value = std::string_view(data + pos, end - pos);
+        }
+
+        if (end >= size)
+        {
+            return row;
+        }
+
+        const bool row_end = data[end] == '\n';
+        if (row_end && !value.empty() && value.back() == '\r')
+        {
+            value.remove_suffix(1);
+        }
+
+        /*
+         * blank lines are skipped
+         */
+        const bool blank = row_end && column == 0 && value.empty();
+        if (!blank)
+        {
+            ReadValue(column, value);
+        }
+        column++;
+        pos = end + 1;
+
+        if (row_end)
+        {
+            if (!header_)
+            {
+                header_ = !blank;
+            }
+            else if (!blank)
+            {
+                record_.End(on_record_, on_error_);
+            }
+            line_++;
+            row = pos;
+            column = 0;
+        }
+    }
+
+    return row;
+}
+
+void OmmCsvReader::ReadValue(size_t column, std::string_view value)
+{
+    if (!header_)
+    {
+        if (columns_.empty() && value.substr(0, 3) == "\xEF\xBB\xBF")
+        {
+            value.remove_prefix(3);
+        }
+        columns_.push_back(OmmRecord::FindField(value,
+                columns_.empty() ? OmmRecord::NONE : columns_.back()));
+    }
+    else if (column < columns_.size() && columns_[column] != OmmRecord::NONE && !value.empty())
+    {
+        record_.Set(columns_[column], value);
+    }
+}
+
+}; // end namespace csgp4
@@ -0,0 +1,429 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "csgp4/OmmJsonReader.h"
+
+namespace
+{
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+}
+
+namespace csgp4
+{
+
+OmmJsonReader::OmmJsonReader(RecordHandler on_record, ErrorHandler on_error)
+    : on_record_(std::move(on_record))
+    , on_error_(std::move(on_error))
+{
+}
+
+void OmmJsonReader::Feed(const char* data, size_t size)
+{
+    const char* p = data;
+    const char* end = data + size;
+    bool done = false;
+
+    while (p < end)
+    {
+        /*
+         * whitespace between tokens
+         */
+        if (state_ <= OBJECT_KEY || (state_ >= COLON && state_ <= VALUE) || state_ == NEXT)
+        {
+            while (p < end && IsSpace(*p))
+            {
+                if (*p == '\n')
+                {
+                    line_++;
+                }
+                p++;
+            }
+            if (p == end)
+            {
+                break;
+            }
+        }
+
+        const char c = *p;
+
+        switch (state_)
+        {
+        case DOCUMENT:
+            p++;
+            if (c == '{')
+            {
+                record_.Begin(line_);
+                last_field_ = OmmRecord::NONE;
+                state_ = OBJECT_KEY;
+            }
+            else if (c == '[' && !in_array_)
+            {
+                in_array_ = true;
+            }
+            else if (c == ']' && in_array_)
+            {
+                in_array_ = false;
+            }
+            else if (c != ',' || !in_array_)
+            {
+                SyntaxError(c);
+            }
+            break;
+
+        case OBJECT_KEY:
+            p++;
+            if (c == '"')
+            {
+                key_.clear();
+                state_ = KEY;
+            }
+            else if (c == '}')
+            {
+                state_ = DOCUMENT;
+                record_.End(on_record_, on_error_);
+            }
+            else
+            {
+                SyntaxError(c);
+            }
+            break;
+
+        case KEY:
+            p = ReadString(p, end, &key_, done);
+            if (done)
+            {
+                field_ = OmmRecord::FindField(key_, last_field_);
+                if (field_ != OmmRecord::NONE)
+                {
+                    last_field_ = field_;
+                }
+                state_ = COLON;
+            }
+            break;
+
+        case COLON:
+            p++;
+            if (c == ':')
+            {
+                state_ = VALUE;
+            }
+            else
+            {
+                SyntaxError(c);
+            }
+            break;
+
+        case VALUE:
+            value_.clear();
+            if (c == '"')
+            {
+                p++;
+                quoted_ = true;
+                state_ = STRING;
+            }
+            else if (c == '{' || c == '[')
+            {
+                p++;
+                if (field_ != OmmRecord::NONE)
+                {
+                    record_.Invalid(field_);
+                }
+                depth_ = 1;
+                in_string_ = false;
+                escape_ = false;
+                state_ = SKIP;
+            }
+            else if (c == '-' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z'))
+            {
+                quoted_ = false;
+                state_ = BARE;
+            }
+            else
+            {
+                p++;
+                SyntaxError(c);
+            }
+            break;
+
+        case STRING:
+            p = ReadString(p, end, field_ != OmmRecord::NONE ? &value_ : nullptr, done);
+            if (done)
+            {
+                SetField();
+                state_ = NEXT;
+            }
+            break;
+
+        case BARE:
+        {
+            const char* start = p;
+            while (p < end && *p != ',' && *p != '}' && *p != ']' && !IsSpace(*p))
+            {
+                p++;
+            }
+            if (field_ != OmmRecord::NONE)
+            {
+                value_.append(start, static_cast<size_t>(p - start));
+            }
+            if (p < end)
+            {
+                SetField();
+                state_ = NEXT;
+            }
+            break;
+        }
+
+        case NEXT:
+            p++;
+            if (c == ',')
+            {
+                state_ = OBJECT_KEY;
+            }
+            else if (c == '}')
+            {
+                state_ = DOCUMENT;
+                record_.End(on_record_, on_error_);
+            }
+            else
+            {
+                SyntaxError(c);
+            }
+            break;
+
+        case SKIP:
+            p++;
+            if (in_string_)
+            {
+                if (escape_)
+                {
+                    escape_ = false;
+                }
+                else if (c == '\\')
+                {
+                    escape_ = true;
+                }
+                else if (c == '"')
+                {
+                    in_string_ = false;
+                }
+            }
+            else if (c == '"')
+            {
+                in_string_ = true;
+            }
+            else if (c == '{' || c == '[')
+            {
+                depth_++;
+            }
+            else if (c == '}' || c == ']')
+            {
+                if (--depth_ == 0)
+                {
+                    state_ = NEXT;
+                }
+            }
+            else if (c == '\n')
+            {
+                line_++;
+            }
+            break;
+
+        case FAILED:
+            return;
+        }
+    }
+}
+
+bool OmmJsonReader::Finish()
+{
+    if (state_ == FAILED)
+    {
+        return false;
+    }
+    if (state_ != DOCUMENT || in_array_)
+    {
+        on_error_(TleCatalog::Error{ line_, "Unexpected end of JSON" });
+        state_ = FAILED;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read a string up to and including its closing quote, decoding escapes
+ * into out if it is not null. done is set once the closing quote is read.
+ */
+const char* OmmJsonReader::ReadString(const char* p, const char* end,
+                                      std::string* out, bool& done)
+{
+    done = false;
+
+    while (p < end)
+    {
+        const char c = *p;
+
+        if (unicode_ > 0)
+        {
+            p++;
+            uint32_t digit;
+            if (c >= '0' && c <= '9')
+            {
+                digit = static_cast<uint32_t>(c - '0');
+            }
+            else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+            {
+                digit = static_cast<uint32_t>((c | 0x20) - 'a' + 10);
+            }
+            else
+            {
+                SyntaxError(c);
+                return end;
+            }
+            code_point_ = code_point_ * 16 + digit;
+
+            if (--unicode_ == 0 && out)
+            {
+                /*
+                 * as utf-8, a surrogate pair giving two 3 byte sequences
+                 */
+                if (code_point_ < 0x80)
+                {
+                    out->push_back(static_cast<char>(code_point_));
+                }
+                else if (code_point_ < 0x800)
+                {
+                    out->push_back(static_cast<char>(0xc0 | (code_point_ >> 6)));
+                    out->push_back(static_cast<char>(0x80 | (code_point_ & 0x3f)));
+                }
+                else
+                {
+                    out->push_back(static_cast<char>(0xe0 | (code_point_ >> 12)));
+                    out->push_back(static_cast<char>(0x80 | ((code_point_ >> 6) & 0x3f)));
+                    out->push_back(static_cast<char>(0x80 | (code_point_ & 0x3f)));
+                }
+            }
+            continue;
+        }
+
+        if (escape_)
+        {
+            p++;
+            escape_ = false;
+
+            char decoded;
+            switch (c)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                decoded = c;
+                break;
+            case 'b':
+                decoded = '\b';
+                break;
+            case 'f':
+                decoded = '\f';
+                break;
+            case 'n':
+                decoded = '\n';
+                break;
+            case 'r':
+                decoded = '\r';
+                break;
+            case 't':
+                decoded = '\t';
+                break;
+            case 'u':
+                unicode_ = 4;
+                code_point_ = 0;
+                continue;
+            default:
+                SyntaxError(c);
+                return end;
+            }
+            if (out)
+            {
+                out->push_back(decoded);
+            }
+            continue;
+        }
+
+        /*
+         * the run of plain characters
+         */
+        const char* start = p;
+        while (p < end && *p != '"' && *p != '\\'
+                && static_cast<unsigned char>(*p) >= 0x20)
+        {
+            p++;
+        }
+        if (out)
+        {
+            out->append(start, static_cast<size_t>(p - start));
+        }
+
+        if (p == end)
+        {
+            break;
+        }
+        if (*p == '"')
+        {
+            done = true;
+            return p + 1;
+        }
+        if (*p == '\\')
+        {
+            escape_ = true;
+            p++;
+            continue;
+        }
+        SyntaxError(*p);
+        return end;
+    }
+
+    return p;
+}
+
+void OmmJsonReader::SetField()
+{
+    if (field_ != OmmRecord::NONE && (quoted_ || value_ != "null"))
+    {
+        record_.Set(field_, value_);
+    }
+}
+
+void OmmJsonReader::SyntaxError(char c)
+{
+    std::string message("Invalid JSON, unexpected ");
+    if (static_cast<unsigned char>(c) >= 0x20)
+    {
+        message += '\'';
+        message += c;
+        message += '\'';
+    }
+    else
+    {
+        message += "control character";
+    }
+    on_error_(TleCatalog::Error{ line_, message });
+    state_ = FAILED;
+}
+
+}; // end namespace csgp4
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "csgp4/OmmKvnReader.h"
+
+#include <cstring>
+
+namespace
+{
+    std::string_view Trim(std::string_view text)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+        {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t' || text.back() == '\r'))
+        {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    bool EndsWith(std::string_view text, std::string_view suffix)
+    {
+        return text.size() >= suffix.size()
+            && text.substr(text.size() - suffix.size()) == suffix;
+    }
+}
+
+namespace csgp4
+{
+
+OmmKvnReader::OmmKvnReader(RecordHandler on_record, ErrorHandler on_error)
+    : on_record_(std::move(on_record))
+    , on_error_(std::move(on_error))
+{
+}
+
+void OmmKvnReader::Feed(const char* data, size_t size)
+{
+    const char* end = data + size;
+
+    while (data < end)
+    {
+        const void* nl = memchr(data, '\n', static_cast<size_t>(end - data));
+        if (nl == nullptr)
+        {
+            carry_.append(data, static_cast<size_t>(end - data));
+            return;
+        }
+
+        const char* next = static_cast<const char*>(nl);
+        if (carry_.empty())
+        {
+            ReadLine(std::string_view(data, static_cast<size_t>(next - data)));
+        }
+        else
+        {
+            carry_.append(data, static_cast<size_t>(next - data));
+            ReadLine(carry_);
+            carry_.clear();
+        }
+        line_++;
+        data = next + 1;
+    }
+}
+
+void OmmKvnReader::Finish()
+{
+    if (!carry_.empty())
+    {
+        ReadLine(carry_);
+        carry_.clear();
+    }
+    if (in_record_)
+    {
+        record_.End(on_record_, on_error_);
+        in_record_ = false;
+    }
+}
+
+void OmmKvnReader::ReadLine(std::string_view line)
+{
+    line = Trim(line);
+    if (line.empty() || line.substr(0, 7) == "COMMENT")
+    {
+        return;
+    }
+
+    const size_t equals = line.find('=');
+    if (equals == std::string_view::npos)
+    {
+        /*
+         * the META_START and DATA_STOP style block markers
+         */
+        if (EndsWith(line, "_START") || EndsWith(line, "_STOP"))
+        {
+            return;
+        }
+        if (!in_record_)
+        {
+            Start();
+        }
+        record_.Fail("Invalid line");
+        return;
+    }
+
+    const std::string_view key = Trim(line.substr(0, equals));
+    std::string_view value = Trim(line.substr(equals + 1));
+
+    if (key == "CCSDS_OMM_VERS")
+    {
+        Start();
+        return;
+    }
+
+    const OmmRecord::Field field = OmmRecord::FindField(key, last_field_);
+    if (field == OmmRecord::NONE)
+    {
+        return;
+    }
+    if (!in_record_ || record_.Has(field))
+    {
+        Start();
+    }
+    last_field_ = field;
+
+    /*
+     * units, as in 15.5 [rev/day], are only dropped from numbers since a
+     * name may end in brackets
+     */
+    if (field != OmmRecord::OBJECT_NAME && field != OmmRecord::OBJECT_ID
+            && !value.empty() && value.back() == ']')
+    {
+        const size_t open = value.rfind('[');
+        if (open != std::string_view::npos)
+        {
+            value = Trim(value.substr(0, open));
+        }
+    }
+
+    if (!value.empty())
+    {
+        record_.Set(field, value);
+    }
+}
+
+/**
+ * End the open record, if any, and begin the next on this line
+ */
+void OmmKvnReader::Start()
+{
+    if (in_record_)
+    {
+        record_.End(on_record_, on_error_);
+    }
+    record_.Begin(line_);
+    last_field_ = OmmRecord::NONE;
+    in_record_ = true;
+}
+
+}; // end namespace csgp4
@@ -0,0 +1,286 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "csgp4/OmmRecord.h"
+
+#include <charconv>
+#include <cmath>
+
+namespace
+{
+    static const std::string_view kFieldNames[] = {
+        "",
+        "OBJECT_NAME",
+        "OBJECT_ID",
+        "EPOCH",
+        "MEAN_MOTION",
+        "ECCENTRICITY",
+        "INCLINATION",
+        "RA_OF_ASC_NODE",
+        "ARG_OF_PERICENTER",
+        "MEAN_ANOMALY",
+        "EPHEMERIS_TYPE",
+        "CLASSIFICATION_TYPE",
+        "NORAD_CAT_ID",
+        "REV_AT_EPOCH",
+        "BSTAR",
+        "MEAN_MOTION_DOT",
+        "MEAN_MOTION_DDOT"
+    };
+
+    bool ParseDouble(std::string_view text, double& val)
+    {
+        const char* first = text.data();
+        const char* last = first + text.size();
+        if (first < last && *first == '+')
+        {
+            first++;
+        }
+        const std::from_chars_result result = std::from_chars(first, last, val);
+        return result.ec == std::errc() && result.ptr == last && std::isfinite(val);
+    }
+
+    bool ParseUnsigned(std::string_view text, unsigned int& val)
+    {
+        const char* first = text.data();
+        const char* last = first + text.size();
+        const std::from_chars_result result = std::from_chars(first, last, val);
+        return result.ec == std::errc() && result.ptr == last;
+    }
+
+    /**
+     * Read a fixed width number at pos
+     */
+    bool ParseDigits(std::string_view text, size_t pos, size_t length, int& val)
+    {
+        if (pos + length > text.size())
+        {
+            return false;
+        }
+        const char* first = text.data() + pos;
+        const std::from_chars_result result = std::from_chars(first, first + length, val);
+        return result.ec == std::errc() && result.ptr == first + length;
+    }
+}
+
+namespace csgp4
+{
+
+OmmRecord::Field OmmRecord::FindField(std::string_view key, Field last)
+{
+    if (last + 1 < FIELD_COUNT && kFieldNames[last + 1] == key)
+    {
+        return static_cast<Field>(last + 1);
+    }
+    for (int field = OBJECT_NAME; field < FIELD_COUNT; field++)
+    {
+        if (kFieldNames[field] == key)
+        {
+            return static_cast<Field>(field);
+        }
+    }
+    return NONE;
+}
+
+/**
+ * Read an ISO 8601 date and time, YYYY-MM-DDTHH:MM:SS with an optional
+ * fraction of a second, kept to the microsecond, and optional Z
+ */
+bool OmmRecord::ParseEpoch(std::string_view text, DateTime& epoch)
+{
+    int year;
+    int month;
+    int day;
+    int hour;
+    int minute;
+    int second;
+
+    if (text.size() < 19)
+    {
+        return false;
+    }
+
+    if (!ParseDigits(text, 0, 4, year) || text[4] != '-'
+            || !ParseDigits(text, 5, 2, month) || text[7] != '-'
+            || !ParseDigits(text, 8, 2, day) || (text[10] != 'T' && text[10] != ' ')
+            || !ParseDigits(text, 11, 2, hour) || text[13] != ':'
+            || !ParseDigits(text, 14, 2, minute) || text[16] != ':'
+            || !ParseDigits(text, 17, 2, second))
+    {
+        return false;
+    }
+
+    size_t pos = 19;
+    const int microsecond = DateTime::ParseMicrosecond(text, pos);
+    if (pos < text.size() && text[pos] == 'Z')
+    {
+        pos++;
+    }
+
+    if (pos != text.size() || !DateTime::IsValidYearMonthDay(year, month, day)
+            || hour > 23 || minute > 59 || second > 59)
+    {
+        return false;
+    }
+
+    epoch.Initialise(year, month, day, hour, minute, second, microsecond);
+    return true;
+}
+
+void OmmRecord::Begin(size_t line)
+{
+    line_ = line;
+    seen_ = 0;
+    error_.clear();
+
+    /*
+     * cleared in place, so the strings keep their storage
+     */
+    args_.name.clear();
+    args_.int_designator.clear();
+    args_.epoch.clear();
+    args_.classification_type.clear();
+    args_.mean_motion_dot = 0.0;
+    args_.mean_motion_ddot = 0.0;
+    args_.bstar = 0.0;
+    args_.inclination = 0.0;
+    args_.right_ascending_node = 0.0;
+    args_.eccentricity = 0.0;
+    args_.argument_perigee = 0.0;
+    args_.mean_anomaly = 0.0;
+    args_.mean_motion = 0.0;
+    args_.ephemeris_type = 0;
+    args_.norad_number = 0;
+    args_.orbit_number = 0;
+}
+
+void OmmRecord::Set(Field field, std::string_view value)
+{
+    bool ok = true;
+    switch (field)
+    {
+    case OBJECT_NAME:
+        args_.name.assign(value.data(), value.size());
+        break;
+    case OBJECT_ID:
+        args_.int_designator.assign(value.data(), value.size());
+        break;
+    case CLASSIFICATION_TYPE:
+        args_.classification_type.assign(value.data(), value.size());
+        break;
+    case EPOCH:
+        args_.epoch.assign(value.data(), value.size());
+        ok = ParseEpoch(value, epoch_);
+        break;
+    case MEAN_MOTION:
+        ok = ParseDouble(value, args_.mean_motion);
+        break;
+    case ECCENTRICITY:
+        ok = ParseDouble(value, args_.eccentricity);
+        break;
+    case INCLINATION:
+        ok = ParseDouble(value, args_.inclination);
+        break;
+    case RA_OF_ASC_NODE:
+        ok = ParseDouble(value, args_.right_ascending_node);
+        break;
+    case ARG_OF_PERICENTER:
+        ok = ParseDouble(value, args_.argument_perigee);
+        break;
+    case MEAN_ANOMALY:
+        ok = ParseDouble(value, args_.mean_anomaly);
+        break;
+    case BSTAR:
+        ok = ParseDouble(value, args_.bstar);
+        break;
+    case MEAN_MOTION_DOT:
+        ok = ParseDouble(value, args_.mean_motion_dot);
+        break;
+    case MEAN_MOTION_DDOT:
+        ok = ParseDouble(value, args_.mean_motion_ddot);
+        break;
+    case EPHEMERIS_TYPE:
+        ok = ParseUnsigned(value, args_.ephemeris_type);
+        break;
+    case NORAD_CAT_ID:
+        ok = ParseUnsigned(value, args_.norad_number);
+        break;
+    case REV_AT_EPOCH:
+        ok = ParseUnsigned(value, args_.orbit_number);
+        break;
+    default:
+        return;
+    }
+
+    if (ok)
+    {
+        seen_ |= 1u << field;
+    }
+    else
+    {
+        Invalid(field);
+    }
+}
+
+void OmmRecord::Invalid(Field field)
+{
+    Fail("Invalid", field);
+}
+
+void OmmRecord::Fail(std::string_view message)
+{
+    if (error_.empty())
+    {
+        error_.assign(message.data(), message.size());
+    }
+}
+
+void OmmRecord::Fail(const char* message, Field field)
+{
+    if (error_.empty())
+    {
+        error_ = message;
+        error_ += ' ';
+        error_.append(kFieldNames[field].data(), kFieldNames[field].size());
+    }
+}
+
+void OmmRecord::End(const RecordHandler& on_record, const ErrorHandler& on_error)
+{
+    static const Field required[] = {
+        EPOCH, MEAN_MOTION, ECCENTRICITY, INCLINATION, RA_OF_ASC_NODE,
+        ARG_OF_PERICENTER, MEAN_ANOMALY, NORAD_CAT_ID
+    };
+
+    for (Field field : required)
+    {
+        if (!Has(field))
+        {
+            Fail("Missing", field);
+        }
+    }
+
+    if (!error_.empty())
+    {
+        on_error(TleCatalog::Error{ line_, error_ });
+        return;
+    }
+
+    on_record(Tle(args_, epoch_));
+}
+
+}; // end namespace csgp4
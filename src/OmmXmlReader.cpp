@@ -0,0 +1,462 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "csgp4/OmmXmlReader.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    bool IsSpace(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    std::string_view Trim(std::string_view text)
+    {
+        while (!text.empty() && IsSpace(text.front()))
+        {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && IsSpace(text.back()))
+        {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    void AppendUtf8(std::string& out, uint32_t code_point)
+    {
+        if (code_point < 0x80)
+        {
+            out.push_back(static_cast<char>(code_point));
+        }
+        else if (code_point < 0x800)
+        {
+            out.push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+        else if (code_point < 0x10000)
+        {
+            out.push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+        else
+        {
+            out.push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+            out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+            out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+        }
+    }
+
+    /*
+     * decode an entity, without its & and ;
+     */
+    bool DecodeEntity(std::string_view name, std::string& out)
+    {
+        if (name == "amp")
+        {
+            out += '&';
+        }
+        else if (name == "lt")
+        {
+            out += '<';
+        }
+        else if (name == "gt")
+        {
+            out += '>';
+        }
+        else if (name == "quot")
+        {
+            out += '"';
+        }
+        else if (name == "apos")
+        {
+            out += '\'';
+        }
+        else if (name.size() > 1 && name[0] == '#')
+        {
+            const bool hex = name[1] == 'x' || name[1] == 'X';
+            const std::string_view digits = name.substr(hex ? 2 : 1);
+            if (digits.empty() || digits.size() > 6)
+            {
+                return false;
+            }
+
+            uint32_t code_point = 0;
+            for (const char c : digits)
+            {
+                uint32_t digit;
+                if (c >= '0' && c <= '9')
+                {
+                    digit = static_cast<uint32_t>(c - '0');
+                }
+                else if (hex && (c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+                {
+                    digit = static_cast<uint32_t>((c | 0x20) - 'a' + 10);
+                }
+                else
+                {
+                    return false;
+                }
+                code_point = code_point * (hex ? 16 : 10) + digit;
+            }
+            if (code_point > 0x10ffff)
+            {
+                return false;
+            }
+            AppendUtf8(out, code_point);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+}
+
+namespace csgp4
+{
+
+OmmXmlReader::OmmXmlReader(RecordHandler on_record, ErrorHandler on_error)
+    : on_record_(std::move(on_record))
+    , on_error_(std::move(on_error))
+{
+}
+
+void OmmXmlReader::Feed(const char* data, size_t size)
+{
+    const char* p = data;
+    const char* end = data + size;
+
+    while (p < end)
+    {
+        if (state_ == TEXT)
+        {
+            /*
+             * the run of text up to the next tag
+             */
+            const void* lt = memchr(p, '<', static_cast<size_t>(end - p));
+            const char* stop = lt ? static_cast<const char*>(lt) : end;
+            line_ += static_cast<size_t>(std::count(p, stop, '\n'));
+            if (field_ != OmmRecord::NONE)
+            {
+                value_.append(p, static_cast<size_t>(stop - p));
+            }
+            p = stop;
+            if (p < end)
+            {
+                p++;
+                tag_line_ = line_;
+                state_ = TAG_START;
+            }
+            continue;
+        }
+
+        const char c = *p++;
+        if (c == '\n')
+        {
+            line_++;
+        }
+
+        switch (state_)
+        {
+        case TAG_START:
+            tag_.clear();
+            closing_ = false;
+            empty_ = false;
+            if (c == '/')
+            {
+                closing_ = true;
+                state_ = TAG_NAME;
+            }
+            else if (c == '!')
+            {
+                markup_.clear();
+                state_ = MARKUP;
+            }
+            else if (c == '?')
+            {
+                run_ = 0;
+                state_ = INSTRUCTION;
+            }
+            else
+            {
+                tag_ += c;
+                state_ = TAG_NAME;
+            }
+            break;
+
+        case TAG_NAME:
+            if (c == '>')
+            {
+                EndTag();
+            }
+            else if (c == '/')
+            {
+                empty_ = true;
+                quote_ = 0;
+                state_ = TAG_REST;
+            }
+            else if (IsSpace(c))
+            {
+                quote_ = 0;
+                state_ = TAG_REST;
+            }
+            else if (c == ':')
+            {
+                /*
+                 * the namespace prefix is dropped
+                 */
+                tag_.clear();
+            }
+            else
+            {
+                tag_ += c;
+            }
+            break;
+
+        case TAG_REST:
+            /*
+             * the attributes, which are not read
+             */
+            if (quote_)
+            {
+                if (c == quote_)
+                {
+                    quote_ = 0;
+                }
+            }
+            else if (c == '"' || c == '\'')
+            {
+                quote_ = c;
+            }
+            else if (c == '>')
+            {
+                EndTag();
+            }
+            else
+            {
+                empty_ = c == '/' || (empty_ && IsSpace(c));
+            }
+            break;
+
+        case MARKUP:
+            /*
+             * what follows <! decides between a comment, CDATA and a
+             * declaration such as a DOCTYPE
+             */
+            markup_ += c;
+            if (markup_ == "--")
+            {
+                run_ = 0;
+                state_ = COMMENT;
+            }
+            else if (markup_ == "[CDATA[")
+            {
+                run_ = 0;
+                state_ = CDATA;
+            }
+            else if (std::string_view("--").substr(0, markup_.size()) != markup_
+                    && std::string_view("[CDATA[").substr(0, markup_.size()) != markup_)
+            {
+                depth_ = static_cast<size_t>(std::count(markup_.begin(), markup_.end(), '['));
+                state_ = c == '>' && depth_ == 0 ? TEXT : DECLARATION;
+            }
+            break;
+
+        case COMMENT:
+            if (c == '>' && run_ >= 2)
+            {
+                state_ = TEXT;
+            }
+            run_ = c == '-' ? run_ + 1 : 0;
+            break;
+
+        case CDATA:
+        {
+            /*
+             * a ]] is held back until it is known not to end the section
+             */
+            if (c == ']')
+            {
+                run_++;
+                break;
+            }
+
+            const bool close = c == '>' && run_ >= 2;
+            if (field_ != OmmRecord::NONE)
+            {
+                value_.append(close ? run_ - 2 : run_, ']');
+                if (c == '&')
+                {
+                    /*
+                     * the text is decoded when the field ends
+                     */
+                    value_ += "&amp;";
+                }
+                else if (!close)
+                {
+                    value_ += c;
+                }
+            }
+            run_ = 0;
+            if (close)
+            {
+                state_ = TEXT;
+            }
+            break;
+        }
+
+        case DECLARATION:
+            if (c == '[')
+            {
+                depth_++;
+            }
+            else if (c == ']' && depth_ > 0)
+            {
+                depth_--;
+            }
+            else if (c == '>' && depth_ == 0)
+            {
+                state_ = TEXT;
+            }
+            break;
+
+        case INSTRUCTION:
+            if (c == '>' && run_ == 1)
+            {
+                state_ = TEXT;
+            }
+            run_ = c == '?' ? 1 : 0;
+            break;
+
+        case TEXT:
+            break;
+        }
+    }
+}
+
+bool OmmXmlReader::Finish()
+{
+    if (state_ != TEXT || in_record_)
+    {
+        on_error_(TleCatalog::Error{ line_, "Unexpected end of XML" });
+        in_record_ = false;
+        field_ = OmmRecord::NONE;
+        state_ = TEXT;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Act on a whole tag
+ */
+void OmmXmlReader::EndTag()
+{
+    state_ = TEXT;
+
+    if (tag_ == "omm")
+    {
+        if (in_record_)
+        {
+            record_.End(on_record_, on_error_);
+            in_record_ = false;
+        }
+        if (!closing_ && !empty_)
+        {
+            record_.Begin(tag_line_);
+            last_field_ = OmmRecord::NONE;
+            in_record_ = true;
+        }
+        field_ = OmmRecord::NONE;
+        return;
+    }
+
+    if (!in_record_)
+    {
+        return;
+    }
+
+    if (closing_)
+    {
+        if (field_ != OmmRecord::NONE)
+        {
+            SetField();
+        }
+        field_ = OmmRecord::NONE;
+    }
+    else
+    {
+        /*
+         * a field is a leaf, so any tag inside one is not
+         */
+        field_ = empty_ ? OmmRecord::NONE : OmmRecord::FindField(tag_, last_field_);
+        if (field_ != OmmRecord::NONE)
+        {
+            last_field_ = field_;
+        }
+        value_.clear();
+    }
+}
+
+/**
+ * Set the field from its text, decoding entities
+ */
+void OmmXmlReader::SetField()
+{
+    const std::string_view text = Trim(value_);
+    if (text.empty())
+    {
+        return;
+    }
+
+    if (text.find('&') == std::string_view::npos)
+    {
+        record_.Set(field_, text);
+        return;
+    }
+
+    decoded_.clear();
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        const size_t amp = text.find('&', pos);
+        if (amp == std::string_view::npos)
+        {
+            decoded_.append(text.data() + pos, text.size() - pos);
+            break;
+        }
+        decoded_.append(text.data() + pos, amp - pos);
+
+        const size_t semi = text.find(';', amp);
+        if (semi == std::string_view::npos
+                || !DecodeEntity(text.substr(amp + 1, semi - amp - 1), decoded_))
+        {
+            record_.Fail("Invalid entity");
+            return;
+        }
+        pos = semi + 1;
+    }
+    record_.Set(field_, decoded_);
+}
+
+}; // end namespace csgp4
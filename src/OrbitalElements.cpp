@@ -22,32 +22,67 @@
 namespace csgp4
 {
 
-OrbitalElements::OrbitalElements(const Tle& tle)
+OrbitalElements::OrbitalElements(const Tle& tle, GravityModel model)
+    : OrbitalElements(tle.MeanAnomaly(false),
+                      tle.RightAscendingNode(false),
+                      tle.ArgumentPerigee(false),
+                      tle.Eccentricity(),
+                      tle.Inclination(false),
+                      tle.MeanMotion() * kTWOPI / kMINUTES_PER_DAY,
+                      tle.BStar(),
+                      tle.Epoch(),
+                      model)
 {
-    /*
-     * extract and format tle data
-     */
-    mean_anomoly_ = tle.MeanAnomaly(false);
-    ascending_node_ = tle.RightAscendingNode(false);
-    argument_perigee_ = tle.ArgumentPerigee(false);
-    eccentricity_ = tle.Eccentricity();
-    inclination_ = tle.Inclination(false);
-    mean_motion_ = tle.MeanMotion() * kTWOPI / kMINUTES_PER_DAY;
-    bstar_ = tle.BStar();
-    epoch_ = tle.Epoch();
+}
 
+OrbitalElements::OrbitalElements(double mean_anomoly,
+                                 double ascending_node,
+                                 double argument_perigee,
+                                 double eccentricity,
+                                 double inclination,
+                                 double mean_motion,
+                                 double bstar,
+                                 const DateTime& epoch,
+                                 GravityModel model)
+    : mean_anomoly_(mean_anomoly)
+    , ascending_node_(ascending_node)
+    , argument_perigee_(argument_perigee)
+    , eccentricity_(eccentricity)
+    , inclination_(inclination)
+    , mean_motion_(mean_motion)
+    , bstar_(bstar)
+    , epoch_(epoch)
+    , gravity_model_(model)
+{
+    switch (model)
+    {
+    case GRAVITY_WGS72_OLD:
+        Recover<Wgs72OldGravity>();
+        break;
+    case GRAVITY_WGS84:
+        Recover<Wgs84Gravity>();
+        break;
+    default:
+        Recover<Wgs72Gravity>();
+        break;
+    }
+}
+
+template <class Gravity>
+void OrbitalElements::Recover()
+{
     /*
      * recover original mean motion (xnodp) and semimajor axis (aodp)
      * from input elements
      */
-    const double a1 = pow(kXKE / MeanMotion(), kTWOTHIRD);
+    const double a1 = pow(Gravity::kXKE / MeanMotion(), kTWOTHIRD);
     const double cosio = cos(Inclination());
     const double theta2 = cosio * cosio;
     const double x3thm1 = 3.0 * theta2 - 1.0;
     const double eosq = Eccentricity() * Eccentricity();
     const double betao2 = 1.0 - eosq;
     const double betao = sqrt(betao2);
-    const double temp = (1.5 * kCK2) * x3thm1 / (betao * betao2);
+    const double temp = (1.5 * Gravity::kCK2) * x3thm1 / (betao * betao2);
     const double del1 = temp / (a1 * a1);
     const double a0 = a1 * (1.0 - del1 * (1.0 / 3.0 + del1 * (1.0 + del1 * 134.0 / 81.0)));
     const double del0 = temp / (a0 * a0);
@@ -63,7 +98,7 @@ OrbitalElements::OrbitalElements(const Tle& tle)
     /*
      * find perigee and period
      */
-    perigee_ = (RecoveredSemiMajorAxis() * (1.0 - Eccentricity()) - kAE) * kXKMPER;
+    perigee_ = (RecoveredSemiMajorAxis() * (1.0 - Eccentricity()) - Gravity::kAE) * Gravity::kXKMPER;
     period_ = kTWOPI / RecoveredMeanMotion();
 }
 
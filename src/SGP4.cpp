@@ -22,26 +22,136 @@
 #include "csgp4/Vector.h"
 #include "csgp4/SatelliteException.h"
 #include "csgp4/DecayedException.h"
+#include "csgp4/FastMath.h"
 #include "csgp4/OrbitalElements.h"
+#include "csgp4/Kepler.h"
+#include "csgp4/SGP4Kernel.h"
+#include "csgp4/Dual.h"
+#include "csgp4/Stats.h"
 
 #include <cmath>
 #include <iomanip>
 #include <cstring>
+#include <atomic>
+#include <algorithm>
+
+namespace
+{
+    /*
+     * resonance integrator step size (minutes) and half its square
+     */
+    static const double STEP = 720.0;
+    static const double STEP2 = 259200.0;
+
+    /*
+     * central difference steps for the deep space state partials, in the
+     * order of SGP4::Element; the mean motion one is relative
+     */
+    static const double JACOBIAN_STEPS[csgp4::SGP4::ELEMENT_COUNT] =
+    {
+        1.0e-6, 1.0e-6, 1.0e-6, 1.0e-6, 1.0e-6, 1.0e-6, 1.0e-7
+    };
+
+    /*
+     * copy out the state of a kernel, which only sets it once the model
+     * gets as far as the position
+     */
+    template <bool kVelocity>
+    inline csgp4::PropagationStatus StoreState(const csgp4::PropagationStatus status,
+                                               const double* pos,
+                                               const double* vel,
+                                               csgp4::Vector& position,
+                                               csgp4::Vector& velocity)
+    {
+        if (status == csgp4::PROPAGATION_OK || status == csgp4::PROPAGATION_DECAYED)
+        {
+            position = csgp4::Vector(pos[0], pos[1], pos[2]);
+            if (kVelocity)
+            {
+                velocity = csgp4::Vector(vel[0], vel[1], vel[2]);
+            }
+        }
+
+        return status;
+    }
+}
 
 namespace csgp4
 {
 
+SGP4::SGP4(const SGP4& other)
+    : common_consts_(other.common_consts_)
+    , nearspace_consts_(other.nearspace_consts_)
+    , deepspace_consts_(other.deepspace_consts_
+            ? new DeepSpaceConstants(*other.deepspace_consts_) : nullptr)
+    , instance_id_(other.instance_id_)
+    , elements_(other.elements_)
+    , use_simple_model_(other.use_simple_model_)
+    , use_deep_space_(other.use_deep_space_)
+{
+}
+
+SGP4& SGP4::operator=(const SGP4& other)
+{
+    if (this != &other)
+    {
+        common_consts_ = other.common_consts_;
+        nearspace_consts_ = other.nearspace_consts_;
+        deepspace_consts_.reset(other.deepspace_consts_
+                ? new DeepSpaceConstants(*other.deepspace_consts_) : nullptr);
+        instance_id_ = other.instance_id_;
+        elements_ = other.elements_;
+        use_simple_model_ = other.use_simple_model_;
+        use_deep_space_ = other.use_deep_space_;
+    }
+
+    return *this;
+}
+
+size_t SGP4::MemoryUsage() const
+{
+    size_t bytes = sizeof(*this);
+
+    if (deepspace_consts_)
+    {
+        bytes += sizeof(DeepSpaceConstants);
+        bytes += deepspace_consts_->checkpoints.states.capacity()
+            * sizeof(IntegratorParams);
+    }
+
+    return bytes;
+}
+
 void SGP4::SetTle(const Tle& tle)
 {
     /*
      * extract and format tle data
      */
-    elements_ = OrbitalElements(tle);
+    elements_ = OrbitalElements(tle, elements_.Gravity());
 
     Initialise();
 }
 
 void SGP4::Initialise()
+{
+    CSGP4_STATS_INC(INITIALISE_CALLS);
+
+    switch (elements_.Gravity())
+    {
+    case GRAVITY_WGS72_OLD:
+        InitialiseModel<Wgs72OldGravity>();
+        break;
+    case GRAVITY_WGS84:
+        InitialiseModel<Wgs84Gravity>();
+        break;
+    default:
+        InitialiseModel<Wgs72Gravity>();
+        break;
+    }
+}
+
+template <class Gravity>
+void SGP4::InitialiseModel()
 {
     /*
      * reset all constants etc
@@ -61,107 +171,40 @@ void SGP4::Initialise()
         throw SatelliteException("Inclination out of range");
     }
 
-    RecomputeConstants(elements_.Inclination(),
-                       common_consts_.sinio,
-                       common_consts_.cosio,
-                       common_consts_.x3thm1,
-                       common_consts_.x1mth2,
-                       common_consts_.x7thm1,
-                       common_consts_.xlcof,
-                       common_consts_.aycof);
-
-    const double theta2 = common_consts_.cosio * common_consts_.cosio;
-    const double eosq = elements_.Eccentricity() * elements_.Eccentricity();
-    const double betao2 = 1.0 - eosq;
-    const double betao = sqrt(betao2);
-
-    if (elements_.Period() >= 225.0)
-    {
-        use_deep_space_ = true;
-    }
-    else
+    use_deep_space_ = elements_.Period() >= 225.0;
+
+    /*
+     * generate the constants, the near space ones only for near space
+     */
+    SGP4Kernel<double>::Initialise<Gravity>(KernelElements(),
+                                            use_simple_model_,
+                                            common_consts_,
+                                            use_deep_space_ ? nullptr : &nearspace_consts_);
+
+    if (use_deep_space_)
     {
-        use_deep_space_ = false;
+        /*
+         * the simple model flag only applies to near space
+         */
         use_simple_model_ = false;
+
+        const double theta2 = common_consts_.cosio * common_consts_.cosio;
+        const double eosq = elements_.Eccentricity() * elements_.Eccentricity();
+        const double betao2 = 1.0 - eosq;
+        const double betao = sqrt(betao2);
+
         /*
-         * for perigee less than 220 kilometers, the simple_model flag is set
-         * and the equations are truncated to linear variation in sqrt a and
-         * quadratic variation in mean anomly. also, the c3 term, the
-         * delta omega term and the delta m term are dropped
+         * reuse the block left by a previous element set if there is one
          */
-        if (elements_.Perigee() < 220.0)
+        if (deepspace_consts_)
         {
-            use_simple_model_ = true;
+            *deepspace_consts_ = DeepSpaceConstants();
         }
-    }
-
-    /*
-     * for perigee below 156km, the values of
-     * s4 and qoms2t are altered
-     */
-    double s4 = kS;
-    double qoms24 = kQOMS2T;
-    if (elements_.Perigee() < 156.0)
-    {
-        s4 = elements_.Perigee() - 78.0;
-        if (elements_.Perigee() < 98.0) 
+        else
         {
-            s4 = 20.0;
+            deepspace_consts_.reset(new DeepSpaceConstants());
         }
-        qoms24 = pow((120.0 - s4) * kAE / kXKMPER, 4.0);
-        s4 = s4 / kXKMPER + kAE;
-    }
-
-    /*
-     * generate constants
-     */
-    const double pinvsq = 1.0
-        / (elements_.RecoveredSemiMajorAxis()
-                * elements_.RecoveredSemiMajorAxis()
-                * betao2 * betao2);
-    const double tsi = 1.0 / (elements_.RecoveredSemiMajorAxis() - s4);
-    common_consts_.eta = elements_.RecoveredSemiMajorAxis()
-        * elements_.Eccentricity() * tsi;
-    const double etasq = common_consts_.eta * common_consts_.eta;
-    const double eeta = elements_.Eccentricity() * common_consts_.eta;
-    const double psisq = fabs(1.0 - etasq);
-    const double coef = qoms24 * pow(tsi, 4.0);
-    const double coef1 = coef / pow(psisq, 3.5);
-    const double c2 = coef1 * elements_.RecoveredMeanMotion()
-        * (elements_.RecoveredSemiMajorAxis()
-        * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq))
-        + 0.75 * kCK2 * tsi / psisq * common_consts_.x3thm1
-        * (8.0 + 3.0 * etasq * (8.0 + etasq)));
-    common_consts_.c1 = elements_.BStar() * c2;
-    common_consts_.c4 = 2.0 * elements_.RecoveredMeanMotion()
-        * coef1 * elements_.RecoveredSemiMajorAxis() * betao2
-        * (common_consts_.eta * (2.0 + 0.5 * etasq) + elements_.Eccentricity()
-        * (0.5 + 2.0 * etasq)
-        - 2.0 * kCK2 * tsi / (elements_.RecoveredSemiMajorAxis() * psisq)
-        * (-3.0 * common_consts_.x3thm1 * (1.0 - 2.0 * eeta + etasq
-        * (1.5 - 0.5 * eeta))
-        + 0.75 * common_consts_.x1mth2 * (2.0 * etasq - eeta *
-            (1.0 + etasq)) * cos(2.0 * elements_.ArgumentPerigee())));
-    const double theta4 = theta2 * theta2;
-    const double temp1 = 3.0 * kCK2 * pinvsq * elements_.RecoveredMeanMotion();
-    const double temp2 = temp1 * kCK2 * pinvsq;
-    const double temp3 = 1.25 * kCK4 * pinvsq * pinvsq * elements_.RecoveredMeanMotion();
-    common_consts_.xmdot = elements_.RecoveredMeanMotion() + 0.5 * temp1 * betao *
-            common_consts_.x3thm1 + 0.0625 * temp2 * betao *
-            (13.0 - 78.0 * theta2 + 137.0 * theta4);
-    const double x1m5th = 1.0 - 5.0 * theta2;
-    common_consts_.omgdot = -0.5 * temp1 * x1m5th +
-            0.0625 * temp2 * (7.0 - 114.0 * theta2 + 395.0 * theta4) +
-            temp3 * (3.0 - 36.0 * theta2 + 49.0 * theta4);
-    const double xhdot1 = -temp1 * common_consts_.cosio;
-    common_consts_.xnodot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * theta2) + 2.0 * temp3 *
-            (3.0 - 7.0 * theta2)) * common_consts_.cosio;
-    common_consts_.xnodcf = 3.5 * betao2 * xhdot1 * common_consts_.c1;
-    common_consts_.t2cof = 1.5 * common_consts_.c1;
-
-    if (use_deep_space_)
-    {
-        deepspace_consts_.gsto = elements_.Epoch().ToGreenwichSiderealTime();
+        deepspace_consts_->gsto = elements_.Epoch().ToGreenwichSiderealTime();
 
         DeepSpaceInitialise(eosq,
                             common_consts_.sinio,
@@ -175,62 +218,539 @@ void SGP4::Initialise()
     }
     else
     {
-        double c3 = 0.0;
-        if (elements_.Eccentricity() > 1.0e-4)
+        deepspace_consts_.reset();
+    }
+}
+
+Eci SGP4::FindPosition(const DateTime& dt) const
+{
+    return FindPosition((dt - elements_.Epoch()).TotalMinutes());
+}
+
+Eci SGP4::FindPosition(double tsince) const
+{
+    if (use_deep_space_ && deepspace_consts_->shape != DeepSpaceConstants::NONE)
+    {
+        return FindPosition(tsince, ThreadIntegratorParams());
+    }
+
+    IntegratorParams integ;
+    return FindPosition(tsince, integ);
+}
+
+Eci SGP4::FindPosition(const DateTime& dt, IntegratorParams& integ) const
+{
+    return FindPosition((dt - elements_.Epoch()).TotalMinutes(), integ);
+}
+
+PropagationStatus SGP4::TryFindPosition(double tsince,
+                                        Vector& position,
+                                        Vector& velocity) const noexcept
+{
+    if (use_deep_space_ && deepspace_consts_->shape != DeepSpaceConstants::NONE)
+    {
+        return TryFindPosition(tsince, ThreadIntegratorParams(), position, velocity);
+    }
+
+    IntegratorParams integ;
+    return TryFindPosition(tsince, integ, position, velocity);
+}
+
+PropagationStatus SGP4::TryFindPosition(double tsince,
+                                        IntegratorParams& integ,
+                                        Vector& position,
+                                        Vector& velocity) const noexcept
+{
+    return Propagate<true>(tsince, integ, position, velocity);
+}
+
+Vector SGP4::FindPositionOnly(const DateTime& dt) const
+{
+    return FindPositionOnly((dt - elements_.Epoch()).TotalMinutes());
+}
+
+Vector SGP4::FindPositionOnly(double tsince) const
+{
+    Vector position;
+    const PropagationStatus status = TryFindPositionOnly(tsince, position);
+
+    if (status != PROPAGATION_OK)
+    {
+        ThrowStatus(status, elements_.Epoch().AddMinutes(tsince), position, Vector());
+    }
+
+    return position;
+}
+
+PropagationStatus SGP4::TryFindPositionOnly(double tsince,
+                                            Vector& position) const noexcept
+{
+    if (use_deep_space_ && deepspace_consts_->shape != DeepSpaceConstants::NONE)
+    {
+        return TryFindPositionOnly(tsince, ThreadIntegratorParams(), position);
+    }
+
+    IntegratorParams integ;
+    return TryFindPositionOnly(tsince, integ, position);
+}
+
+PropagationStatus SGP4::TryFindPositionOnly(double tsince,
+                                            IntegratorParams& integ,
+                                            Vector& position) const noexcept
+{
+    Vector unused;
+    return Propagate<false>(tsince, integ, position, unused);
+}
+
+Eci SGP4::FindPositionJacobian(const DateTime& dt, StateJacobian& jacobian) const
+{
+    return FindPositionJacobian((dt - elements_.Epoch()).TotalMinutes(), jacobian);
+}
+
+Eci SGP4::FindPositionJacobian(double tsince, StateJacobian& jacobian) const
+{
+    Vector position;
+    Vector velocity;
+    const PropagationStatus status =
+        TryFindPositionJacobian(tsince, position, velocity, jacobian);
+
+    if (status != PROPAGATION_OK)
+    {
+        ThrowStatus(status, elements_.Epoch().AddMinutes(tsince), position, velocity);
+    }
+
+    return Eci(elements_.Epoch().AddMinutes(tsince), position, velocity);
+}
+
+PropagationStatus SGP4::TryFindPositionJacobian(double tsince,
+                                                Vector& position,
+                                                Vector& velocity,
+                                                StateJacobian& jacobian) const noexcept
+{
+    if (use_deep_space_)
+    {
+        return DeepSpaceJacobian(tsince, position, velocity, jacobian);
+    }
+
+    switch (elements_.Gravity())
+    {
+    case GRAVITY_WGS72_OLD:
+        return NearSpaceJacobian<Wgs72OldGravity>(tsince, position, velocity, jacobian);
+    case GRAVITY_WGS84:
+        return NearSpaceJacobian<Wgs84Gravity>(tsince, position, velocity, jacobian);
+    default:
+        return NearSpaceJacobian<Wgs72Gravity>(tsince, position, velocity, jacobian);
+    }
+}
+
+template <class Gravity>
+PropagationStatus SGP4::NearSpaceJacobian(double tsince,
+                                          Vector& position,
+                                          Vector& velocity,
+                                          StateJacobian& jacobian) const noexcept
+{
+    typedef Dual<ELEMENT_COUNT> Scalar;
+    typedef SGP4Kernel<Scalar> Kernel;
+
+    /*
+     * seed every element as an independent variable and run the whole
+     * model, initialisation included, on them
+     */
+    Kernel::Elements elements;
+    elements.inclination = Scalar::Variable(elements_.Inclination(), ELEMENT_INCLINATION);
+    elements.ascending_node = Scalar::Variable(elements_.AscendingNode(), ELEMENT_ASCENDING_NODE);
+    elements.eccentricity = Scalar::Variable(elements_.Eccentricity(), ELEMENT_ECCENTRICITY);
+    elements.argument_perigee = Scalar::Variable(elements_.ArgumentPerigee(), ELEMENT_ARGUMENT_PERIGEE);
+    elements.mean_anomaly = Scalar::Variable(elements_.MeanAnomoly(), ELEMENT_MEAN_ANOMALY);
+    elements.mean_motion = Scalar::Variable(elements_.MeanMotion(), ELEMENT_MEAN_MOTION);
+    elements.bstar = Scalar::Variable(elements_.BStar(), ELEMENT_BSTAR);
+    Kernel::Recover<Gravity>(elements);
+
+    bool use_simple_model;
+    Kernel::CommonConstants common_consts;
+    Kernel::NearSpaceConstants nearspace_consts;
+    Kernel::Initialise<Gravity>(elements,
+                                use_simple_model,
+                                common_consts,
+                                &nearspace_consts);
+
+    Scalar pos[3];
+    Scalar vel[3];
+    const PropagationStatus status = Kernel::Propagate<Gravity, true>(elements,
+                                                                      use_simple_model,
+                                                                      common_consts,
+                                                                      nearspace_consts,
+                                                                      Scalar(tsince),
+                                                                      pos,
+                                                                      vel);
+
+    position = Vector(pos[0].value, pos[1].value, pos[2].value);
+    velocity = Vector(vel[0].value, vel[1].value, vel[2].value);
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < ELEMENT_COUNT; j++)
         {
-            c3 = coef * tsi * kA3OVK2 * elements_.RecoveredMeanMotion() * kAE *
-                    common_consts_.sinio / elements_.Eccentricity();
+            jacobian.partials[i][j] = pos[i].partials[j];
+            jacobian.partials[i + 3][j] = vel[i].partials[j];
         }
+    }
 
-        nearspace_consts_.c5 = 2.0 * coef1 * elements_.RecoveredSemiMajorAxis() * betao2 * (1.0 + 2.75 *
-                (etasq + eeta) + eeta * etasq);
-        nearspace_consts_.omgcof = elements_.BStar() * c3 * cos(elements_.ArgumentPerigee());
+    return status;
+}
 
-        nearspace_consts_.xmcof = 0.0;
-        if (elements_.Eccentricity() > 1.0e-4)
+PropagationStatus SGP4::DeepSpaceJacobian(double tsince,
+                                          Vector& position,
+                                          Vector& velocity,
+                                          StateJacobian& jacobian) const noexcept
+{
+    IntegratorParams integ;
+    const PropagationStatus status = Propagate<true>(tsince, integ, position, velocity);
+
+    if (status != PROPAGATION_OK && status != PROPAGATION_DECAYED)
+    {
+        return status;
+    }
+
+    const double values[ELEMENT_COUNT] =
+    {
+        elements_.Inclination(),
+        elements_.AscendingNode(),
+        elements_.Eccentricity(),
+        elements_.ArgumentPerigee(),
+        elements_.MeanAnomoly(),
+        elements_.MeanMotion(),
+        elements_.BStar()
+    };
+
+    for (int j = 0; j < ELEMENT_COUNT; j++)
+    {
+        double step = JACOBIAN_STEPS[j];
+        if (j == ELEMENT_MEAN_MOTION)
         {
-            nearspace_consts_.xmcof = -kTWOTHIRD * coef * elements_.BStar() * kAE / eeta;
+            step *= values[j];
         }
 
-        nearspace_consts_.delmo = pow(1.0 + common_consts_.eta * (cos(elements_.MeanAnomoly())), 3.0);
-        nearspace_consts_.sinmo = sin(elements_.MeanAnomoly());
+        double perturbed[2][ELEMENT_COUNT];
+        for (int k = 0; k < ELEMENT_COUNT; k++)
+        {
+            perturbed[0][k] = values[k];
+            perturbed[1][k] = values[k];
+        }
+        perturbed[0][j] -= step;
+        perturbed[1][j] += step;
+
+        /*
+         * stay inside the range Initialise() accepts
+         */
+        if (j == ELEMENT_ECCENTRICITY)
+        {
+            perturbed[0][j] = std::max(perturbed[0][j], 0.0);
+            perturbed[1][j] = std::min(perturbed[1][j], 0.999);
+        }
+        else if (j == ELEMENT_INCLINATION)
+        {
+            perturbed[0][j] = std::max(perturbed[0][j], 0.0);
+            perturbed[1][j] = std::min(perturbed[1][j], kPI);
+        }
 
-        if (!use_simple_model_)
+        Vector pos[2];
+        Vector vel[2];
+        for (int k = 0; k < 2; k++)
         {
-            const double c1sq = common_consts_.c1 * common_consts_.c1;
-            nearspace_consts_.d2 = 4.0 * elements_.RecoveredSemiMajorAxis() * tsi * c1sq;
-            const double temp = nearspace_consts_.d2 * tsi * common_consts_.c1 / 3.0;
-            nearspace_consts_.d3 = (17.0 * elements_.RecoveredSemiMajorAxis() + s4) * temp;
-            nearspace_consts_.d4 = 0.5 * temp * elements_.RecoveredSemiMajorAxis() *
-                    tsi * (221.0 * elements_.RecoveredSemiMajorAxis() + 31.0 * s4) * common_consts_.c1;
-            nearspace_consts_.t3cof = nearspace_consts_.d2 + 2.0 * c1sq;
-            nearspace_consts_.t4cof = 0.25 * (3.0 * nearspace_consts_.d3 + common_consts_.c1 *
-                    (12.0 * nearspace_consts_.d2 + 10.0 * c1sq));
-            nearspace_consts_.t5cof = 0.2 * (3.0 * nearspace_consts_.d4 + 12.0 * common_consts_.c1 *
-                    nearspace_consts_.d3 + 6.0 * nearspace_consts_.d2 * nearspace_consts_.d2 + 15.0 *
-                    c1sq * (2.0 * nearspace_consts_.d2 + c1sq));
+            const SGP4 model(OrbitalElements(perturbed[k][ELEMENT_MEAN_ANOMALY],
+                                             perturbed[k][ELEMENT_ASCENDING_NODE],
+                                             perturbed[k][ELEMENT_ARGUMENT_PERIGEE],
+                                             perturbed[k][ELEMENT_ECCENTRICITY],
+                                             perturbed[k][ELEMENT_INCLINATION],
+                                             perturbed[k][ELEMENT_MEAN_MOTION],
+                                             perturbed[k][ELEMENT_BSTAR],
+                                             elements_.Epoch(),
+                                             elements_.Gravity()));
+            IntegratorParams model_integ;
+            const PropagationStatus model_status =
+                model.Propagate<true>(tsince, model_integ, pos[k], vel[k]);
+
+            if (model_status != PROPAGATION_OK && model_status != PROPAGATION_DECAYED)
+            {
+                return model_status;
+            }
         }
+
+        const double inv = 1.0 / (perturbed[1][j] - perturbed[0][j]);
+        jacobian.partials[0][j] = (pos[1].x - pos[0].x) * inv;
+        jacobian.partials[1][j] = (pos[1].y - pos[0].y) * inv;
+        jacobian.partials[2][j] = (pos[1].z - pos[0].z) * inv;
+        jacobian.partials[3][j] = (vel[1].x - vel[0].x) * inv;
+        jacobian.partials[4][j] = (vel[1].y - vel[0].y) * inv;
+        jacobian.partials[5][j] = (vel[1].z - vel[0].z) * inv;
     }
+
+    return status;
 }
 
-Eci SGP4::FindPosition(const DateTime& dt) const
+template <bool kVelocity>
+PropagationStatus SGP4::Propagate(double tsince,
+                                  IntegratorParams& integ,
+                                  Vector& position,
+                                  Vector& velocity) const noexcept
 {
-    return FindPosition((dt - elements_.Epoch()).TotalMinutes());
+    switch (elements_.Gravity())
+    {
+    case GRAVITY_WGS72_OLD:
+        return PropagateModel<Wgs72OldGravity, kVelocity>(tsince, integ, position, velocity);
+    case GRAVITY_WGS84:
+        return PropagateModel<Wgs84Gravity, kVelocity>(tsince, integ, position, velocity);
+    default:
+        return PropagateModel<Wgs72Gravity, kVelocity>(tsince, integ, position, velocity);
+    }
 }
 
-Eci SGP4::FindPosition(double tsince) const
+template <class Gravity, bool kVelocity>
+PropagationStatus SGP4::PropagateModel(double tsince,
+                                       IntegratorParams& integ,
+                                       Vector& position,
+                                       Vector& velocity) const noexcept
+{
+    if (use_deep_space_)
+    {
+        return FindPositionSDP4<Gravity, kVelocity>(tsince, integ, position, velocity);
+    }
+    else
+    {
+        return FindPositionSGP4<Gravity, kVelocity>(tsince, position, velocity);
+    }
+}
+
+Eci SGP4::FindPosition(double tsince, IntegratorParams& integ) const
+{
+    Vector position;
+    Vector velocity;
+
+    FindPosition(tsince, integ, position, velocity);
+
+    return Eci(elements_.Epoch().AddMinutes(tsince), position, velocity);
+}
+
+SGP4::IntegratorParams& SGP4::ThreadIntegratorParams() const
+{
+    /*
+     * small direct mapped cache of integrator states per thread. a slot
+     * taken by another satellite only costs a restart from epoch
+     */
+    struct Slot
+    {
+        uint64_t instance_id;
+        IntegratorParams integ;
+    };
+    static const size_t kSlots = 256;
+    thread_local Slot slots[kSlots] = {};
+
+    Slot& slot = slots[instance_id_ % kSlots];
+    if (slot.instance_id != instance_id_)
+    {
+        slot.instance_id = instance_id_;
+        slot.integ = IntegratorParams();
+    }
+
+    return slot.integ;
+}
+
+void SGP4::FindPositions(const double* tsince,
+                         size_t n,
+                         double* x,
+                         double* y,
+                         double* z,
+                         double* xdot,
+                         double* ydot,
+                         double* zdot) const
+{
+    PropagateSeries<true>([tsince](size_t i) { return tsince[i]; },
+                          n, x, y, z, xdot, ydot, zdot, nullptr);
+}
+
+void SGP4::FindPositions(const double* tsince,
+                         size_t n,
+                         double* x,
+                         double* y,
+                         double* z,
+                         double* xdot,
+                         double* ydot,
+                         double* zdot,
+                         PropagationStatus* status) const noexcept
+{
+    PropagateSeries<true>([tsince](size_t i) { return tsince[i]; },
+                          n, x, y, z, xdot, ydot, zdot, status);
+}
+
+void SGP4::FindPositions(const double* tsince,
+                         size_t n,
+                         double* x,
+                         double* y,
+                         double* z,
+                         PropagationStatus* status) const noexcept
+{
+    PropagateSeries<false>([tsince](size_t i) { return tsince[i]; },
+                           n, x, y, z, nullptr, nullptr, nullptr, status);
+}
+
+void SGP4::FindPositions(double start,
+                         double step,
+                         size_t n,
+                         double* x,
+                         double* y,
+                         double* z,
+                         double* xdot,
+                         double* ydot,
+                         double* zdot) const
+{
+    /*
+     * multiply rather than accumulate so long grids dont drift
+     */
+    PropagateSeries<true>([start, step](size_t i) { return start + step * static_cast<double>(i); },
+                          n, x, y, z, xdot, ydot, zdot, nullptr);
+}
+
+template <bool kVelocity, class Time>
+void SGP4::PropagateSeries(Time time,
+                           size_t n,
+                           double* x,
+                           double* y,
+                           double* z,
+                           double* xdot,
+                           double* ydot,
+                           double* zdot,
+                           PropagationStatus* status) const
+{
+    switch (elements_.Gravity())
+    {
+    case GRAVITY_WGS72_OLD:
+        PropagateSeries<Wgs72OldGravity, kVelocity>(time, n, x, y, z, xdot, ydot, zdot, status);
+        break;
+    case GRAVITY_WGS84:
+        PropagateSeries<Wgs84Gravity, kVelocity>(time, n, x, y, z, xdot, ydot, zdot, status);
+        break;
+    default:
+        PropagateSeries<Wgs72Gravity, kVelocity>(time, n, x, y, z, xdot, ydot, zdot, status);
+        break;
+    }
+}
+
+template <class Gravity, bool kVelocity, class Time>
+void SGP4::PropagateSeries(Time time,
+                           size_t n,
+                           double* x,
+                           double* y,
+                           double* z,
+                           double* xdot,
+                           double* ydot,
+                           double* zdot,
+                           PropagationStatus* status) const
 {
+    Vector position;
+    Vector velocity;
+
+    auto store = [&](size_t i, double tsince, PropagationStatus result)
+    {
+        if (status)
+        {
+            status[i] = result;
+        }
+        else if (result != PROPAGATION_OK)
+        {
+            ThrowStatus(result, elements_.Epoch().AddMinutes(tsince), position, velocity);
+        }
+
+        x[i] = position.x;
+        y[i] = position.y;
+        z[i] = position.z;
+        if (kVelocity)
+        {
+            xdot[i] = velocity.x;
+            ydot[i] = velocity.y;
+            zdot[i] = velocity.z;
+        }
+    };
+
     if (use_deep_space_)
     {
-        return FindPositionSDP4(tsince);
+        IntegratorParams integ;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            const double tsince = time(i);
+            store(i, tsince, FindPositionSDP4<Gravity, kVelocity>(tsince, integ, position, velocity));
+        }
     }
     else
     {
-        return FindPositionSGP4(tsince);
+        /*
+         * the elements do not change with time, so are gathered once
+         */
+        const SGP4Kernel<double>::Elements elements = KernelElements();
+
+        for (size_t i = 0; i < n; i++)
+        {
+            const double tsince = time(i);
+            double pos[3];
+            double vel[3];
+
+            const PropagationStatus result =
+                SGP4Kernel<double>::Propagate<Gravity, kVelocity>(elements,
+                                                                  use_simple_model_,
+                                                                  common_consts_,
+                                                                  nearspace_consts_,
+                                                                  tsince,
+                                                                  pos,
+                                                                  vel);
+            store(i, tsince, StoreState<kVelocity>(result, pos, vel, position, velocity));
+        }
     }
 }
 
-Eci SGP4::FindPositionSDP4(double tsince) const
+void SGP4::FindPosition(double tsince,
+                        IntegratorParams& integ,
+                        Vector& position,
+                        Vector& velocity) const
+{
+    const PropagationStatus status = TryFindPosition(tsince, integ, position, velocity);
+
+    if (status != PROPAGATION_OK)
+    {
+        /*
+         * only build the date when it is actually needed
+         */
+        ThrowStatus(status, elements_.Epoch().AddMinutes(tsince), position, velocity);
+    }
+}
+
+void SGP4::ThrowStatus(PropagationStatus status,
+                       const DateTime& date,
+                       const Vector& position,
+                       const Vector& velocity)
+{
+    switch (status)
+    {
+    case PROPAGATION_MEAN_MOTION:
+        throw SatelliteException("Error: (xn <= 0.0)");
+    case PROPAGATION_ECCENTRICITY:
+        throw SatelliteException("Error: (e <= -0.001)");
+    case PROPAGATION_ELSQ:
+        throw SatelliteException("Error: (elsq >= 1.0)");
+    case PROPAGATION_SEMI_LATUS:
+        throw SatelliteException("Error: (pl < 0.0)");
+    case PROPAGATION_DECAYED:
+        throw DecayedException(date, position, velocity);
+    default:
+        break;
+    }
+}
+
+template <class Gravity, bool kVelocity>
+PropagationStatus SGP4::FindPositionSDP4(double tsince,
+                                         IntegratorParams& integ,
+                                         Vector& position,
+                                         Vector& velocity) const noexcept
 {
     /*
      * the final values
@@ -265,8 +785,8 @@ Eci SGP4::FindPositionSDP4(double tsince) const
     DeepSpaceSecular(tsince,
                      elements_,
                      common_consts_,
-                     deepspace_consts_,
-                     integrator_params_,
+                     *deepspace_consts_,
+                     integ,
                      xmdf,
                      omgadf,
                      xnode,
@@ -276,15 +796,15 @@ Eci SGP4::FindPositionSDP4(double tsince) const
 
     if (xn <= 0.0)
     {
-        throw SatelliteException("Error: (xn <= 0.0)");
+        return PROPAGATION_MEAN_MOTION;
     }
 
-    a = pow(kXKE / xn, kTWOTHIRD) * tempa * tempa;
+    a = PowTwoThirds(Gravity::kXKE / xn) * tempa * tempa;
     e = em - tempe;
     double xmam = xmdf + elements_.RecoveredMeanMotion() * templ;
 
     DeepSpacePeriodics(tsince,
-                       deepspace_consts_,
+                       *deepspace_consts_,
                        e,
                        xinc,
                        omgadf,
@@ -310,7 +830,7 @@ Eci SGP4::FindPositionSDP4(double tsince) const
      */
     if (e <= -0.001)
     {
-        throw SatelliteException("Error: (e <= -0.001)");
+        return PROPAGATION_ECCENTRICITY;
     }
     else if (e < 1.0e-6)
     {
@@ -331,338 +851,80 @@ Eci SGP4::FindPositionSDP4(double tsince) const
     double perturbed_x7thm1;
     double perturbed_xlcof;
     double perturbed_aycof;
-    RecomputeConstants(xinc,
-                       perturbed_sinio,
-                       perturbed_cosio,
-                       perturbed_x3thm1,
-                       perturbed_x1mth2,
-                       perturbed_x7thm1,
-                       perturbed_xlcof,
-                       perturbed_aycof);
+    SGP4Kernel<double>::RecomputeConstants<Gravity>(xinc,
+                                                    perturbed_sinio,
+                                                    perturbed_cosio,
+                                                    perturbed_x3thm1,
+                                                    perturbed_x1mth2,
+                                                    perturbed_x7thm1,
+                                                    perturbed_xlcof,
+                                                    perturbed_aycof);
 
     /*
      * using calculated values, find position and velocity
      */
-    return CalculateFinalPositionVelocity(elements_.Epoch().AddMinutes(tsince),
-                                          e,
-                                          a,
-                                          omega,
-                                          xl,
-                                          xnode,
-                                          xinc,
-                                          perturbed_xlcof,
-                                          perturbed_aycof,
-                                          perturbed_x3thm1,
-                                          perturbed_x1mth2,
-                                          perturbed_x7thm1,
-                                          perturbed_cosio,
-                                          perturbed_sinio);
-}
-
-void SGP4::RecomputeConstants(const double xinc,
-                              double& sinio,
-                              double& cosio,
-                              double& x3thm1,
-                              double& x1mth2,
-                              double& x7thm1,
-                              double& xlcof,
-                              double& aycof)
-{
-    sinio = sin(xinc);
-    cosio = cos(xinc);
-
-    const double theta2 = cosio * cosio;
-
-    x3thm1 = 3.0 * theta2 - 1.0;
-    x1mth2 = 1.0 - theta2;
-    x7thm1 = 7.0 * theta2 - 1.0;
-
-    if (fabs(cosio + 1.0) > 1.5e-12)
-    {
-        xlcof = 0.125 * kA3OVK2 * sinio * (3.0 + 5.0 * cosio) / (1.0 + cosio);
-    }
-    else
-    {
-        xlcof = 0.125 * kA3OVK2 * sinio * (3.0 + 5.0 * cosio) / 1.5e-12;
-    }
-
-    aycof = 0.25 * kA3OVK2 * sinio;
+    double sinomg;
+    double cosomg;
+    SinCos(omega, sinomg, cosomg);
+
+    double pos[3];
+    double vel[3];
+
+    const PropagationStatus status =
+        SGP4Kernel<double>::FinalPositionVelocity<Gravity, kVelocity>(e,
+                                                                      a,
+                                                                      sinomg,
+                                                                      cosomg,
+                                                                      xl,
+                                                                      xnode,
+                                                                      xinc,
+                                                                      perturbed_xlcof,
+                                                                      perturbed_aycof,
+                                                                      perturbed_x3thm1,
+                                                                      perturbed_x1mth2,
+                                                                      perturbed_x7thm1,
+                                                                      perturbed_cosio,
+                                                                      perturbed_sinio,
+                                                                      pos,
+                                                                      vel);
+
+    return StoreState<kVelocity>(status, pos, vel, position, velocity);
 }
 
-Eci SGP4::FindPositionSGP4(double tsince) const
+template <class Gravity, bool kVelocity>
+PropagationStatus SGP4::FindPositionSGP4(double tsince,
+                                         Vector& position,
+                                         Vector& velocity) const noexcept
 {
-    /*
-     * the final values
-     */
-    double e;
-    double a;
-    double omega;
-    double xl;
-    double xnode;
-    const double xinc = elements_.Inclination();
-
-    /*
-     * update for secular gravity and atmospheric drag
-     */
-    const double xmdf = elements_.MeanAnomoly()
-        + common_consts_.xmdot * tsince;
-    const double omgadf = elements_.ArgumentPerigee()
-        + common_consts_.omgdot * tsince;
-    const double xnoddf = elements_.AscendingNode()
-        + common_consts_.xnodot * tsince;
-
-    omega = omgadf;
-    double xmp = xmdf;
-
-    const double tsq = tsince * tsince;
-    xnode = xnoddf + common_consts_.xnodcf * tsq;
-    double tempa = 1.0 - common_consts_.c1 * tsince;
-    double tempe = elements_.BStar() * common_consts_.c4 * tsince;
-    double templ = common_consts_.t2cof * tsq;
-
-    if (!use_simple_model_)
-    {
-        const double delomg = nearspace_consts_.omgcof * tsince;
-        const double delm = nearspace_consts_.xmcof
-            * (pow(1.0 + common_consts_.eta * cos(xmdf), 3.0)
-                    - nearspace_consts_.delmo);
-        const double temp = delomg + delm;
-
-        xmp += temp;
-        omega -= temp;
-
-        const double tcube = tsq * tsince;
-        const double tfour = tsince * tcube;
-
-        tempa = tempa - nearspace_consts_.d2 * tsq - nearspace_consts_.d3
-            * tcube - nearspace_consts_.d4 * tfour;
-        tempe += elements_.BStar() * nearspace_consts_.c5
-            * (sin(xmp) - nearspace_consts_.sinmo);
-        templ += nearspace_consts_.t3cof * tcube + tfour
-            * (nearspace_consts_.t4cof + tsince * nearspace_consts_.t5cof);
-    }
-
-    a = elements_.RecoveredSemiMajorAxis() * tempa * tempa;
-    e = elements_.Eccentricity() - tempe;
-    xl = xmp + omega + xnode + elements_.RecoveredMeanMotion() * templ;
-
-    /*
-     * fix tolerance for error recognition
-     */
-    if (e <= -0.001)
-    {
-        throw SatelliteException("Error: (e <= -0.001)");
-    }
-    else if (e < 1.0e-6)
-    {
-        e = 1.0e-6;
-    }
-    else if (e > (1.0 - 1.0e-6))
-    {
-        e = 1.0 - 1.0e-6;
-    }
-
-    /*
-     * using calculated values, find position and velocity
-     * we can pass in constants from Initialise() as these dont change
-     */
-    return CalculateFinalPositionVelocity(elements_.Epoch().AddMinutes(tsince),
-                                          e,
-                                          a,
-                                          omega,
-                                          xl,
-                                          xnode,
-                                          xinc,
-                                          common_consts_.xlcof,
-                                          common_consts_.aycof,
-                                          common_consts_.x3thm1,
-                                          common_consts_.x1mth2,
-                                          common_consts_.x7thm1,
-                                          common_consts_.cosio,
-                                          common_consts_.sinio);
+    double pos[3];
+    double vel[3];
+
+    const PropagationStatus status =
+        SGP4Kernel<double>::Propagate<Gravity, kVelocity>(KernelElements(),
+                                                          use_simple_model_,
+                                                          common_consts_,
+                                                          nearspace_consts_,
+                                                          tsince,
+                                                          pos,
+                                                          vel);
+
+    return StoreState<kVelocity>(status, pos, vel, position, velocity);
 }
 
-Eci SGP4::CalculateFinalPositionVelocity(
-        const DateTime& dt,
-        const double e,
-        const double a,
-        const double omega,
-        const double xl,
-        const double xnode,
-        const double xinc,
-        const double xlcof,
-        const double aycof,
-        const double x3thm1,
-        const double x1mth2,
-        const double x7thm1,
-        const double cosio,
-        const double sinio)
+SGP4Kernel<double>::Elements SGP4::KernelElements() const
 {
-    const double beta2 = 1.0 - e * e;
-    const double xn = kXKE / pow(a, 1.5);
-    /*
-     * long period periodics
-     */
-    const double axn = e * cos(omega);
-    const double temp11 = 1.0 / (a * beta2);
-    const double xll = temp11 * xlcof * axn;
-    const double aynl = temp11 * aycof;
-    const double xlt = xl + xll;
-    const double ayn = e * sin(omega) + aynl;
-    const double elsq = axn * axn + ayn * ayn;
-
-    if (elsq >= 1.0)
-    {
-        throw SatelliteException("Error: (elsq >= 1.0)");
-    }
-
-    /*
-     * solve keplers equation
-     * - solve using Newton-Raphson root solving
-     * - here capu is almost the mean anomoly
-     * - initialise the eccentric anomaly term epw
-     * - The fmod saves reduction of angle to +/-2pi in sin/cos() and prevents
-     * convergence problems.
-     */
-    const double capu = fmod(xlt - xnode, kTWOPI);
-    double epw = capu;
-
-    double sinepw = 0.0;
-    double cosepw = 0.0;
-    double ecose = 0.0;
-    double esine = 0.0;
-
-    /*
-     * sensibility check for N-R correction
-     */
-    const double max_newton_naphson = 1.25 * fabs(sqrt(elsq));
-
-    bool kepler_running = true;
-
-    for (int i = 0; i < 10 && kepler_running; i++)
-    {
-        sinepw = sin(epw);
-        cosepw = cos(epw);
-        ecose = axn * cosepw + ayn * sinepw;
-        esine = axn * sinepw - ayn * cosepw;
-
-        double f = capu - epw + esine;
-
-        if (fabs(f) < 1.0e-12)
-        {
-            kepler_running = false;
-        }
-        else
-        {
-            /*
-             * 1st order Newton-Raphson correction
-             */
-            const double fdot = 1.0 - ecose;
-            double delta_epw = f / fdot;
-
-            /*
-             * 2nd order Newton-Raphson correction.
-             * f / (fdot - 0.5 * d2f * f/fdot)
-             */
-            if (i == 0)
-            {
-                if (delta_epw > max_newton_naphson)
-                {
-                    delta_epw = max_newton_naphson;
-                }
-                else if (delta_epw < -max_newton_naphson)
-                {
-                    delta_epw = -max_newton_naphson;
-                }
-            }
-            else
-            {
-                delta_epw = f / (fdot + 0.5 * esine * delta_epw);
-            }
-
-            /*
-             * Newton-Raphson correction of -F/DF
-             */
-            epw += delta_epw;
-        }
-    }
-    /*
-     * short period preliminary quantities
-     */
-    const double temp21 = 1.0 - elsq;
-    const double pl = a * temp21;
-
-    if (pl < 0.0)
-    {
-        throw SatelliteException("Error: (pl < 0.0)");
-    }
-
-    const double r = a * (1.0 - ecose);
-    const double temp31 = 1.0 / r;
-    const double rdot = kXKE * sqrt(a) * esine * temp31;
-    const double rfdot = kXKE * sqrt(pl) * temp31;
-    const double temp32 = a * temp31;
-    const double betal = sqrt(temp21);
-    const double temp33 = 1.0 / (1.0 + betal);
-    const double cosu = temp32 * (cosepw - axn + ayn * esine * temp33);
-    const double sinu = temp32 * (sinepw - ayn - axn * esine * temp33);
-    const double u = atan2(sinu, cosu);
-    const double sin2u = 2.0 * sinu * cosu;
-    const double cos2u = 2.0 * cosu * cosu - 1.0;
-
-    /*
-     * update for short periodics
-     */
-    const double temp41 = 1.0 / pl;
-    const double temp42 = kCK2 * temp41;
-    const double temp43 = temp42 * temp41;
-
-    const double rk = r * (1.0 - 1.5 * temp43 * betal * x3thm1)
-        + 0.5 * temp42 * x1mth2 * cos2u;
-    const double uk = u - 0.25 * temp43 * x7thm1 * sin2u;
-    const double xnodek = xnode + 1.5 * temp43 * cosio * sin2u;
-    const double xinck = xinc + 1.5 * temp43 * cosio * sinio * cos2u;
-    const double rdotk = rdot - xn * temp42 * x1mth2 * sin2u;
-    const double rfdotk = rfdot + xn * temp42 * (x1mth2 * cos2u + 1.5 * x3thm1);
-
-    /*
-     * orientation vectors
-     */
-    const double sinuk = sin(uk);
-    const double cosuk = cos(uk);
-    const double sinik = sin(xinck);
-    const double cosik = cos(xinck);
-    const double sinnok = sin(xnodek);
-    const double cosnok = cos(xnodek);
-    const double xmx = -sinnok * cosik;
-    const double xmy = cosnok * cosik;
-    const double ux = xmx * sinuk + cosnok * cosuk;
-    const double uy = xmy * sinuk + sinnok * cosuk;
-    const double uz = sinik * sinuk;
-    const double vx = xmx * cosuk - cosnok * sinuk;
-    const double vy = xmy * cosuk - sinnok * sinuk;
-    const double vz = sinik * cosuk;
-    /*
-     * position and velocity
-     */
-    const double x = rk * ux * kXKMPER;
-    const double y = rk * uy * kXKMPER;
-    const double z = rk * uz * kXKMPER;
-    Vector position(x, y, z);
-    const double xdot = (rdotk * ux + rfdotk * vx) * kXKMPER / 60.0;
-    const double ydot = (rdotk * uy + rfdotk * vy) * kXKMPER / 60.0;
-    const double zdot = (rdotk * uz + rfdotk * vz) * kXKMPER / 60.0;
-    Vector velocity(xdot, ydot, zdot);
-
-    if (rk < 1.0)
-    {
-        throw DecayedException(
-                dt,
-                position,
-                velocity);
-    }
-
-    return Eci(dt, position, velocity);
+    SGP4Kernel<double>::Elements elements;
+    elements.mean_anomaly = elements_.MeanAnomoly();
+    elements.ascending_node = elements_.AscendingNode();
+    elements.argument_perigee = elements_.ArgumentPerigee();
+    elements.eccentricity = elements_.Eccentricity();
+    elements.inclination = elements_.Inclination();
+    elements.mean_motion = elements_.MeanMotion();
+    elements.bstar = elements_.BStar();
+    elements.recovered_semi_major_axis = elements_.RecoveredSemiMajorAxis();
+    elements.recovered_mean_motion = elements_.RecoveredMeanMotion();
+
+    return elements;
 }
 
 static inline double EvaluateCubicPolynomial(
@@ -734,7 +996,7 @@ void SGP4::DeepSpaceInitialise(
     const double zcoshl = sqrt(1.0 - zsinhl * zsinhl);
     const double c = 4.7199672 + 0.22997150 * jday;
     const double gam = 5.8351514 + 0.0019443680 * jday;
-    deepspace_consts_.zmol = Util::WrapTwoPI(c - gam);
+    deepspace_consts_->zmol = Util::WrapTwoPI(c - gam);
     double zx = 0.39785416 * stem / zsinil;
     double zy = zcoshl * ctem + 0.91744867 * zsinhl * stem;
     zx = atan2(zx, zy);
@@ -742,7 +1004,7 @@ void SGP4::DeepSpaceInitialise(
 
     const double zcosgl = cos(zx);
     const double zsingl = sin(zx);
-    deepspace_consts_.zmos = Util::WrapTwoPI(6.2565837 + 0.017201977 * jday);
+    deepspace_consts_->zmos = Util::WrapTwoPI(6.2565837 + 0.017201977 * jday);
 
     /*
      * do solar terms
@@ -834,18 +1096,18 @@ void SGP4::DeepSpaceInitialise(
             shdq = (-zn * s2 * (z21 + z23)) / sinio;
         }
 
-        deepspace_consts_.ee2 = 2.0 * s1 * s6;
-        deepspace_consts_.e3 = 2.0 * s1 * s7;
-        deepspace_consts_.xi2 = 2.0 * s2 * z12;
-        deepspace_consts_.xi3 = 2.0 * s2 * (z13 - z11);
-        deepspace_consts_.xl2 = -2.0 * s3 * z2;
-        deepspace_consts_.xl3 = -2.0 * s3 * (z3 - z1);
-        deepspace_consts_.xl4 = -2.0 * s3 * (-21.0 - 9.0 * eosq) * ze;
-        deepspace_consts_.xgh2 = 2.0 * s4 * z32;
-        deepspace_consts_.xgh3 = 2.0 * s4 * (z33 - z31);
-        deepspace_consts_.xgh4 = -18.0 * s4 * ze;
-        deepspace_consts_.xh2 = -2.0 * s2 * z22;
-        deepspace_consts_.xh3 = -2.0 * s2 * (z23 - z21);
+        deepspace_consts_->ee2 = 2.0 * s1 * s6;
+        deepspace_consts_->e3 = 2.0 * s1 * s7;
+        deepspace_consts_->xi2 = 2.0 * s2 * z12;
+        deepspace_consts_->xi3 = 2.0 * s2 * (z13 - z11);
+        deepspace_consts_->xl2 = -2.0 * s3 * z2;
+        deepspace_consts_->xl3 = -2.0 * s3 * (z3 - z1);
+        deepspace_consts_->xl4 = -2.0 * s3 * (-21.0 - 9.0 * eosq) * ze;
+        deepspace_consts_->xgh2 = 2.0 * s4 * z32;
+        deepspace_consts_->xgh3 = 2.0 * s4 * (z33 - z31);
+        deepspace_consts_->xgh4 = -18.0 * s4 * ze;
+        deepspace_consts_->xh2 = -2.0 * s2 * z22;
+        deepspace_consts_->xh3 = -2.0 * s2 * (z23 - z21);
 
         if (cnt == 1)
         {
@@ -854,23 +1116,23 @@ void SGP4::DeepSpaceInitialise(
         /*
          * do lunar terms
          */
-        deepspace_consts_.sse = se;
-        deepspace_consts_.ssi = si;
-        deepspace_consts_.ssl = sl;
-        deepspace_consts_.ssh = shdq;
-        deepspace_consts_.ssg = sgh - cosio * deepspace_consts_.ssh;
-        deepspace_consts_.se2 = deepspace_consts_.ee2;
-        deepspace_consts_.si2 = deepspace_consts_.xi2;
-        deepspace_consts_.sl2 = deepspace_consts_.xl2;
-        deepspace_consts_.sgh2 = deepspace_consts_.xgh2;
-        deepspace_consts_.sh2 = deepspace_consts_.xh2;
-        deepspace_consts_.se3 = deepspace_consts_.e3;
-        deepspace_consts_.si3 = deepspace_consts_.xi3;
-        deepspace_consts_.sl3 = deepspace_consts_.xl3;
-        deepspace_consts_.sgh3 = deepspace_consts_.xgh3;
-        deepspace_consts_.sh3 = deepspace_consts_.xh3;
-        deepspace_consts_.sl4 = deepspace_consts_.xl4;
-        deepspace_consts_.sgh4 = deepspace_consts_.xgh4;
+        deepspace_consts_->sse = se;
+        deepspace_consts_->ssi = si;
+        deepspace_consts_->ssl = sl;
+        deepspace_consts_->ssh = shdq;
+        deepspace_consts_->ssg = sgh - cosio * deepspace_consts_->ssh;
+        deepspace_consts_->se2 = deepspace_consts_->ee2;
+        deepspace_consts_->si2 = deepspace_consts_->xi2;
+        deepspace_consts_->sl2 = deepspace_consts_->xl2;
+        deepspace_consts_->sgh2 = deepspace_consts_->xgh2;
+        deepspace_consts_->sh2 = deepspace_consts_->xh2;
+        deepspace_consts_->se3 = deepspace_consts_->e3;
+        deepspace_consts_->si3 = deepspace_consts_->xi3;
+        deepspace_consts_->sl3 = deepspace_consts_->xl3;
+        deepspace_consts_->sgh3 = deepspace_consts_->xgh3;
+        deepspace_consts_->sh3 = deepspace_consts_->xh3;
+        deepspace_consts_->sl4 = deepspace_consts_->xl4;
+        deepspace_consts_->sgh4 = deepspace_consts_->xgh4;
         zcosg = zcosgl;
         zsing = zsingl;
         zcosi = zcosil;
@@ -882,13 +1144,13 @@ void SGP4::DeepSpaceInitialise(
         ze = ZEL;
     }
 
-    deepspace_consts_.sse += se;
-    deepspace_consts_.ssi += si;
-    deepspace_consts_.ssl += sl;
-    deepspace_consts_.ssg += sgh - cosio * shdq;
-    deepspace_consts_.ssh += shdq;
+    deepspace_consts_->sse += se;
+    deepspace_consts_->ssi += si;
+    deepspace_consts_->ssl += sl;
+    deepspace_consts_->ssg += sgh - cosio * shdq;
+    deepspace_consts_->ssh += shdq;
 
-    deepspace_consts_.shape = DeepSpaceConstants::NONE;
+    deepspace_consts_->shape = DeepSpaceConstants::NONE;
 
     if (elements_.RecoveredMeanMotion() < 0.0052359877
             && elements_.RecoveredMeanMotion() > 0.0034906585)
@@ -896,7 +1158,7 @@ void SGP4::DeepSpaceInitialise(
         /*
          * 24h synchronous resonance terms initialisation
          */
-        deepspace_consts_.shape = DeepSpaceConstants::SYNCHRONOUS;
+        deepspace_consts_->shape = DeepSpaceConstants::SYNCHRONOUS;
 
         const double g200 = 1.0 + eosq * (-2.5 + 0.8125 * eosq);
         const double g310 = 1.0 + 2.0 * eosq;
@@ -906,24 +1168,24 @@ void SGP4::DeepSpaceInitialise(
             - 0.75 * (1.0 + cosio);
         double f330 = 1.0 + cosio;
         f330 = 1.875 * f330 * f330 * f330;
-        deepspace_consts_.del1 = 3.0 * elements_.RecoveredMeanMotion()
+        deepspace_consts_->del1 = 3.0 * elements_.RecoveredMeanMotion()
             * elements_.RecoveredMeanMotion()
             * aqnv * aqnv;
-        deepspace_consts_.del2 = 2.0 * deepspace_consts_.del1
+        deepspace_consts_->del2 = 2.0 * deepspace_consts_->del1
             * f220 * g200 * Q22;
-        deepspace_consts_.del3 = 3.0 * deepspace_consts_.del1
+        deepspace_consts_->del3 = 3.0 * deepspace_consts_->del1
             * f330 * g300 * Q33 * aqnv;
-        deepspace_consts_.del1 = deepspace_consts_.del1
+        deepspace_consts_->del1 = deepspace_consts_->del1
             * f311 * g310 * Q31 * aqnv;
 
-        deepspace_consts_.xlamo = Util::WrapTwoPI(elements_.MeanAnomoly()
+        deepspace_consts_->xlamo = Util::WrapTwoPI(elements_.MeanAnomoly()
                 + elements_.AscendingNode()
                 + elements_.ArgumentPerigee()
-                - deepspace_consts_.gsto);
+                - deepspace_consts_->gsto);
         bfact = xmdot + xpidot - kTHDT
-            + deepspace_consts_.ssl
-            + deepspace_consts_.ssg
-            + deepspace_consts_.ssh;
+            + deepspace_consts_->ssl
+            + deepspace_consts_->ssg
+            + deepspace_consts_->ssh;
     }
     else if (elements_.RecoveredMeanMotion() < 8.26e-3
             || elements_.RecoveredMeanMotion() > 9.24e-3
@@ -936,7 +1198,7 @@ void SGP4::DeepSpaceInitialise(
         /*
          * geopotential resonance initialisation for 12 hour orbits
          */
-        deepspace_consts_.shape = DeepSpaceConstants::RESONANCE;
+        deepspace_consts_->shape = DeepSpaceConstants::RESONANCE;
 
         double g211;
         double g310;
@@ -1034,51 +1296,48 @@ void SGP4::DeepSpaceInitialise(
 
         double temp1 = 3.0 * xno2 * ainv2;
         double temp = temp1 * ROOT22;
-        deepspace_consts_.d2201 = temp * f220 * g201;
-        deepspace_consts_.d2211 = temp * f221 * g211;
+        deepspace_consts_->d2201 = temp * f220 * g201;
+        deepspace_consts_->d2211 = temp * f221 * g211;
 
         temp1 *= aqnv;
         temp = temp1 * ROOT32;
-        deepspace_consts_.d3210 = temp * f321 * g310;
-        deepspace_consts_.d3222 = temp * f322 * g322;
+        deepspace_consts_->d3210 = temp * f321 * g310;
+        deepspace_consts_->d3222 = temp * f322 * g322;
 
         temp1 *= aqnv;
         temp = 2.0 * temp1 * ROOT44;
-        deepspace_consts_.d4410 = temp * f441 * g410;
-        deepspace_consts_.d4422 = temp * f442 * g422;
+        deepspace_consts_->d4410 = temp * f441 * g410;
+        deepspace_consts_->d4422 = temp * f442 * g422;
 
         temp1 *= aqnv;
         temp = temp1 * ROOT52;
-        deepspace_consts_.d5220 = temp * f522 * g520;
-        deepspace_consts_.d5232 = temp * f523 * g532;
+        deepspace_consts_->d5220 = temp * f522 * g520;
+        deepspace_consts_->d5232 = temp * f523 * g532;
 
         temp = 2.0 * temp1 * ROOT54;
-        deepspace_consts_.d5421 = temp * f542 * g521;
-        deepspace_consts_.d5433 = temp * f543 * g533;
+        deepspace_consts_->d5421 = temp * f542 * g521;
+        deepspace_consts_->d5433 = temp * f543 * g533;
 
-        deepspace_consts_.xlamo = Util::WrapTwoPI(
+        deepspace_consts_->xlamo = Util::WrapTwoPI(
                 elements_.MeanAnomoly()
                 + elements_.AscendingNode()
                 + elements_.AscendingNode()
-                - deepspace_consts_.gsto
-                - deepspace_consts_.gsto);
+                - deepspace_consts_->gsto
+                - deepspace_consts_->gsto);
         bfact = xmdot
             + xnodot + xnodot
             - kTHDT - kTHDT
-            + deepspace_consts_.ssl
-            + deepspace_consts_.ssh
-            + deepspace_consts_.ssh;
+            + deepspace_consts_->ssl
+            + deepspace_consts_->ssh
+            + deepspace_consts_->ssh;
     }
 
-    if (deepspace_consts_.shape != DeepSpaceConstants::NONE)
+    if (deepspace_consts_->shape != DeepSpaceConstants::NONE)
     {
         /*
          * initialise integrator
          */
-        deepspace_consts_.xfact = bfact - elements_.RecoveredMeanMotion();
-        integrator_params_.atime = 0.0;
-        integrator_params_.xni = elements_.RecoveredMeanMotion();
-        integrator_params_.xli = deepspace_consts_.xlamo;
+        deepspace_consts_->xfact = bfact - elements_.RecoveredMeanMotion();
     }
 }
 
@@ -1231,9 +1490,6 @@ void SGP4::DeepSpaceSecular(
     static const double FASX4 = 2.8843198;
     static const double FASX6 = 0.37448087;
 
-    static const double STEP = 720.0;
-    static const double STEP2 = 259200.0;
-
     xll += ds_constants.ssl * tsince;
     omgasm += ds_constants.ssg * tsince;
     xnodes += ds_constants.ssh * tsince;
@@ -1257,6 +1513,7 @@ void SGP4::DeepSpaceSecular(
             fabs(tsince) < fabs(integ_params.atime))
         {
             // restart back at the epoch
+            CSGP4_STATS_INC(INTEGRATOR_RESTARTS);
             integ_params.atime = 0.0;
             // TODO: check
             integ_params.xni = elements.RecoveredMeanMotion();
@@ -1264,6 +1521,37 @@ void SGP4::DeepSpaceSecular(
             integ_params.xli = ds_constants.xlamo;
         }
 
+        const IntegratorCheckpoints& checkpoints = ds_constants.checkpoints;
+
+        if (!checkpoints.states.empty())
+        {
+            /*
+             * find the step the integrator would stop at for tsince, that
+             * is the last multiple of STEP between epoch and tsince
+             */
+            double k = trunc(tsince / STEP);
+            if (fabs(k * STEP) > fabs(tsince))
+            {
+                k -= (tsince >= 0.0 ? 1.0 : -1.0);
+            }
+            else if (fabs(tsince - k * STEP) >= STEP)
+            {
+                k += (tsince >= 0.0 ? 1.0 : -1.0);
+            }
+
+            /*
+             * jump straight there if it is covered and ahead of atime
+             */
+            const double index = k - checkpoints.first;
+            if (index >= 0.0
+                    && index < static_cast<double>(checkpoints.states.size())
+                    && fabs(k * STEP) > fabs(integ_params.atime))
+            {
+                integ_params = checkpoints.states[static_cast<size_t>(index)];
+                CSGP4_STATS_INC(INTEGRATOR_CHECKPOINTS);
+            }
+        }
+
         bool running = true;
         while (running)
         {
@@ -1317,6 +1605,7 @@ void SGP4::DeepSpaceSecular(
                 integ_params.xli = integ_params.xli + xldot * delt + xndot * STEP2;
                 integ_params.xni = integ_params.xni + xndot * delt + xnddt * STEP2;
                 integ_params.atime += delt;
+                CSGP4_STATS_INC(INTEGRATOR_STEPS);
             }
             else
             {
@@ -1341,6 +1630,68 @@ void SGP4::DeepSpaceSecular(
     }
 }
 
+void SGP4::BuildIntegratorCheckpoints(double start, double end)
+{
+    ClearIntegratorCheckpoints();
+
+    if (!use_deep_space_ || deepspace_consts_->shape == DeepSpaceConstants::NONE)
+    {
+        return;
+    }
+
+    const int first = static_cast<int>(floor(std::min(start, end) / STEP));
+    const int last = static_cast<int>(ceil(std::max(start, end) / STEP));
+    const int low = std::min(first, 0);
+    const int high = std::max(last, 0);
+
+    /*
+     * run the integrator out from epoch in each direction, so every
+     * state is exactly the one an uninterrupted run would reach
+     */
+    std::vector<IntegratorParams> states(static_cast<size_t>(high - low + 1));
+    for (int direction = -1; direction <= 1; direction += 2)
+    {
+        IntegratorParams integ;
+        const int limit = direction > 0 ? high : low;
+
+        for (int k = 0; k * direction <= limit * direction; k += direction)
+        {
+            double xll = 0.0;
+            double omgasm = 0.0;
+            double xnodes = 0.0;
+            double em = 0.0;
+            double xinc = 0.0;
+            double xn = 0.0;
+
+            DeepSpaceSecular(k * STEP,
+                             elements_,
+                             common_consts_,
+                             *deepspace_consts_,
+                             integ,
+                             xll,
+                             omgasm,
+                             xnodes,
+                             em,
+                             xinc,
+                             xn);
+
+            states[static_cast<size_t>(k - low)] = integ;
+        }
+    }
+
+    deepspace_consts_->checkpoints.first = low;
+    deepspace_consts_->checkpoints.states.swap(states);
+}
+
+void SGP4::ClearIntegratorCheckpoints()
+{
+    if (deepspace_consts_)
+    {
+        deepspace_consts_->checkpoints.first = 0;
+        deepspace_consts_->checkpoints.states.clear();
+    }
+}
+
 void SGP4::Reset()
 {
     use_simple_model_ = false;
@@ -1348,8 +1699,24 @@ void SGP4::Reset()
 
     std::memset(&common_consts_, 0, sizeof(common_consts_));
     std::memset(&nearspace_consts_, 0, sizeof(nearspace_consts_));
-    std::memset(&deepspace_consts_, 0, sizeof(deepspace_consts_));
-    std::memset(&integrator_params_, 0, sizeof(integrator_params_));
+
+    /*
+     * a new id so any cached integrator state is discarded
+     */
+    static std::atomic<uint64_t> next_instance_id(1);
+    instance_id_ = next_instance_id++;
 }
 
+/*
+ * both forms are used by SGP4Batch for its deep space queue
+ */
+template PropagationStatus SGP4::Propagate<true>(double tsince,
+                                                 IntegratorParams& integ,
+                                                 Vector& position,
+                                                 Vector& velocity) const noexcept;
+template PropagationStatus SGP4::Propagate<false>(double tsince,
+                                                  IntegratorParams& integ,
+                                                  Vector& position,
+                                                  Vector& velocity) const noexcept;
+
 }; // end namespace csgp4
@@ -0,0 +1,471 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csgp4/SGP4Batch.h"
+#include "csgp4/SGP4BatchFloat.h"
+
+#include "csgp4/Globals.h"
+#include "csgp4/Simd.h"
+
+#include <cmath>
+
+namespace
+{
+    /*
+     * copy one satellite into a lane of a pack, rounding to the lane type
+     */
+    template <class T>
+    struct ScatterLane
+    {
+        size_t lane;
+
+        template <class P>
+        void operator()(const double& from, P& to) const
+        {
+            to[lane] = static_cast<T>(from);
+        }
+    };
+
+    /*
+     * copy one lane of a pack into the only lane of another
+     */
+    struct GatherLane
+    {
+        size_t lane;
+
+        template <class P, class Q>
+        void operator()(const P& from, Q& to) const
+        {
+            to[0] = from[lane];
+        }
+    };
+}
+
+namespace csgp4
+{
+
+template <class T>
+template <class Gravity, bool kVelocity, size_t N>
+PropagationStatus BasicSGP4Batch<T>::PropagateBlock(const Block<N>& block,
+                                                    const double* tsince,
+                                                    T* out)
+{
+    typedef Pack<T, N> Lanes;
+
+    Lanes position[3];
+    Lanes velocity[3];
+
+    const PropagationStatus status =
+        block.secular.template Propagate<Gravity, kVelocity>(block,
+                                                             tsince,
+                                                             position,
+                                                             velocity);
+
+    for (size_t k = 0; k < 3; k++)
+    {
+        for (size_t l = 0; l < N; l++)
+        {
+            out[k * N + l] = position[k][l];
+            if (kVelocity)
+            {
+                out[(k + 3) * N + l] = velocity[k][l];
+            }
+        }
+    }
+
+    return status;
+}
+
+template <class T>
+struct BasicSGP4Batch<T>::Entry
+{
+    typedef PropagationStatus (*Function)(const Block<kLanes>& block,
+                                          const double* tsince,
+                                          T* out);
+
+    /*
+     * each entry point is cloned with its own copy of the kernel
+     * compiled for the instruction set
+     */
+#define CSGP4_NEAR_SPACE_BLOCK(name, gravity, velocity) \
+    CSGP4_SIMD_CLONES CSGP4_FLATTEN \
+    static PropagationStatus name(const Block<kLanes>& block, \
+                                  const double* tsince, \
+                                  T* out) \
+    { \
+        return PropagateBlock<gravity, velocity>(block, tsince, out); \
+    }
+
+    CSGP4_NEAR_SPACE_BLOCK(Wgs72Old, Wgs72OldGravity, true)
+    CSGP4_NEAR_SPACE_BLOCK(Wgs72, Wgs72Gravity, true)
+    CSGP4_NEAR_SPACE_BLOCK(Wgs84, Wgs84Gravity, true)
+    CSGP4_NEAR_SPACE_BLOCK(Wgs72OldPosition, Wgs72OldGravity, false)
+    CSGP4_NEAR_SPACE_BLOCK(Wgs72Position, Wgs72Gravity, false)
+    CSGP4_NEAR_SPACE_BLOCK(Wgs84Position, Wgs84Gravity, false)
+#undef CSGP4_NEAR_SPACE_BLOCK
+
+    static Function SelectBlock(const GravityModel model, const bool velocity)
+    {
+        switch (model)
+        {
+        case GRAVITY_WGS72_OLD:
+            return velocity ? Wgs72Old : Wgs72OldPosition;
+        case GRAVITY_WGS84:
+            return velocity ? Wgs84 : Wgs84Position;
+        default:
+            return velocity ? Wgs72 : Wgs72Position;
+        }
+    }
+};
+
+template <class T>
+BasicSGP4Batch<T>::BasicSGP4Batch(const std::vector<Tle>& tles, GravityModel model)
+{
+    std::vector<SGP4> models;
+    models.reserve(tles.size());
+
+    for (const auto& tle : tles)
+    {
+        models.emplace_back(tle, model);
+    }
+
+    Build(models);
+}
+
+template <class T>
+BasicSGP4Batch<T>::BasicSGP4Batch(const std::vector<SGP4>& models)
+{
+    Build(models);
+}
+
+template <class T>
+size_t BasicSGP4Batch<T>::MemoryUsage() const
+{
+    size_t bytes = sizeof(*this);
+
+    bytes += blocks_.capacity() * sizeof(Block<kLanes>);
+    bytes += deep_index_.capacity() * sizeof(size_t);
+    bytes += epochs_.capacity() * sizeof(DateTime);
+    bytes += (deep_.capacity() - deep_.size()) * sizeof(SGP4);
+
+    for (const auto& model : deep_)
+    {
+        bytes += model.MemoryUsage();
+    }
+
+    return bytes;
+}
+
+template <class T>
+void BasicSGP4Batch<T>::Build(const std::vector<SGP4>& models)
+{
+    typedef typename Block<kLanes>::Kernel Kernel;
+
+    size_ = models.size();
+    near_count_ = 0;
+    blocks_.clear();
+    deep_.clear();
+    deep_index_.clear();
+    epochs_.clear();
+
+    /*
+     * the kernel is built per gravity model, so the batch takes the
+     * model of the first satellite
+     */
+    gravity_ = models.empty() ? GRAVITY_WGS72 : models.front().Gravity();
+
+    /*
+     * a block shares one simple model flag, so the near space
+     * satellites are split by it and each part padded to whole blocks
+     */
+    std::vector<size_t> near_index[2];
+
+    for (size_t i = 0; i < models.size(); i++)
+    {
+        epochs_.push_back(models[i].elements_.Epoch());
+
+        if (models[i].use_deep_space_ || models[i].Gravity() != gravity_)
+        {
+            deep_.push_back(models[i]);
+            deep_index_.push_back(i);
+        }
+        else
+        {
+            near_index[models[i].use_simple_model_ ? 1 : 0].push_back(i);
+            near_count_++;
+        }
+    }
+
+    for (const std::vector<size_t>& indices : near_index)
+    {
+        for (size_t base = 0; base < indices.size(); base += kLanes)
+        {
+            blocks_.emplace_back();
+            Block<kLanes>& block = blocks_.back();
+
+            block.count = indices.size() - base < kLanes
+                ? indices.size() - base : kLanes;
+
+            for (size_t lane = 0; lane < kLanes; lane++)
+            {
+                const size_t i = indices[base + (lane < block.count ? lane : block.count - 1)];
+                const SGP4& model = models[i];
+                const SGP4Kernel<double>::Elements elements = model.KernelElements();
+                const ScatterLane<T> scatter = {lane};
+
+                Kernel::template ForEachField<double>(elements, block.elements, scatter);
+                Kernel::template ForEachField<double>(model.common_consts_, block.common_consts, scatter);
+                Kernel::template ForEachField<double>(model.nearspace_consts_, block.nearspace_consts, scatter);
+                block.use_simple_model = model.use_simple_model_;
+                block.secular.Scatter(lane, elements, model.common_consts_);
+                block.index[lane] = i;
+            }
+        }
+    }
+}
+
+template <class T>
+void BasicSGP4Batch<T>::FindPositions(const DateTime& date,
+                                      T* x,
+                                      T* y,
+                                      T* z,
+                                      T* xdot,
+                                      T* ydot,
+                                      T* zdot) const
+{
+    std::vector<double> tsince(size_);
+
+    for (size_t i = 0; i < size_; i++)
+    {
+        tsince[i] = (date - epochs_[i]).TotalMinutes();
+    }
+
+    FindPositions(tsince.data(), x, y, z, xdot, ydot, zdot);
+}
+
+template <class T>
+void BasicSGP4Batch<T>::FindPositions(const double* tsince,
+                                      T* x,
+                                      T* y,
+                                      T* z,
+                                      T* xdot,
+                                      T* ydot,
+                                      T* zdot) const
+{
+    std::vector<PropagationStatus> status(size_);
+
+    FindPositions(tsince, x, y, z, xdot, ydot, zdot, status.data());
+
+    /*
+     * raise the first error in satellite order
+     */
+    for (size_t i = 0; i < size_; i++)
+    {
+        if (status[i] != PROPAGATION_OK)
+        {
+            SGP4::ThrowStatus(status[i],
+                              epochs_[i].AddMinutes(tsince[i]),
+                              Vector(x[i], y[i], z[i]),
+                              Vector(xdot[i], ydot[i], zdot[i]));
+        }
+    }
+}
+
+template <class T>
+void BasicSGP4Batch<T>::FindPositions(const DateTime& date,
+                                      T* x,
+                                      T* y,
+                                      T* z,
+                                      T* xdot,
+                                      T* ydot,
+                                      T* zdot,
+                                      PropagationStatus* status) const
+{
+    std::vector<double> tsince(size_);
+
+    for (size_t i = 0; i < size_; i++)
+    {
+        tsince[i] = (date - epochs_[i]).TotalMinutes();
+    }
+
+    FindPositions(tsince.data(), x, y, z, xdot, ydot, zdot, status);
+}
+
+template <class T>
+void BasicSGP4Batch<T>::FindPositions(const double* tsince,
+                                      T* x,
+                                      T* y,
+                                      T* z,
+                                      T* xdot,
+                                      T* ydot,
+                                      T* zdot,
+                                      PropagationStatus* status) const noexcept
+{
+    Propagate<true>(tsince, x, y, z, xdot, ydot, zdot, status);
+}
+
+template <class T>
+void BasicSGP4Batch<T>::FindPositions(const DateTime& date,
+                                      T* x,
+                                      T* y,
+                                      T* z,
+                                      PropagationStatus* status) const
+{
+    std::vector<double> tsince(size_);
+
+    for (size_t i = 0; i < size_; i++)
+    {
+        tsince[i] = (date - epochs_[i]).TotalMinutes();
+    }
+
+    FindPositions(tsince.data(), x, y, z, status);
+}
+
+template <class T>
+void BasicSGP4Batch<T>::FindPositions(const double* tsince,
+                                      T* x,
+                                      T* y,
+                                      T* z,
+                                      PropagationStatus* status) const noexcept
+{
+    Propagate<false>(tsince, x, y, z, nullptr, nullptr, nullptr, status);
+}
+
+template <class T>
+template <bool kVelocity>
+void BasicSGP4Batch<T>::Propagate(const double* tsince,
+                                  T* x,
+                                  T* y,
+                                  T* z,
+                                  T* xdot,
+                                  T* ydot,
+                                  T* zdot,
+                                  PropagationStatus* status) const noexcept
+{
+    switch (gravity_)
+    {
+    case GRAVITY_WGS72_OLD:
+        PropagateNearSpace<Wgs72OldGravity, kVelocity>(tsince, x, y, z, xdot, ydot, zdot, status);
+        break;
+    case GRAVITY_WGS84:
+        PropagateNearSpace<Wgs84Gravity, kVelocity>(tsince, x, y, z, xdot, ydot, zdot, status);
+        break;
+    default:
+        PropagateNearSpace<Wgs72Gravity, kVelocity>(tsince, x, y, z, xdot, ydot, zdot, status);
+        break;
+    }
+
+    Vector position;
+    Vector velocity;
+
+    for (size_t k = 0; k < deep_.size(); k++)
+    {
+        const size_t i = deep_index_[k];
+
+        status[i] = deep_[k].Propagate<kVelocity>(tsince[i],
+                                                  deep_[k].ThreadIntegratorParams(),
+                                                  position,
+                                                  velocity);
+
+        x[i] = static_cast<T>(position.x);
+        y[i] = static_cast<T>(position.y);
+        z[i] = static_cast<T>(position.z);
+        if (kVelocity)
+        {
+            xdot[i] = static_cast<T>(velocity.x);
+            ydot[i] = static_cast<T>(velocity.y);
+            zdot[i] = static_cast<T>(velocity.z);
+        }
+    }
+}
+
+template <class T>
+template <class Gravity, bool kVelocity>
+void BasicSGP4Batch<T>::PropagateNearSpace(const double* tsince,
+                                           T* x,
+                                           T* y,
+                                           T* z,
+                                           T* xdot,
+                                           T* ydot,
+                                           T* zdot,
+                                           PropagationStatus* status) const noexcept
+{
+    typedef typename Block<1>::Kernel Single;
+
+    const typename Entry::Function propagate = Entry::SelectBlock(gravity_, kVelocity);
+
+    for (const Block<kLanes>& block : blocks_)
+    {
+        double block_tsince[kLanes];
+        T out[6 * kLanes];
+        PropagationStatus block_status[kLanes];
+
+        for (size_t l = 0; l < kLanes; l++)
+        {
+            block_tsince[l] = tsince[block.index[l]];
+            block_status[l] = PROPAGATION_OK;
+        }
+
+        if (propagate(block, block_tsince, out) != PROPAGATION_OK)
+        {
+            /*
+             * some lane failed, redo them one at a time to find which
+             */
+            for (size_t l = 0; l < block.count; l++)
+            {
+                Block<1> lane;
+                const GatherLane gather = {l};
+                T lane_out[6] = {};
+
+                Single::template ForEachField<Pack<T, kLanes> >(block.elements, lane.elements, gather);
+                Single::template ForEachField<Pack<T, kLanes> >(block.common_consts, lane.common_consts, gather);
+                Single::template ForEachField<Pack<T, kLanes> >(block.nearspace_consts, lane.nearspace_consts, gather);
+                lane.use_simple_model = block.use_simple_model;
+                block.secular.Gather(l, lane.secular);
+
+                block_status[l] = PropagateBlock<Gravity, kVelocity>(lane, block_tsince + l, lane_out);
+                for (size_t k = 0; k < 6; k++)
+                {
+                    out[k * kLanes + l] = lane_out[k];
+                }
+            }
+        }
+
+        /*
+         * scatter the results
+         */
+        for (size_t l = 0; l < block.count; l++)
+        {
+            const size_t i = block.index[l];
+
+            x[i] = out[l];
+            y[i] = out[kLanes + l];
+            z[i] = out[2 * kLanes + l];
+            if (kVelocity)
+            {
+                xdot[i] = out[3 * kLanes + l];
+                ydot[i] = out[4 * kLanes + l];
+                zdot[i] = out[5 * kLanes + l];
+            }
+            status[i] = block_status[l];
+        }
+    }
+}
+
+template class BasicSGP4Batch<double>;
+template class BasicSGP4Batch<float>;
+
+}; // end namespace csgp4
@@ -0,0 +1,179 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "csgp4/SGP4Catalog.h"
+
+#include "csgp4/SatelliteException.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace csgp4
+{
+
+SGP4Catalog::UpdateResult SGP4Catalog::Update(const std::vector<Tle>& tles,
+                                              unsigned int threads)
+{
+    UpdateResult result;
+
+    /*
+     * sort the input into unchanged, changed and new. changed entries
+     * are staged in tles_ straight away, keeping the old element set in
+     * case the new one fails
+     */
+    std::vector<size_t> changed;
+    std::vector<Tle> previous;
+    std::vector<char> staged(models_.size(), 0);
+
+    for (const auto& tle : tles)
+    {
+        auto found = index_.find(tle.NoradNumber());
+
+        if (found == index_.end())
+        {
+            try
+            {
+                models_.emplace_back(tle, gravity_);
+            }
+            catch (const SatelliteException&)
+            {
+                result.failed++;
+                continue;
+            }
+            tles_.push_back(tle);
+            index_[tle.NoradNumber()] = models_.size() - 1;
+            staged.push_back(0);
+            result.added++;
+        }
+        else if (SameElements(tles_[found->second], tle))
+        {
+            result.unchanged++;
+        }
+        else if (staged[found->second])
+        {
+            /*
+             * repeated in the input, the last one wins
+             */
+            tles_[found->second] = tle;
+        }
+        else
+        {
+            staged[found->second] = 1;
+            changed.push_back(found->second);
+            previous.push_back(tles_[found->second]);
+            tles_[found->second] = tle;
+        }
+    }
+
+    /*
+     * re-initialise the changed ones. each worker takes the next entry,
+     * and every entry is touched by exactly one worker
+     */
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned int>(
+            std::min<size_t>(threads, changed.size()));
+
+    std::vector<char> ok(changed.size(), 1);
+    std::atomic<size_t> next(0);
+
+    auto worker = [&]()
+    {
+        for (size_t k = next++; k < changed.size(); k = next++)
+        {
+            const size_t i = changed[k];
+
+            try
+            {
+                models_[i].SetTle(tles_[i]);
+            }
+            catch (const SatelliteException&)
+            {
+                ok[k] = 0;
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; t++)
+    {
+        pool.emplace_back(worker);
+    }
+    if (threads > 0)
+    {
+        worker();
+    }
+    for (auto& thread : pool)
+    {
+        thread.join();
+    }
+
+    /*
+     * put back the previous element set of any that failed
+     */
+    for (size_t k = 0; k < changed.size(); k++)
+    {
+        const size_t i = changed[k];
+
+        if (ok[k])
+        {
+            result.updated++;
+        }
+        else
+        {
+            tles_[i] = previous[k];
+            models_[i].SetTle(tles_[i]);
+            result.failed++;
+        }
+    }
+
+    return result;
+}
+
+const SGP4* SGP4Catalog::Find(unsigned int norad_number) const
+{
+    auto found = index_.find(norad_number);
+
+    if (found == index_.end())
+    {
+        return nullptr;
+    }
+
+    return &models_[found->second];
+}
+
+bool SGP4Catalog::SameElements(const Tle& a, const Tle& b)
+{
+    /*
+     * a new epoch is by far the most common change, so check it first
+     */
+    return a.Epoch() == b.Epoch()
+        && a.MeanMotion() == b.MeanMotion()
+        && a.Eccentricity() == b.Eccentricity()
+        && a.Inclination(true) == b.Inclination(true)
+        && a.RightAscendingNode(true) == b.RightAscendingNode(true)
+        && a.ArgumentPerigee(true) == b.ArgumentPerigee(true)
+        && a.MeanAnomaly(true) == b.MeanAnomaly(true)
+        && a.BStar() == b.BStar()
+        && a.MeanMotionDt2() == b.MeanMotionDt2()
+        && a.MeanMotionDdt6() == b.MeanMotionDdt6();
+}
+
+}; // end namespace csgp4
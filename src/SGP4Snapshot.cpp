@@ -0,0 +1,536 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "csgp4/SGP4Snapshot.h"
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    static const char kMagic[8] = { 'C', 'S', 'G', 'P', '4', 'S', 'N', 'P' };
+
+    /*
+     * the tag as written, which reads back swapped on a machine of the
+     * other byte order
+     */
+    static const uint32_t kByteOrder = 0x01020304;
+    static const uint32_t kByteOrderSwapped = 0x04030201;
+
+    enum HeaderFlags
+    {
+        HEADER_FAST_MATH = 1
+    };
+
+    enum RecordFlags
+    {
+        RECORD_SIMPLE_MODEL = 1,
+        RECORD_DEEP_SPACE = 2
+    };
+
+    /*
+     * FNV-1a over the name and offset of every field a record is read
+     * through, so fields reordered or swapped without a change of size
+     * are caught too
+     */
+    class Fingerprint
+    {
+    public:
+        void Add(const char* name, size_t offset)
+        {
+            for (const char* c = name; *c != '\0'; c++)
+            {
+                Mix(static_cast<unsigned char>(*c));
+            }
+            for (int i = 0; i < 8; i++)
+            {
+                Mix(static_cast<unsigned char>(static_cast<uint64_t>(offset) >> (8 * i)));
+            }
+        }
+
+        uint64_t Value() const
+        {
+            return hash_;
+        }
+
+    private:
+        void Mix(unsigned char byte)
+        {
+            hash_ = (hash_ ^ byte) * 0x100000001b3ULL;
+        }
+
+        uint64_t hash_ = 0xcbf29ce484222325ULL;
+    };
+
+    /*
+     * the build options that change the constants
+     */
+    uint32_t BuildFlags()
+    {
+#if defined(LIBCSGP4_FAST_MATH)
+        return HEADER_FAST_MATH;
+#else
+        return 0;
+#endif
+    }
+}
+
+namespace csgp4
+{
+
+/*
+ * 64 bytes, so the records that follow are aligned
+ */
+struct SGP4Snapshot::Header
+{
+    char magic[8];
+    uint32_t byte_order;
+    uint32_t version;
+    uint32_t flags;
+    uint32_t record_size;
+    uint32_t deep_space_record_size;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t deep_space_count;
+    uint64_t layout;
+    uint64_t reserved2;
+};
+
+struct SGP4Snapshot::Record
+{
+    uint32_t norad_number;
+    uint32_t gravity;
+    uint32_t flags;
+    uint32_t deep_space_index;
+    int64_t epoch;     // ticks
+    double elements[11];  // in the order of the OrbitalElements accessors
+    SGP4Kernel<double>::CommonConstants common;
+    SGP4Kernel<double>::NearSpaceConstants nearspace;
+};
+
+struct SGP4Snapshot::DeepSpaceRecord
+{
+    double terms[47];
+    int32_t shape;
+    uint32_t reserved;
+};
+
+uint64_t SGP4Snapshot::LayoutFingerprint()
+{
+    typedef SGP4Kernel<double>::CommonConstants Common;
+    typedef SGP4Kernel<double>::NearSpaceConstants NearSpace;
+    typedef SGP4::DeepSpaceTerms Terms;
+
+    Fingerprint fingerprint;
+
+#define CSGP4_LAYOUT_FIELD(type, field) \
+    fingerprint.Add(#type "::" #field, offsetof(type, field))
+    CSGP4_LAYOUT_FIELD(Record, norad_number);
+    CSGP4_LAYOUT_FIELD(Record, gravity);
+    CSGP4_LAYOUT_FIELD(Record, flags);
+    CSGP4_LAYOUT_FIELD(Record, deep_space_index);
+    CSGP4_LAYOUT_FIELD(Record, epoch);
+    CSGP4_LAYOUT_FIELD(Record, elements);
+    CSGP4_LAYOUT_FIELD(Record, common);
+    CSGP4_LAYOUT_FIELD(Record, nearspace);
+    CSGP4_LAYOUT_FIELD(Common, cosio);
+    CSGP4_LAYOUT_FIELD(Common, sinio);
+    CSGP4_LAYOUT_FIELD(Common, eta);
+    CSGP4_LAYOUT_FIELD(Common, t2cof);
+    CSGP4_LAYOUT_FIELD(Common, x1mth2);
+    CSGP4_LAYOUT_FIELD(Common, x3thm1);
+    CSGP4_LAYOUT_FIELD(Common, x7thm1);
+    CSGP4_LAYOUT_FIELD(Common, aycof);
+    CSGP4_LAYOUT_FIELD(Common, xlcof);
+    CSGP4_LAYOUT_FIELD(Common, xnodcf);
+    CSGP4_LAYOUT_FIELD(Common, c1);
+    CSGP4_LAYOUT_FIELD(Common, c4);
+    CSGP4_LAYOUT_FIELD(Common, omgdot);
+    CSGP4_LAYOUT_FIELD(Common, xnodot);
+    CSGP4_LAYOUT_FIELD(Common, xmdot);
+    CSGP4_LAYOUT_FIELD(NearSpace, c5);
+    CSGP4_LAYOUT_FIELD(NearSpace, omgcof);
+    CSGP4_LAYOUT_FIELD(NearSpace, xmcof);
+    CSGP4_LAYOUT_FIELD(NearSpace, delmo);
+    CSGP4_LAYOUT_FIELD(NearSpace, sinmo);
+    CSGP4_LAYOUT_FIELD(NearSpace, d2);
+    CSGP4_LAYOUT_FIELD(NearSpace, d3);
+    CSGP4_LAYOUT_FIELD(NearSpace, d4);
+    CSGP4_LAYOUT_FIELD(NearSpace, t3cof);
+    CSGP4_LAYOUT_FIELD(NearSpace, t4cof);
+    CSGP4_LAYOUT_FIELD(NearSpace, t5cof);
+    CSGP4_LAYOUT_FIELD(Terms, gsto);
+    CSGP4_LAYOUT_FIELD(Terms, zmol);
+    CSGP4_LAYOUT_FIELD(Terms, zmos);
+    CSGP4_LAYOUT_FIELD(Terms, sse);
+    CSGP4_LAYOUT_FIELD(Terms, ssi);
+    CSGP4_LAYOUT_FIELD(Terms, ssl);
+    CSGP4_LAYOUT_FIELD(Terms, ssg);
+    CSGP4_LAYOUT_FIELD(Terms, ssh);
+    CSGP4_LAYOUT_FIELD(Terms, se2);
+    CSGP4_LAYOUT_FIELD(Terms, si2);
+    CSGP4_LAYOUT_FIELD(Terms, sl2);
+    CSGP4_LAYOUT_FIELD(Terms, sgh2);
+    CSGP4_LAYOUT_FIELD(Terms, sh2);
+    CSGP4_LAYOUT_FIELD(Terms, se3);
+    CSGP4_LAYOUT_FIELD(Terms, si3);
+    CSGP4_LAYOUT_FIELD(Terms, sl3);
+    CSGP4_LAYOUT_FIELD(Terms, sgh3);
+    CSGP4_LAYOUT_FIELD(Terms, sh3);
+    CSGP4_LAYOUT_FIELD(Terms, sl4);
+    CSGP4_LAYOUT_FIELD(Terms, sgh4);
+    CSGP4_LAYOUT_FIELD(Terms, ee2);
+    CSGP4_LAYOUT_FIELD(Terms, e3);
+    CSGP4_LAYOUT_FIELD(Terms, xi2);
+    CSGP4_LAYOUT_FIELD(Terms, xi3);
+    CSGP4_LAYOUT_FIELD(Terms, xl2);
+    CSGP4_LAYOUT_FIELD(Terms, xl3);
+    CSGP4_LAYOUT_FIELD(Terms, xl4);
+    CSGP4_LAYOUT_FIELD(Terms, xgh2);
+    CSGP4_LAYOUT_FIELD(Terms, xgh3);
+    CSGP4_LAYOUT_FIELD(Terms, xgh4);
+    CSGP4_LAYOUT_FIELD(Terms, xh2);
+    CSGP4_LAYOUT_FIELD(Terms, xh3);
+    CSGP4_LAYOUT_FIELD(Terms, d2201);
+    CSGP4_LAYOUT_FIELD(Terms, d2211);
+    CSGP4_LAYOUT_FIELD(Terms, d3210);
+    CSGP4_LAYOUT_FIELD(Terms, d3222);
+    CSGP4_LAYOUT_FIELD(Terms, d4410);
+    CSGP4_LAYOUT_FIELD(Terms, d4422);
+    CSGP4_LAYOUT_FIELD(Terms, d5220);
+    CSGP4_LAYOUT_FIELD(Terms, d5232);
+    CSGP4_LAYOUT_FIELD(Terms, d5421);
+    CSGP4_LAYOUT_FIELD(Terms, d5433);
+    CSGP4_LAYOUT_FIELD(Terms, del1);
+    CSGP4_LAYOUT_FIELD(Terms, del2);
+    CSGP4_LAYOUT_FIELD(Terms, del3);
+    CSGP4_LAYOUT_FIELD(Terms, xfact);
+    CSGP4_LAYOUT_FIELD(Terms, xlamo);
+    CSGP4_LAYOUT_FIELD(DeepSpaceRecord, terms);
+    CSGP4_LAYOUT_FIELD(DeepSpaceRecord, shape);
+#undef CSGP4_LAYOUT_FIELD
+
+    return fingerprint.Value();
+}
+
+SGP4Snapshot::SGP4Snapshot(SGP4Snapshot&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+SGP4Snapshot& SGP4Snapshot::operator=(SGP4Snapshot&& other) noexcept
+{
+    if (this != &other)
+    {
+        Unmap();
+        map_ = other.map_;
+        size_ = other.size_;
+        count_ = other.count_;
+        records_ = other.records_;
+        deep_space_records_ = other.deep_space_records_;
+        error_ = std::move(other.error_);
+
+        other.map_ = nullptr;
+        other.size_ = 0;
+        other.count_ = 0;
+        other.records_ = nullptr;
+        other.deep_space_records_ = nullptr;
+    }
+
+    return *this;
+}
+
+SGP4Snapshot::~SGP4Snapshot()
+{
+    Unmap();
+}
+
+bool SGP4Snapshot::Save(const std::string& path,
+                        const std::vector<SGP4>& models,
+                        const std::vector<unsigned int>& norad_numbers)
+{
+    static_assert(sizeof(Header) == 64, "the header is 64 bytes");
+    static_assert(sizeof(SGP4::DeepSpaceTerms) == sizeof(DeepSpaceRecord::terms),
+            "a deep space record holds every deep space term");
+
+    if (norad_numbers.size() != models.size())
+    {
+        return false;
+    }
+
+    std::vector<Record> records(models.size());
+    std::vector<DeepSpaceRecord> deep_space_records;
+
+    for (size_t i = 0; i < models.size(); i++)
+    {
+        const SGP4& model = models[i];
+        const OrbitalElements& elements = model.elements_;
+        Record& record = records[i];
+
+        record.norad_number = norad_numbers[i];
+        record.gravity = static_cast<uint32_t>(elements.Gravity());
+        record.flags = (model.use_simple_model_ ? RECORD_SIMPLE_MODEL : 0)
+            | (model.use_deep_space_ ? RECORD_DEEP_SPACE : 0);
+        record.epoch = elements.Epoch().Ticks();
+        record.elements[0] = elements.MeanAnomoly();
+        record.elements[1] = elements.AscendingNode();
+        record.elements[2] = elements.ArgumentPerigee();
+        record.elements[3] = elements.Eccentricity();
+        record.elements[4] = elements.Inclination();
+        record.elements[5] = elements.MeanMotion();
+        record.elements[6] = elements.BStar();
+        record.elements[7] = elements.RecoveredSemiMajorAxis();
+        record.elements[8] = elements.RecoveredMeanMotion();
+        record.elements[9] = elements.Perigee();
+        record.elements[10] = elements.Period();
+        record.common = model.common_consts_;
+        record.nearspace = model.nearspace_consts_;
+
+        if (model.use_deep_space_)
+        {
+            record.deep_space_index = static_cast<uint32_t>(deep_space_records.size());
+
+            DeepSpaceRecord deep_space{};
+            const SGP4::DeepSpaceTerms& terms = *model.deepspace_consts_;
+            std::memcpy(deep_space.terms, &terms, sizeof(deep_space.terms));
+            deep_space.shape = static_cast<int32_t>(model.deepspace_consts_->shape);
+            deep_space_records.push_back(deep_space);
+        }
+    }
+
+    Header header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.byte_order = kByteOrder;
+    header.version = kVersion;
+    header.flags = BuildFlags();
+    header.record_size = sizeof(Record);
+    header.deep_space_record_size = sizeof(DeepSpaceRecord);
+    header.count = records.size();
+    header.deep_space_count = deep_space_records.size();
+    header.layout = LayoutFingerprint();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(Record)));
+    out.write(reinterpret_cast<const char*>(deep_space_records.data()),
+            static_cast<std::streamsize>(deep_space_records.size() * sizeof(DeepSpaceRecord)));
+    out.close();
+
+    return !out.fail();
+}
+
+bool SGP4Snapshot::Save(const std::string& path, const SGP4Catalog& catalog)
+{
+    std::vector<unsigned int> norad_numbers(catalog.Size());
+    for (size_t i = 0; i < catalog.Size(); i++)
+    {
+        norad_numbers[i] = catalog.TleAt(i).NoradNumber();
+    }
+
+    return Save(path, catalog.Models(), norad_numbers);
+}
+
+SGP4Snapshot SGP4Snapshot::Load(const std::string& path)
+{
+    SGP4Snapshot snapshot;
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        snapshot.error_ = "Unable to open " + path;
+        return snapshot;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        snapshot.error_ = "Unable to read " + path;
+        return snapshot;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size < sizeof(Header))
+    {
+        close(fd);
+        snapshot.error_ = "Not a snapshot " + path;
+        return snapshot;
+    }
+
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        snapshot.error_ = "Unable to map " + path;
+        return snapshot;
+    }
+    madvise(map, size, MADV_WILLNEED);
+    snapshot.map_ = map;
+    snapshot.size_ = size;
+
+    /*
+     * the records are used in place, so a file this build would not have
+     * written is refused
+     */
+    const Header& header = *static_cast<const Header*>(map);
+    const size_t available = size - sizeof(Header);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        snapshot.error_ = "Not a snapshot " + path;
+    }
+    else if (header.byte_order == kByteOrderSwapped)
+    {
+        snapshot.error_ = "Other byte order in " + path;
+    }
+    else if (header.byte_order != kByteOrder || header.version != kVersion)
+    {
+        snapshot.error_ = "Unsupported version in " + path;
+    }
+    else if (header.record_size != sizeof(Record)
+            || header.deep_space_record_size != sizeof(DeepSpaceRecord)
+            || header.layout != LayoutFingerprint())
+    {
+        snapshot.error_ = "Other record layout in " + path;
+    }
+    else if (header.flags != BuildFlags())
+    {
+        snapshot.error_ = "Other LIBCSGP4_FAST_MATH setting in " + path;
+    }
+    else if (header.count > available / sizeof(Record)
+            || header.deep_space_count > (available - header.count * sizeof(Record))
+                / sizeof(DeepSpaceRecord))
+    {
+        snapshot.error_ = "Truncated " + path;
+    }
+
+    if (snapshot.error_.empty())
+    {
+        const char* base = static_cast<const char*>(map) + sizeof(Header);
+        snapshot.count_ = static_cast<size_t>(header.count);
+        snapshot.records_ = reinterpret_cast<const Record*>(base);
+        snapshot.deep_space_records_ = reinterpret_cast<const DeepSpaceRecord*>(
+                base + snapshot.count_ * sizeof(Record));
+
+        /*
+         * checked once here so Model() can trust the indexes and enums
+         */
+        for (size_t i = 0; i < snapshot.count_; i++)
+        {
+            const Record& record = snapshot.records_[i];
+            bool valid = record.gravity <= GRAVITY_WGS84;
+            if (valid && (record.flags & RECORD_DEEP_SPACE))
+            {
+                valid = record.deep_space_index < header.deep_space_count;
+                if (valid)
+                {
+                    const int32_t shape = snapshot.deep_space_records_[record.deep_space_index].shape;
+                    valid = shape >= SGP4::DeepSpaceConstants::NONE
+                        && shape <= SGP4::DeepSpaceConstants::SYNCHRONOUS;
+                }
+            }
+            if (!valid)
+            {
+                snapshot.error_ = "Invalid record in " + path;
+                break;
+            }
+        }
+    }
+
+    if (!snapshot.error_.empty())
+    {
+        snapshot.Unmap();
+    }
+
+    return snapshot;
+}
+
+unsigned int SGP4Snapshot::NoradNumber(size_t index) const
+{
+    return records_[index].norad_number;
+}
+
+SGP4 SGP4Snapshot::Model(size_t index) const
+{
+    const Record& record = records_[index];
+
+    OrbitalElements elements;
+    elements.mean_anomoly_ = record.elements[0];
+    elements.ascending_node_ = record.elements[1];
+    elements.argument_perigee_ = record.elements[2];
+    elements.eccentricity_ = record.elements[3];
+    elements.inclination_ = record.elements[4];
+    elements.mean_motion_ = record.elements[5];
+    elements.bstar_ = record.elements[6];
+    elements.recovered_semi_major_axis_ = record.elements[7];
+    elements.recovered_mean_motion_ = record.elements[8];
+    elements.perigee_ = record.elements[9];
+    elements.period_ = record.elements[10];
+    elements.epoch_ = DateTime(record.epoch);
+    elements.gravity_model_ = static_cast<GravityModel>(record.gravity);
+
+    SGP4 model(elements, SGP4::Restored());
+    model.common_consts_ = record.common;
+    model.nearspace_consts_ = record.nearspace;
+    model.use_simple_model_ = (record.flags & RECORD_SIMPLE_MODEL) != 0;
+    model.use_deep_space_ = (record.flags & RECORD_DEEP_SPACE) != 0;
+
+    if (model.use_deep_space_)
+    {
+        const DeepSpaceRecord& deep_space = deep_space_records_[record.deep_space_index];
+        model.deepspace_consts_.reset(new SGP4::DeepSpaceConstants());
+        SGP4::DeepSpaceTerms& terms = *model.deepspace_consts_;
+        std::memcpy(&terms, deep_space.terms, sizeof(deep_space.terms));
+        model.deepspace_consts_->shape =
+            static_cast<SGP4::DeepSpaceConstants::TOrbitShape>(deep_space.shape);
+    }
+
+    return model;
+}
+
+std::vector<SGP4> SGP4Snapshot::Models() const
+{
+    std::vector<SGP4> models;
+    models.reserve(count_);
+    for (size_t i = 0; i < count_; i++)
+    {
+        models.push_back(Model(i));
+    }
+
+    return models;
+}
+
+void SGP4Snapshot::Unmap()
+{
+    if (map_)
+    {
+        munmap(map_, size_);
+    }
+    map_ = nullptr;
+    size_ = 0;
+    count_ = 0;
+    records_ = nullptr;
+    deep_space_records_ = nullptr;
+}
+
+}; // end namespace csgp4
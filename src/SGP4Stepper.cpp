@@ -0,0 +1,326 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csgp4/SGP4Stepper.h"
+
+#include "csgp4/Globals.h"
+#include "csgp4/GravityModel.h"
+
+#include <cmath>
+
+namespace
+{
+    /*
+     * below this the series in SinCosSmall(), to x^9 and x^8, stay within
+     * an ulp of the result; the short periodic and drag corrections
+     * normally sit far below it
+     */
+    const double kSmallAngle = 0.0625;
+
+    /*
+     * sin / cos of an angle that is usually small
+     */
+    inline void SinCosSmall(const double x, double& s, double& c)
+    {
+        if (fabs(x) < kSmallAngle)
+        {
+            const double x2 = x * x;
+            s = x * (1.0 - x2 / 6.0 * (1.0 - x2 / 20.0 * (1.0 - x2 / 42.0
+                        * (1.0 - x2 / 72.0))));
+            c = 1.0 - x2 / 2.0 * (1.0 - x2 / 12.0 * (1.0 - x2 / 30.0
+                        * (1.0 - x2 / 56.0)));
+        }
+        else
+        {
+            s = sin(x);
+            c = cos(x);
+        }
+    }
+
+    /*
+     * SGP4Kernel functions (see SGP4Kernel::DirectMath) that rotate the
+     * sin / cos pairs of the secular angles through the small moves of
+     * drag and the short periodics, rather than taking sin / cos of the
+     * moved angles, and keep the powers to multiplies and a sqrt
+     */
+    struct RotatingMath
+    {
+        double xmdf_s;
+        double xmdf_c;
+        double omgadf_s;
+        double omgadf_c;
+        double xnode_s;
+        double xnode_c;
+
+        double Cube(const double x) const
+        {
+            return x * x * x;
+        }
+
+        double PowThreeHalves(const double x) const
+        {
+            return x * sqrt(x);
+        }
+
+        double CosMeanAnomaly(const double) const
+        {
+            return xmdf_c;
+        }
+
+        double SinMeanAnomaly(const double, const double temp) const
+        {
+            double sintmp;
+            double costmp;
+            SinCosSmall(temp, sintmp, costmp);
+            return xmdf_s * costmp + xmdf_c * sintmp;
+        }
+
+        void SinCosPerigee(const double, const double temp, double& s, double& c) const
+        {
+            double sintmp;
+            double costmp;
+            SinCosSmall(temp, sintmp, costmp);
+            s = omgadf_s * costmp - omgadf_c * sintmp;
+            c = omgadf_c * costmp + omgadf_s * sintmp;
+        }
+
+        void SinCosNode(const double, const double delta, double& s, double& c) const
+        {
+            double sindel;
+            double cosdel;
+            SinCosSmall(delta, sindel, cosdel);
+            s = xnode_s * cosdel + xnode_c * sindel;
+            c = xnode_c * cosdel - xnode_s * sindel;
+        }
+
+        void SinCosInclination(const double,
+                               const double delta,
+                               const double sinio,
+                               const double cosio,
+                               double& s,
+                               double& c) const
+        {
+            double sindel;
+            double cosdel;
+            SinCosSmall(delta, sindel, cosdel);
+            s = sinio * cosdel + cosio * sindel;
+            c = cosio * cosdel - sinio * sindel;
+        }
+
+        void SinCosLatitude(const double sinu,
+                            const double cosu,
+                            const double delta,
+                            double& s,
+                            double& c) const
+        {
+            /*
+             * (cosu, sinu) is a unit vector to within the Kepler
+             * tolerance, so u itself is never needed once it is normalised
+             */
+            const double norm = 1.0 / sqrt(sinu * sinu + cosu * cosu);
+            const double sinun = sinu * norm;
+            const double cosun = cosu * norm;
+
+            double sindel;
+            double cosdel;
+            SinCosSmall(delta, sindel, cosdel);
+            s = sinun * cosdel - cosun * sindel;
+            c = cosun * cosdel + sinun * sindel;
+        }
+    };
+}
+
+namespace csgp4
+{
+
+const unsigned int SGP4Stepper::kDefaultRenormaliseInterval;
+
+SGP4Stepper::SGP4Stepper(const SGP4& sgp4,
+                         double start,
+                         double step,
+                         unsigned int renormalise_interval)
+    : sgp4_(sgp4),
+      integ_(),
+      start_(start),
+      step_(step),
+      index_(0),
+      interval_(renormalise_interval == 0 ? 1 : renormalise_interval),
+      countdown_(0)
+{
+    Renormalise();
+}
+
+PropagationStatus SGP4Stepper::Next(Vector& position,
+                                    Vector& velocity) noexcept
+{
+    return Step<true>(position, velocity);
+}
+
+PropagationStatus SGP4Stepper::Next(Vector& position) noexcept
+{
+    Vector velocity;
+    return Step<false>(position, velocity);
+}
+
+void SGP4Stepper::Renormalise()
+{
+    const SGP4::CommonConstants& consts = sgp4_.common_consts_;
+    const OrbitalElements& elements = sgp4_.elements_;
+    const double tsince = Time();
+
+    /*
+     * rebuild every pair from its exact angle at the next sample
+     */
+    const double xmdf = elements.MeanAnomoly() + consts.xmdot * tsince;
+    const double omgadf = elements.ArgumentPerigee()
+        + consts.omgdot * tsince;
+    const double xnode = elements.AscendingNode() + consts.xnodot * tsince
+        + consts.xnodcf * tsince * tsince;
+    const double node_step = consts.xnodot * step_
+        + consts.xnodcf * step_ * (2.0 * tsince + step_);
+
+    xmdf_.s = sin(xmdf);
+    xmdf_.c = cos(xmdf);
+    omgadf_.s = sin(omgadf);
+    omgadf_.c = cos(omgadf);
+    xnode_.s = sin(xnode);
+    xnode_.c = cos(xnode);
+    node_step_.s = sin(node_step);
+    node_step_.c = cos(node_step);
+
+    xmdf_step_.s = sin(consts.xmdot * step_);
+    xmdf_step_.c = cos(consts.xmdot * step_);
+    omgadf_step_.s = sin(consts.omgdot * step_);
+    omgadf_step_.c = cos(consts.omgdot * step_);
+    node_step2_.s = sin(2.0 * consts.xnodcf * step_ * step_);
+    node_step2_.c = cos(2.0 * consts.xnodcf * step_ * step_);
+
+    countdown_ = interval_;
+}
+
+template <bool kVelocity>
+PropagationStatus SGP4Stepper::Step(Vector& position,
+                                    Vector& velocity) noexcept
+{
+    const double tsince = Time();
+    PropagationStatus status;
+
+    if (sgp4_.use_deep_space_)
+    {
+        status = sgp4_.Propagate<kVelocity>(tsince,
+                                            integ_,
+                                            position,
+                                            velocity);
+        index_++;
+        return status;
+    }
+
+    switch (sgp4_.Gravity())
+    {
+    case GRAVITY_WGS72_OLD:
+        status = StepNearSpace<Wgs72OldGravity, kVelocity>(tsince, position, velocity);
+        break;
+    case GRAVITY_WGS84:
+        status = StepNearSpace<Wgs84Gravity, kVelocity>(tsince, position, velocity);
+        break;
+    default:
+        status = StepNearSpace<Wgs72Gravity, kVelocity>(tsince, position, velocity);
+        break;
+    }
+
+    /*
+     * advance the pairs to the next sample
+     */
+    index_++;
+
+    if (--countdown_ == 0)
+    {
+        Renormalise();
+    }
+    else
+    {
+        const Rotation m = xmdf_;
+        xmdf_.s = m.s * xmdf_step_.c + m.c * xmdf_step_.s;
+        xmdf_.c = m.c * xmdf_step_.c - m.s * xmdf_step_.s;
+
+        const Rotation w = omgadf_;
+        omgadf_.s = w.s * omgadf_step_.c + w.c * omgadf_step_.s;
+        omgadf_.c = w.c * omgadf_step_.c - w.s * omgadf_step_.s;
+
+        const Rotation n = xnode_;
+        xnode_.s = n.s * node_step_.c + n.c * node_step_.s;
+        xnode_.c = n.c * node_step_.c - n.s * node_step_.s;
+
+        const Rotation d = node_step_;
+        node_step_.s = d.s * node_step2_.c + d.c * node_step2_.s;
+        node_step_.c = d.c * node_step2_.c - d.s * node_step2_.s;
+    }
+
+    return status;
+}
+
+template <class Gravity, bool kVelocity>
+PropagationStatus SGP4Stepper::StepNearSpace(double tsince,
+                                             Vector& position,
+                                             Vector& velocity) const noexcept
+{
+    const SGP4::CommonConstants& consts = sgp4_.common_consts_;
+    const OrbitalElements& elements = sgp4_.elements_;
+
+    /*
+     * the secular angles as per SGP4::FindPositionSGP4, the kernel taking
+     * their sin / cos from the rotated pairs
+     */
+    const double xmdf = elements.MeanAnomoly() + consts.xmdot * tsince;
+    const double omgadf = elements.ArgumentPerigee()
+        + consts.omgdot * tsince;
+    const double xnoddf = elements.AscendingNode()
+        + consts.xnodot * tsince;
+    const double xnode = xnoddf + consts.xnodcf * (tsince * tsince);
+
+    const RotatingMath math = {
+        xmdf_.s, xmdf_.c, omgadf_.s, omgadf_.c, xnode_.s, xnode_.c
+    };
+
+    double pos[3];
+    double vel[3];
+
+    const PropagationStatus status =
+        SGP4Kernel<double>::PropagateSecular<Gravity, kVelocity>(sgp4_.KernelElements(),
+                                                                 sgp4_.use_simple_model_,
+                                                                 consts,
+                                                                 sgp4_.nearspace_consts_,
+                                                                 tsince,
+                                                                 xmdf,
+                                                                 omgadf,
+                                                                 xnode,
+                                                                 pos,
+                                                                 vel,
+                                                                 math);
+
+    if (status == PROPAGATION_OK || status == PROPAGATION_DECAYED)
+    {
+        position = Vector(pos[0], pos[1], pos[2]);
+        if (kVelocity)
+        {
+            velocity = Vector(vel[0], vel[1], vel[2]);
+        }
+    }
+
+    return status;
+}
+
+}; // end namespace csgp4
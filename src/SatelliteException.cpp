@@ -15,3 +15,15 @@
  * limitations under the License.
  */
 #include "csgp4/SatelliteException.h"
+#include "csgp4/Stats.h"
+
+namespace csgp4
+{
+
+SatelliteException::SatelliteException(const char* message)
+    : runtime_error(message)
+{
+    CSGP4_STATS_INC(SATELLITE_EXCEPTIONS);
+}
+
+}; // end namespace csgp4
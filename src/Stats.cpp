@@ -0,0 +1,174 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "csgp4/Stats.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+    using csgp4::Stats;
+    using csgp4::StatsCounters;
+
+    struct ThreadCounters;
+
+    /*
+     * the counters of every running thread, and the totals of those that
+     * have finished
+     */
+    struct Registry
+    {
+        std::mutex mutex;
+        std::vector<ThreadCounters*> threads;
+        uint64_t retired[Stats::COUNTER_COUNT] = {};
+    };
+
+    Registry& GetRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    /*
+     * only the owning thread writes, so an increment is a plain load and
+     * store; the atomics let other threads read a snapshot safely
+     */
+    struct ThreadCounters
+    {
+        std::atomic<uint64_t> counts[Stats::COUNTER_COUNT];
+
+        ThreadCounters()
+        {
+            for (auto& count : counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.threads.push_back(this);
+        }
+
+        ~ThreadCounters()
+        {
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+
+            for (int i = 0; i < Stats::COUNTER_COUNT; i++)
+            {
+                registry.retired[i] += counts[i].load(std::memory_order_relaxed);
+            }
+
+            registry.threads.erase(std::find(registry.threads.begin(),
+                        registry.threads.end(), this));
+        }
+    };
+
+    ThreadCounters& GetThreadCounters()
+    {
+        thread_local ThreadCounters counters;
+        return counters;
+    }
+
+    StatsCounters ToCounters(const uint64_t* counts)
+    {
+        StatsCounters result;
+        result.kepler_solves = counts[Stats::KEPLER_SOLVES];
+        result.kepler_iterations = counts[Stats::KEPLER_ITERATIONS];
+        result.integrator_steps = counts[Stats::INTEGRATOR_STEPS];
+        result.integrator_restarts = counts[Stats::INTEGRATOR_RESTARTS];
+        result.integrator_checkpoints = counts[Stats::INTEGRATOR_CHECKPOINTS];
+        result.satellite_exceptions = counts[Stats::SATELLITE_EXCEPTIONS];
+        result.decayed_exceptions = counts[Stats::DECAYED_EXCEPTIONS];
+        result.tle_exceptions = counts[Stats::TLE_EXCEPTIONS];
+        result.observer_cache_hits = counts[Stats::OBSERVER_CACHE_HITS];
+        result.observer_cache_misses = counts[Stats::OBSERVER_CACHE_MISSES];
+        result.initialise_calls = counts[Stats::INITIALISE_CALLS];
+        return result;
+    }
+}
+
+namespace csgp4
+{
+
+bool Stats::Enabled()
+{
+#if defined(LIBCSGP4_STATS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Stats::Add(Counter counter, uint64_t n) noexcept
+{
+    std::atomic<uint64_t>& count = GetThreadCounters().counts[counter];
+    count.store(count.load(std::memory_order_relaxed) + n,
+            std::memory_order_relaxed);
+}
+
+StatsCounters Stats::Snapshot()
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    uint64_t totals[COUNTER_COUNT];
+
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        totals[i] = registry.retired[i];
+
+        for (const ThreadCounters* thread : registry.threads)
+        {
+            totals[i] += thread->counts[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    return ToCounters(totals);
+}
+
+StatsCounters Stats::ThreadSnapshot()
+{
+    const ThreadCounters& counters = GetThreadCounters();
+    uint64_t counts[COUNTER_COUNT];
+
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        counts[i] = counters.counts[i].load(std::memory_order_relaxed);
+    }
+
+    return ToCounters(counts);
+}
+
+void Stats::Reset()
+{
+    Registry& registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    for (int i = 0; i < COUNTER_COUNT; i++)
+    {
+        registry.retired[i] = 0;
+
+        for (ThreadCounters* thread : registry.threads)
+        {
+            thread->counts[i].store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+}; // end namespace csgp4
@@ -18,6 +18,7 @@
 
 #include "csgp4/Tle.h"
 
+#include <charconv>
 #include <locale> 
 
 namespace
@@ -61,6 +62,31 @@ namespace
     static const unsigned int TLE2_LEN_MEANMOTION = 11;
     static const unsigned int TLE2_COL_REVATEPOCH = 63;
     static const unsigned int TLE2_LEN_REVATEPOCH = 5;
+
+    /*
+     * a field rebuilt as a plain number for from_chars. no field is
+     * longer than 12 characters and at most 3 more are added
+     */
+    struct NumberText
+    {
+        char text[24];
+        size_t length = 0;
+
+        void Append(char c)
+        {
+            text[length++] = c;
+        }
+
+        bool ToDouble(double& val) const
+        {
+            const char* first = text;
+            if (length > 0 && *first == '+')
+            {
+                first++;
+            }
+            return std::from_chars(first, text + length, val).ec == std::errc();
+        }
+    };
 }
 
 namespace csgp4
@@ -92,12 +118,15 @@ void Tle::Initialize()
         throw TleException("Invalid line beginning for line two");
     }
 
+    const std::string_view line_one(line_one_);
+    const std::string_view line_two(line_two_);
+
     unsigned int sat_number_1;
     unsigned int sat_number_2;
 
-    ExtractInteger(line_one_.substr(TLE1_COL_NORADNUM,
+    ExtractInteger(line_one.substr(TLE1_COL_NORADNUM,
                 TLE1_LEN_NORADNUM), sat_number_1);
-    ExtractInteger(line_two_.substr(TLE2_COL_NORADNUM,
+    ExtractInteger(line_two.substr(TLE2_COL_NORADNUM,
                 TLE2_LEN_NORADNUM), sat_number_2);
 
     if (sat_number_1 != sat_number_2)
@@ -109,42 +138,45 @@ void Tle::Initialize()
 
     if (name_.empty())
     {
-        name_ = line_one_.substr(TLE1_COL_NORADNUM, TLE1_LEN_NORADNUM);
+        const std::string_view number = line_one.substr(TLE1_COL_NORADNUM,
+                TLE1_LEN_NORADNUM);
+        name_.assign(number.data(), number.size());
     }
 
-    int_designator_ = line_one_.substr(TLE1_COL_INTLDESC_A,
+    const std::string_view int_designator = line_one.substr(TLE1_COL_INTLDESC_A,
             TLE1_LEN_INTLDESC_A + TLE1_LEN_INTLDESC_B + TLE1_LEN_INTLDESC_C);
+    int_designator_.assign(int_designator.data(), int_designator.size());
 
     unsigned int year = 0;
     double day = 0.0;
 
-    ExtractInteger(line_one_.substr(TLE1_COL_EPOCH_A,
+    ExtractInteger(line_one.substr(TLE1_COL_EPOCH_A,
                 TLE1_LEN_EPOCH_A), year);
-    ExtractDouble(line_one_.substr(TLE1_COL_EPOCH_B,
+    ExtractDouble(line_one.substr(TLE1_COL_EPOCH_B,
                 TLE1_LEN_EPOCH_B), 4, day);
-    ExtractDouble(line_one_.substr(TLE1_COL_MEANMOTIONDT2,
+    ExtractDouble(line_one.substr(TLE1_COL_MEANMOTIONDT2,
                 TLE1_LEN_MEANMOTIONDT2), 2, mean_motion_dt2_);
-    ExtractExponential(line_one_.substr(TLE1_COL_MEANMOTIONDDT6,
+    ExtractExponential(line_one.substr(TLE1_COL_MEANMOTIONDDT6,
                 TLE1_LEN_MEANMOTIONDDT6), mean_motion_ddt6_);
-    ExtractExponential(line_one_.substr(TLE1_COL_BSTAR,
+    ExtractExponential(line_one.substr(TLE1_COL_BSTAR,
                 TLE1_LEN_BSTAR), bstar_);
 
     /*
      * line 2
      */
-    ExtractDouble(line_two_.substr(TLE2_COL_INCLINATION,
+    ExtractDouble(line_two.substr(TLE2_COL_INCLINATION,
                 TLE2_LEN_INCLINATION), 4, inclination_);
-    ExtractDouble(line_two_.substr(TLE2_COL_RAASCENDNODE,
+    ExtractDouble(line_two.substr(TLE2_COL_RAASCENDNODE,
                 TLE2_LEN_RAASCENDNODE), 4, right_ascending_node_);
-    ExtractDouble(line_two_.substr(TLE2_COL_ECCENTRICITY,
+    ExtractDouble(line_two.substr(TLE2_COL_ECCENTRICITY,
                 TLE2_LEN_ECCENTRICITY), -1, eccentricity_);
-    ExtractDouble(line_two_.substr(TLE2_COL_ARGPERIGEE,
+    ExtractDouble(line_two.substr(TLE2_COL_ARGPERIGEE,
                 TLE2_LEN_ARGPERIGEE), 4, argument_perigee_);
-    ExtractDouble(line_two_.substr(TLE2_COL_MEANANOMALY,
+    ExtractDouble(line_two.substr(TLE2_COL_MEANANOMALY,
                 TLE2_LEN_MEANANOMALY), 4, mean_anomaly_);
-    ExtractDouble(line_two_.substr(TLE2_COL_MEANMOTION,
+    ExtractDouble(line_two.substr(TLE2_COL_MEANMOTION,
                 TLE2_LEN_MEANMOTION), 3, mean_motion_);
-    ExtractInteger(line_two_.substr(TLE2_COL_REVATEPOCH,
+    ExtractInteger(line_two.substr(TLE2_COL_REVATEPOCH,
                 TLE2_LEN_REVATEPOCH), orbit_number_);
     
     if (year < 57)
@@ -166,7 +198,7 @@ void Tle::Initialize()
  * @param str The string to check
  * @returns Whether true of the string has a valid length
  */
-bool Tle::IsValidLineLength(const std::string& str)
+bool Tle::IsValidLineLength(std::string_view str)
 {
     return str.length() == LineLength() ? true : false;
 }
@@ -177,7 +209,7 @@ bool Tle::IsValidLineLength(const std::string& str)
  * @param[out] val The result
  * @exception TleException on conversion error
  */
-void Tle::ExtractInteger(const std::string& str, unsigned int& val)
+void Tle::ExtractInteger(std::string_view str, unsigned int& val)
 {
     bool found_digit = false;
     unsigned int temp = 0;
@@ -216,12 +248,12 @@ void Tle::ExtractInteger(const std::string& str, unsigned int& val)
  * @param[out] val The result
  * @exception TleException on conversion error
  */
-void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
+void Tle::ExtractDouble(std::string_view str, int point_pos, double& val)
 {
-    std::string temp;
+    NumberText temp;
     bool found_digit = false;
 
-    for (std::string::const_iterator i = str.begin(); i != str.end(); ++i)
+    for (std::string_view::const_iterator i = str.begin(); i != str.end(); ++i)
     {
         /*
          * integer part
@@ -237,7 +269,7 @@ void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
                     /*
                      * first character could be signed
                      */
-                    temp += *i;
+                    temp.Append(*i);
                     done = true;
                 }
             }
@@ -247,7 +279,7 @@ void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
                 if (isdigit(*i))
                 {
                     found_digit = true;
-                    temp += *i;
+                    temp.Append(*i);
                 }
                 else if (found_digit)
                 {
@@ -264,12 +296,12 @@ void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
          */
         else if (point_pos >= 0 && i == str.begin() + point_pos - 1)
         {
-            if (temp.length() == 0)
+            if (temp.length == 0)
             {
                 /*
                  * integer part is blank, so add a '0'
                  */
-                temp += '0';
+                temp.Append('0');
             }
 
             if (*i == '.')
@@ -277,7 +309,7 @@ void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
                 /*
                  * decimal point found
                  */
-                temp += *i;
+                temp.Append(*i);
             }
             else
             {
@@ -294,8 +326,8 @@ void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
                 /*
                  * no decimal point expected, add 0. beginning
                  */
-                temp += '0';
-                temp += '.';
+                temp.Append('0');
+                temp.Append('.');
             }
             
             /*
@@ -303,7 +335,7 @@ void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
              */
             if (isdigit(*i))
             {
-                temp += *i;
+                temp.Append(*i);
             }
             else
             {
@@ -312,7 +344,7 @@ void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
         }
     }
 
-    if (!Util::FromString<double>(temp, val))
+    if (!temp.ToDouble(val))
     {
         throw TleException("Failed to convert value to double");
     }
@@ -324,11 +356,11 @@ void Tle::ExtractDouble(const std::string& str, int point_pos, double& val)
  * @param[out] val The result
  * @exception TleException on conversion error
  */
-void Tle::ExtractExponential(const std::string& str, double& val)
+void Tle::ExtractExponential(std::string_view str, double& val)
 {
-    std::string temp;
+    NumberText temp;
 
-    for (std::string::const_iterator i = str.begin(); i != str.end(); ++i)
+    for (std::string_view::const_iterator i = str.begin(); i != str.end(); ++i)
     {
         if (i == str.begin())
         {
@@ -336,10 +368,10 @@ void Tle::ExtractExponential(const std::string& str, double& val)
             {
                 if (*i == '-')
                 {
-                    temp += *i;
+                    temp.Append(*i);
                 }
-                temp += '0';
-                temp += '.';
+                temp.Append('0');
+                temp.Append('.');
             }
             else
             {
@@ -350,8 +382,8 @@ void Tle::ExtractExponential(const std::string& str, double& val)
         {
             if (*i == '-' || *i == '+')
             {
-                temp += 'e';
-                temp += *i;
+                temp.Append('e');
+                temp.Append(*i);
             }
             else
             {
@@ -362,7 +394,7 @@ void Tle::ExtractExponential(const std::string& str, double& val)
         {
             if (isdigit(*i))
             {
-                temp += *i;
+                temp.Append(*i);
             }
             else
             {
@@ -371,7 +403,7 @@ void Tle::ExtractExponential(const std::string& str, double& val)
         }
     }
 
-    if (!Util::FromString<double>(temp, val))
+    if (!temp.ToDouble(val))
     {
         throw TleException("Failed to convert value to double");
     }
@@ -0,0 +1,545 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "csgp4/TleCatalog.h"
+
+#include "csgp4/OmmCsvReader.h"
+#include "csgp4/OmmJsonReader.h"
+#include "csgp4/OmmKvnReader.h"
+#include "csgp4/OmmXmlReader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    /*
+     * chunks smaller than this are not worth a thread
+     */
+    static const size_t kMinChunkBytes = 64 * 1024;
+
+    struct Line
+    {
+        const char* data;
+        size_t size;
+    };
+
+    /**
+     * Get the line starting at pos, without its line ending or trailing
+     * blanks, and move pos to the start of the next line
+     */
+    Line NextLine(const char* data, size_t end, size_t& pos)
+    {
+        const char* start = data + pos;
+        const void* nl = memchr(start, '\n', end - pos);
+        size_t size = nl ? static_cast<size_t>(static_cast<const char*>(nl) - start)
+                         : end - pos;
+        pos += nl ? size + 1 : size;
+
+        while (size > 0 && (start[size - 1] == '\r'
+                    || start[size - 1] == ' ' || start[size - 1] == '\t'))
+        {
+            size--;
+        }
+        return Line{ start, size };
+    }
+
+    bool IsLineOne(const Line& line)
+    {
+        return line.size > 2 && line.data[0] == '1' && line.data[1] == ' ';
+    }
+
+    bool IsLineTwo(const Line& line)
+    {
+        return line.size > 2 && line.data[0] == '2' && line.data[1] == ' ';
+    }
+
+    bool IsName(const Line& line)
+    {
+        return line.size > 0 && !IsLineOne(line) && !IsLineTwo(line);
+    }
+
+    /**
+     * Find the first record starting at or after pos. A record starts at
+     * its name line if it has one, otherwise at line one. A line one
+     * followed by a line two is the start of a record however the text
+     * before it is read, so the chunks parse exactly as the whole would.
+     */
+    size_t RecordStart(const char* data, size_t size, size_t pos)
+    {
+        while (pos > 0 && pos < size && data[pos - 1] != '\n')
+        {
+            pos++;
+        }
+
+        /*
+         * the last line before pos that is not blank
+         */
+        Line previous{ nullptr, 0 };
+        size_t previous_start = pos;
+        for (size_t end = pos; end > 0 && previous.size == 0; end = previous_start)
+        {
+            previous_start = end - 1;
+            while (previous_start > 0 && data[previous_start - 1] != '\n')
+            {
+                previous_start--;
+            }
+            size_t p = previous_start;
+            previous = NextLine(data, end, p);
+        }
+
+        while (pos < size)
+        {
+            const size_t start = pos;
+            const Line line = NextLine(data, size, pos);
+
+            if (IsLineOne(line) && pos < size)
+            {
+                size_t next_pos = pos;
+                if (IsLineTwo(NextLine(data, size, next_pos)))
+                {
+                    return IsName(previous) ? previous_start : start;
+                }
+            }
+            if (line.size > 0)
+            {
+                previous = line;
+                previous_start = start;
+            }
+        }
+        return size;
+    }
+
+    struct Chunk
+    {
+        size_t begin;
+        size_t end;
+        size_t lines;
+        std::vector<csgp4::Tle> tles;
+        std::vector<csgp4::TleCatalog::Error> errors; // lines local to the chunk
+    };
+
+    void ParseChunk(const char* data, Chunk& chunk)
+    {
+        std::string_view name;
+        bool have_name = false;
+        size_t name_line = 0;
+        size_t pos = chunk.begin;
+        size_t line_number = 0;
+
+        auto error = [&chunk](size_t line, const char* message)
+        {
+            chunk.errors.push_back(csgp4::TleCatalog::Error{ line, message });
+        };
+
+        while (pos < chunk.end)
+        {
+            const Line line = NextLine(data, chunk.end, pos);
+            line_number++;
+
+            if (IsLineOne(line))
+            {
+                size_t next_pos = pos;
+                const Line next = next_pos < chunk.end
+                    ? NextLine(data, chunk.end, next_pos) : Line{ nullptr, 0 };
+
+                if (!IsLineTwo(next))
+                {
+                    error(have_name ? name_line : line_number, "Line one without line two");
+                    have_name = false;
+                    continue;
+                }
+                pos = next_pos;
+
+                const std::string_view line_one(line.data, line.size);
+                const std::string_view line_two(next.data, next.size);
+                const size_t record_line = have_name ? name_line : line_number;
+                line_number++;
+
+                try
+                {
+                    if (have_name)
+                    {
+                        chunk.tles.emplace_back(name, line_one, line_two);
+                    }
+                    else
+                    {
+                        chunk.tles.emplace_back(line_one, line_two);
+                    }
+                }
+                catch (const csgp4::TleException& e)
+                {
+                    error(record_line, e.what());
+                }
+                have_name = false;
+            }
+            else if (IsLineTwo(line))
+            {
+                if (have_name)
+                {
+                    error(name_line, "Name line without an element set");
+                    have_name = false;
+                }
+                error(line_number, "Line two without line one");
+            }
+            else if (line.size > 0)
+            {
+                if (have_name)
+                {
+                    error(name_line, "Name line without an element set");
+                }
+
+                /*
+                 * 3LE files from space-track prefix the name with "0 "
+                 */
+                size_t skip = 0;
+                if (line.size > 2 && line.data[0] == '0' && line.data[1] == ' ')
+                {
+                    skip = 2;
+                }
+                name = std::string_view(line.data + skip, line.size - skip);
+                have_name = true;
+                name_line = line_number;
+            }
+        }
+
+        if (have_name)
+        {
+            error(name_line, "Name line without an element set");
+        }
+        chunk.lines = line_number;
+    }
+
+    /**
+     * @returns the start of the first line at or after pos
+     */
+    size_t LineStart(const char* data, size_t size, size_t pos)
+    {
+        while (pos > 0 && pos < size && data[pos - 1] != '\n')
+        {
+            pos++;
+        }
+        return pos;
+    }
+
+    /**
+     * Read the rows of a chunk of an OMM CSV file with a copy of the
+     * reader of its header
+     */
+    void ParseCsvChunk(const char* data, Chunk& chunk, const csgp4::OmmCsvReader& header)
+    {
+        csgp4::OmmCsvReader reader(
+            [&chunk](const csgp4::Tle& tle) { chunk.tles.push_back(tle); },
+            [&chunk](const csgp4::TleCatalog::Error& error) { chunk.errors.push_back(error); });
+        reader.ContinueFrom(header, 1);
+        reader.Feed(data + chunk.begin, chunk.end - chunk.begin);
+        reader.Finish();
+        chunk.lines = reader.Line() - 1;
+    }
+
+    /**
+     * Feed a file to a streaming reader in blocks, the reader keeps
+     * nothing of the text
+     * @returns null, or what went wrong to go before the path
+     */
+    template <typename Reader>
+    const char* StreamFile(const std::string& path, Reader& reader)
+    {
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            return "Unable to open ";
+        }
+
+        std::vector<char> buffer(1 << 20);
+        ssize_t count;
+        for (;;)
+        {
+            count = read(fd, buffer.data(), buffer.size());
+            if (count < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (count <= 0)
+            {
+                break;
+            }
+            reader.Feed(buffer.data(), static_cast<size_t>(count));
+        }
+        close(fd);
+
+        return count < 0 ? "Unable to read " : nullptr;
+    }
+
+    /**
+     * Join chunks in file order, turning chunk line numbers into file
+     * ones
+     */
+    void JoinChunks(std::vector<Chunk>& chunks, size_t first_line,
+                    std::vector<csgp4::Tle>& tles,
+                    std::vector<csgp4::TleCatalog::Error>& errors)
+    {
+        size_t total_tles = 0;
+        size_t total_errors = 0;
+        for (const auto& chunk : chunks)
+        {
+            total_tles += chunk.tles.size();
+            total_errors += chunk.errors.size();
+        }
+        tles.reserve(total_tles);
+        errors.reserve(total_errors);
+
+        for (auto& chunk : chunks)
+        {
+            tles.insert(tles.end(),
+                        std::make_move_iterator(chunk.tles.begin()),
+                        std::make_move_iterator(chunk.tles.end()));
+            for (auto& error : chunk.errors)
+            {
+                error.line += first_line;
+                errors.push_back(std::move(error));
+            }
+            first_line += chunk.lines;
+            chunk.tles.clear();
+            chunk.tles.shrink_to_fit();
+        }
+    }
+
+    /**
+     * Run work on each chunk, on up to threads threads
+     */
+    template <typename Work>
+    void RunChunks(std::vector<Chunk>& chunks, unsigned int threads, Work work)
+    {
+        threads = static_cast<unsigned int>(std::min<size_t>(threads, chunks.size()));
+        std::atomic<size_t> next(0);
+
+        auto worker = [&]()
+        {
+            for (size_t k = next++; k < chunks.size(); k = next++)
+            {
+                work(chunks[k]);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned int t = 1; t < threads; t++)
+        {
+            pool.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : pool)
+        {
+            thread.join();
+        }
+    }
+}
+
+namespace csgp4
+{
+
+TleCatalog TleCatalog::LoadFile(const std::string& path, unsigned int threads)
+{
+    return LoadMapped(path, threads, &Parse);
+}
+
+TleCatalog TleCatalog::LoadOmmJsonFile(const std::string& path)
+{
+    return LoadStreamed<OmmJsonReader>(path);
+}
+
+TleCatalog TleCatalog::LoadOmmCsvFile(const std::string& path, unsigned int threads)
+{
+    return LoadMapped(path, threads, &ParseOmmCsv);
+}
+
+TleCatalog TleCatalog::LoadOmmKvnFile(const std::string& path)
+{
+    return LoadStreamed<OmmKvnReader>(path);
+}
+
+TleCatalog TleCatalog::LoadOmmXmlFile(const std::string& path)
+{
+    return LoadStreamed<OmmXmlReader>(path);
+}
+
+TleCatalog TleCatalog::Parse(const char* data, size_t size, unsigned int threads)
+{
+    TleCatalog catalog;
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /*
+     * a few chunks per thread so an uneven chunk does not hold up the
+     * rest, cut on record boundaries
+     */
+    const size_t wanted = std::max<size_t>(1,
+            std::min<size_t>(threads * 4u, size / kMinChunkBytes));
+    std::vector<Chunk> chunks(wanted);
+    size_t begin = 0;
+    for (size_t k = 0; k < wanted; k++)
+    {
+        chunks[k].begin = begin;
+        chunks[k].end = k + 1 == wanted ? size
+            : std::max(begin, RecordStart(data, size, size / wanted * (k + 1)));
+        begin = chunks[k].end;
+    }
+
+    RunChunks(chunks, threads, [data](Chunk& chunk) { ParseChunk(data, chunk); });
+    JoinChunks(chunks, 0, catalog.tles_, catalog.errors_);
+
+    return catalog;
+}
+
+TleCatalog TleCatalog::ParseOmmCsv(const char* data, size_t size, unsigned int threads)
+{
+    TleCatalog catalog;
+
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    OmmCsvReader header(
+        [](const Tle&) {},
+        [&catalog](const Error& error) { catalog.errors_.push_back(error); });
+
+    /*
+     * the header, and any blank lines before it, is read first so every
+     * chunk can map its columns
+     */
+    size_t pos = 0;
+    while (pos < size)
+    {
+        size_t end = pos;
+        const Line line = NextLine(data, size, end);
+        header.Feed(data + pos, end - pos);
+        pos = end;
+        if (line.size > 0)
+        {
+            break;
+        }
+    }
+    if (!header.Finish())
+    {
+        return catalog;
+    }
+
+    /*
+     * rows are single lines, so the chunks are cut on line boundaries
+     */
+    const size_t rows = size - pos;
+    const size_t wanted = std::max<size_t>(1,
+            std::min<size_t>(threads * 4u, rows / kMinChunkBytes));
+    std::vector<Chunk> chunks(wanted);
+    size_t begin = pos;
+    for (size_t k = 0; k < wanted; k++)
+    {
+        chunks[k].begin = begin;
+        chunks[k].end = k + 1 == wanted ? size
+            : std::max(begin, LineStart(data, size, pos + rows / wanted * (k + 1)));
+        begin = chunks[k].end;
+    }
+
+    RunChunks(chunks, threads,
+            [data, &header](Chunk& chunk) { ParseCsvChunk(data, chunk, header); });
+    JoinChunks(chunks, header.Line() - 1, catalog.tles_, catalog.errors_);
+
+    return catalog;
+}
+
+/**
+ * Map a file and parse it
+ */
+TleCatalog TleCatalog::LoadMapped(const std::string& path, unsigned int threads,
+                                  TleCatalog (*parse)(const char*, size_t, unsigned int))
+{
+    TleCatalog catalog;
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        catalog.errors_.push_back(Error{ 0, "Unable to open " + path });
+        return catalog;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        catalog.errors_.push_back(Error{ 0, "Unable to read " + path });
+        return catalog;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    if (size == 0)
+    {
+        close(fd);
+        return catalog;
+    }
+
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+        catalog.errors_.push_back(Error{ 0, "Unable to map " + path });
+        return catalog;
+    }
+    madvise(map, size, MADV_WILLNEED);
+
+    catalog = parse(static_cast<const char*>(map), size, threads);
+
+    munmap(map, size);
+    return catalog;
+}
+
+/**
+ * Stream a file through a reader
+ */
+template <typename Reader>
+TleCatalog TleCatalog::LoadStreamed(const std::string& path)
+{
+    TleCatalog catalog;
+
+    Reader reader(
+        [&catalog](const Tle& tle) { catalog.tles_.push_back(tle); },
+        [&catalog](const Error& error) { catalog.errors_.push_back(error); });
+
+    const char* failure = StreamFile(path, reader);
+    if (failure)
+    {
+        catalog.errors_.push_back(Error{ 0, failure + path });
+        return catalog;
+    }
+    reader.Finish();
+
+    return catalog;
+}
+
+}; // end namespace csgp4
@@ -16,3 +16,15 @@
  */
 
 #include "csgp4/TleException.h"
+#include "csgp4/Stats.h"
+
+namespace csgp4
+{
+
+TleException::TleException(const char* message)
+    : runtime_error(message)
+{
+    CSGP4_STATS_INC(TLE_EXCEPTIONS);
+}
+
+}; // end namespace csgp4
@@ -0,0 +1,12 @@
+
+
+
+
+#ifndef CONFIG_H_IN
+#define CONFIG_H_IN
+
+#define GIT_TAG "673d987"
+#define LIBCSGP4_VERSION "1.0.0"
+
+#endif
+
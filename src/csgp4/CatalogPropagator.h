@@ -0,0 +1,170 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CATALOGPROPAGATOR_H_
+#define CATALOGPROPAGATOR_H_
+
+#include "SGP4.h"
+#include "SGP4Catalog.h"
+#include "DateTime.h"
+#include "PropagationStatus.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace csgp4
+{
+
+/**
+ * @brief Propagates a set of satellites over a time grid on many threads.
+ *
+ * The work is cut into tasks of one satellite over a block of up to
+ * kBlockSteps grid times. Each task is weighted by its expected cost, so
+ * deep space satellites, and above all resonant ones with their
+ * numerical integrator, count for more than near space ones. Every
+ * worker starts with a contiguous run of tasks of about equal total cost
+ * and, once it has run dry, steals half of what is left to the busiest
+ * worker, so the load stays balanced whatever the mix of orbits.
+ *
+ * Every result is written to a fixed slot, satellite by satellite, and
+ * the values do not depend on the number of threads or how the tasks
+ * were shared out.
+ */
+class CatalogPropagator
+{
+public:
+    /**
+     * Grid times per task
+     */
+    static const size_t kBlockSteps = 128;
+
+    /**
+     * @param[in] threads number of worker threads, 0 for one per core
+     */
+    explicit CatalogPropagator(unsigned int threads = 0);
+
+    /**
+     * @returns the number of worker threads
+     */
+    unsigned int Threads() const
+    {
+        return threads_;
+    }
+
+    /**
+     * Pin the workers to processors; worker i runs on cpus[i % n]. An
+     * empty list, the default, leaves placement to the scheduler. Only
+     * supported on Linux and ignored elsewhere.
+     * @param[in] cpus processor numbers
+     */
+    void SetThreadAffinity(const std::vector<unsigned int>& cpus)
+    {
+        cpus_ = cpus;
+    }
+
+    /**
+     * Set the cost of a grid time for deep space satellites, relative to
+     * a near space one.
+     * @param[in] deep_space non resonant deep space satellites
+     * @param[in] resonant resonant and synchronous satellites
+     */
+    void SetCostWeights(double deep_space, double resonant)
+    {
+        deep_space_cost_ = deep_space;
+        resonant_cost_ = resonant;
+    }
+
+    /**
+     * Propagate every satellite to the same minutes since its own epoch.
+     * Outputs hold models.size() * steps values each, where the result
+     * for satellite i at tsince[k] is at i * steps + k.
+     * @param[in] models the satellites
+     * @param[in] tsince the time grid (minutes since epoch)
+     * @param[in] steps number of grid times
+     * @param[out] x, y, z position (km)
+     * @param[out] xdot, ydot, zdot velocity (km/s)
+     * @param[out] status outcome of each propagation
+     */
+    void Propagate(const std::vector<SGP4>& models,
+                   const double* tsince,
+                   size_t steps,
+                   double* x,
+                   double* y,
+                   double* z,
+                   double* xdot,
+                   double* ydot,
+                   double* zdot,
+                   PropagationStatus* status) const;
+
+    /**
+     * Propagate every satellite to the same dates, laid out as per the
+     * tsince overload.
+     * @param[in] dates the time grid
+     */
+    void Propagate(const std::vector<SGP4>& models,
+                   const DateTime* dates,
+                   size_t steps,
+                   double* x,
+                   double* y,
+                   double* z,
+                   double* xdot,
+                   double* ydot,
+                   double* zdot,
+                   PropagationStatus* status) const;
+
+    /**
+     * Propagate a whole catalog to the same dates, in catalog order.
+     */
+    void Propagate(const SGP4Catalog& catalog,
+                   const DateTime* dates,
+                   size_t steps,
+                   double* x,
+                   double* y,
+                   double* z,
+                   double* xdot,
+                   double* ydot,
+                   double* zdot,
+                   PropagationStatus* status) const
+    {
+        Propagate(catalog.Models(), dates, steps,
+                  x, y, z, xdot, ydot, zdot, status);
+    }
+
+private:
+    void Run(const std::vector<SGP4>& models,
+             const double* tsince,
+             const DateTime* dates,
+             size_t steps,
+             double* x,
+             double* y,
+             double* z,
+             double* xdot,
+             double* ydot,
+             double* zdot,
+             PropagationStatus* status) const;
+
+    double Cost(const SGP4& model) const;
+
+    unsigned int threads_;
+    std::vector<unsigned int> cpus_;
+    double deep_space_cost_;
+    double resonant_cost_;
+};
+
+}; // end namespace csgp4
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef CHEBYSHEVEPHEMERIS_H_
+#define CHEBYSHEVEPHEMERIS_H_
+
+#include "SGP4.h"
+#include "Eci.h"
+#include "Vector.h"
+#include "DateTime.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace csgp4
+{
+
+/**
+ * @brief A Chebyshev fit of one satellite over a span of time.
+ *
+ * The span is cut into equal segments and each component of position
+ * and velocity is fitted with a Chebyshev series through the SGP4
+ * solution at the Chebyshev nodes of its segment. A query is then a
+ * segment lookup and a Clenshaw recurrence, whatever the model behind it.
+ *
+ * Once fitted, every segment is checked against SGP4 at its ends and
+ * half way between each pair of nodes, where an interpolant is furthest
+ * from its data, and the largest differences are kept as the error of
+ * the fit.
+ */
+class ChebyshevEphemeris
+{
+public:
+    static const unsigned int kDefaultDegree = 12;
+
+    /**
+     * Fit with a fixed segment length.
+     * @param[in] sgp4 the satellite
+     * @param[in] start minutes since epoch the span starts at
+     * @param[in] end minutes since epoch the span ends at
+     * @param[in] segment length of each segment (minutes), shortened so
+     * a whole number of them fills the span
+     * @param[in] degree degree of each series
+     * @exception std::invalid_argument for an empty span or segment, or
+     * a degree below one
+     * @exception SatelliteException
+     * @exception DecayedException
+     */
+    ChebyshevEphemeris(const SGP4& sgp4,
+                       double start,
+                       double end,
+                       double segment,
+                       unsigned int degree = kDefaultDegree);
+
+    /**
+     * Fit to an accuracy. Starting from one orbit per segment the segments
+     * are halved until the position error is within tolerance, or until
+     * they are 1/64 of an orbit, when the best fit found is returned and
+     * MaxPositionError() tells by how much it missed.
+     * @param[in] sgp4 the satellite
+     * @param[in] start minutes since epoch the span starts at
+     * @param[in] end minutes since epoch the span ends at
+     * @param[in] tolerance the position error wanted (km)
+     * @param[in] degree degree of each series
+     * @exception std::invalid_argument for an empty span or a degree
+     * below one
+     * @exception SatelliteException
+     * @exception DecayedException
+     */
+    static ChebyshevEphemeris Fit(const SGP4& sgp4,
+                                  double start,
+                                  double end,
+                                  double tolerance,
+                                  unsigned int degree = kDefaultDegree);
+
+    double Start() const
+    {
+        return start_;
+    }
+
+    double End() const
+    {
+        return start_ + segment_ * static_cast<double>(segments_);
+    }
+
+    double SegmentLength() const
+    {
+        return segment_;
+    }
+
+    size_t SegmentCount() const
+    {
+        return segments_;
+    }
+
+    unsigned int Degree() const
+    {
+        return degree_;
+    }
+
+    /**
+     * @returns the largest position difference from SGP4 found over the
+     * whole span (km)
+     */
+    double MaxPositionError() const
+    {
+        return max_position_error_;
+    }
+
+    /**
+     * @returns the largest velocity difference from SGP4 found over the
+     * whole span (km/s)
+     */
+    double MaxVelocityError() const
+    {
+        return max_velocity_error_;
+    }
+
+    /**
+     * @param[in] i segment index
+     * @returns the largest position difference within segment i (km)
+     */
+    double SegmentPositionError(size_t i) const
+    {
+        return position_errors_[i];
+    }
+
+    /**
+     * @returns the memory held by the fit in bytes
+     */
+    size_t MemoryUsage() const;
+
+    /**
+     * @param[in] tsince minutes since epoch
+     * @returns whether tsince falls within the fitted span
+     */
+    bool Contains(double tsince) const
+    {
+        return tsince >= Start() && tsince <= End();
+    }
+
+    /**
+     * Evaluate the fit.
+     * @param[in] tsince minutes since epoch
+     * @exception std::out_of_range outside the fitted span
+     */
+    Eci FindPosition(double tsince) const;
+    Eci FindPosition(const DateTime& date) const;
+
+    /**
+     * Evaluate the fit without throwing.
+     * @param[in] tsince minutes since epoch
+     * @param[out] position position (km)
+     * @param[out] velocity velocity (km/s)
+     * @returns false if tsince is outside the fitted span
+     */
+    bool Evaluate(double tsince,
+                  Vector& position,
+                  Vector& velocity) const noexcept;
+
+    /**
+     * Position only form of Evaluate, which skips the velocity series.
+     */
+    bool Evaluate(double tsince, Vector& position) const noexcept;
+
+private:
+    void FitSegment(const SGP4& sgp4,
+                    size_t segment,
+                    SGP4::IntegratorParams& integ);
+
+    const double* Locate(double tsince, double& x) const noexcept;
+
+    DateTime epoch_;
+    double start_;
+    double segment_;
+    size_t segments_;
+    unsigned int degree_;
+
+    /*
+     * per segment, the coefficients of x, y, z, xdot, ydot, zdot in
+     * turn, degree_ + 1 each
+     */
+    std::vector<double> coefficients_;
+
+    std::vector<double> position_errors_;
+    double max_position_error_;
+    double max_velocity_error_;
+};
+
+}; // end namespace csgp4
+
+#endif
@@ -22,6 +22,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <chrono>
 #include <algorithm>
 #include <cassert>
@@ -53,7 +54,6 @@ namespace
     static const unsigned int ISO8601_COL_SEC  = 17;
     static const unsigned int ISO8601_LEN_SEC  = 2;
     static const unsigned int ISO8601_COL_MSEC = 19;
-    static const unsigned int ISO8601_LEN_MSEC = 4;
 }
 
 namespace csgp4
@@ -121,12 +121,12 @@ public:
     
     /**
      * Constructor
-     * @param[in] ISO8601 formatted Date and Time string
+     * @param[in] ISO8601 formatted Date and Time string, the fraction of
+     * the second kept to the microsecond
      */
     DateTime(const std::string iso8601)
     {
         std::string s;
-        double microsecond;
         int year = 1900, month = 1, day = 1, hour = 0, minute = 0, second = 0, usecond = 0;
         if(iso8601.length() < 24) return; // Minimum ISO8601 string length is 24.
         s = iso8601.substr(ISO8601_COL_YEAR, ISO8601_LEN_YEAR);
@@ -141,9 +141,8 @@ public:
         Extract(s, minute);
         s = iso8601.substr(ISO8601_COL_SEC,  ISO8601_LEN_SEC);
         Extract(s, second);
-        s = iso8601.substr(ISO8601_COL_MSEC, ISO8601_LEN_MSEC);
-        Extract(s, microsecond);
-        usecond = 1000000 * microsecond;
+        size_t pos = ISO8601_COL_MSEC;
+        usecond = ParseMicrosecond(iso8601, pos);
         Initialise(year, month, day, hour, minute, second, usecond);
     }
 
@@ -256,6 +255,28 @@ public:
         return valid;
     }
     
+    /**
+     * Read the fraction of a second after the seconds of an ISO8601 time,
+     * a point then any number of digits, those past the sixth truncated
+     * @param[in] text the ISO8601 time
+     * @param[in,out] pos where the fraction starts, then where it ends
+     * @returns the fraction in microseconds, 0 if there is no point at pos
+     */
+    static int ParseMicrosecond(std::string_view text, size_t& pos)
+    {
+        int microsecond = 0;
+        if (pos < text.size() && text[pos] == '.')
+        {
+            int scale = 100000;
+            for (pos++; pos < text.size() && text[pos] >= '0' && text[pos] <= '9'; pos++)
+            {
+                microsecond += (text[pos] - '0') * scale;
+                scale /= 10;
+            }
+        }
+        return microsecond;
+    }
+
     /**
      * Check whether the year/month/day is valid
      * @param[in] year the year to check
@@ -701,11 +722,6 @@ private:
         val = std::stoi(str);
     }
     
-    void Extract(const std::string& str, double& val)
-    {
-        val = std::stod(str);
-    }
-    
     int64_t m_encoded{};
 };
 
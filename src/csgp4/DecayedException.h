@@ -40,13 +40,7 @@ public:
      * @param[in] pos position of the satellite at dt
      * @param[in] vel velocity of the satellite at dt
      */
-    DecayedException(const DateTime& dt, const Vector& pos, const Vector& vel)
-        : runtime_error("Satellite decayed")
-        , _dt(dt)
-        , _pos(pos)
-        , _vel(vel)
-    {
-    }
+    DecayedException(const DateTime& dt, const Vector& pos, const Vector& vel);
 
     /**
      * @returns the date
@@ -0,0 +1,350 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef DUAL_H_
+#define DUAL_H_
+
+#include "Kepler.h"
+
+#include <cmath>
+#include <cstddef>
+
+namespace csgp4
+{
+
+/**
+ * @brief A forward mode automatic differentiation number.
+ *
+ * Holds a value and its partial derivatives with respect to N inputs.
+ * The arithmetic operators and the <cmath> functions the SGP4 kernel
+ * uses are overloaded to apply the chain rule, so running the kernel on
+ * Dual<N> gives the state and its derivatives in one pass. The values
+ * are computed with exactly the operations of the double kernel.
+ *
+ * Comparisons look at the value only, so every branch follows the path
+ * the double kernel would take. Where a value is clamped to a constant
+ * its derivatives become zero.
+ */
+template <size_t N>
+class Dual
+{
+public:
+    Dual()
+        : value(0.0), partials()
+    {
+    }
+
+    Dual(double v)
+        : value(v), partials()
+    {
+    }
+
+    /**
+     * @param[in] v the value
+     * @param[in] i the input this is, its partial is set to 1
+     * @returns an independent variable
+     */
+    static Dual Variable(double v, size_t i)
+    {
+        Dual x(v);
+        x.partials[i] = 1.0;
+        return x;
+    }
+
+    Dual& operator+=(const Dual& rhs)
+    {
+        value += rhs.value;
+        for (size_t i = 0; i < N; i++)
+        {
+            partials[i] += rhs.partials[i];
+        }
+        return *this;
+    }
+
+    Dual& operator-=(const Dual& rhs)
+    {
+        value -= rhs.value;
+        for (size_t i = 0; i < N; i++)
+        {
+            partials[i] -= rhs.partials[i];
+        }
+        return *this;
+    }
+
+    Dual& operator*=(const Dual& rhs)
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            partials[i] = partials[i] * rhs.value + value * rhs.partials[i];
+        }
+        value *= rhs.value;
+        return *this;
+    }
+
+    Dual& operator/=(const Dual& rhs)
+    {
+        const double inv = 1.0 / rhs.value;
+        value /= rhs.value;
+        for (size_t i = 0; i < N; i++)
+        {
+            partials[i] = (partials[i] - value * rhs.partials[i]) * inv;
+        }
+        return *this;
+    }
+
+    Dual& operator+=(double rhs)
+    {
+        value += rhs;
+        return *this;
+    }
+
+    Dual& operator-=(double rhs)
+    {
+        value -= rhs;
+        return *this;
+    }
+
+    Dual& operator*=(double rhs)
+    {
+        value *= rhs;
+        for (size_t i = 0; i < N; i++)
+        {
+            partials[i] *= rhs;
+        }
+        return *this;
+    }
+
+    Dual& operator/=(double rhs)
+    {
+        value /= rhs;
+        for (size_t i = 0; i < N; i++)
+        {
+            partials[i] /= rhs;
+        }
+        return *this;
+    }
+
+    friend Dual operator-(const Dual& x)
+    {
+        Dual r;
+        r.value = -x.value;
+        for (size_t i = 0; i < N; i++)
+        {
+            r.partials[i] = -x.partials[i];
+        }
+        return r;
+    }
+
+    friend Dual operator+(Dual lhs, const Dual& rhs) { return lhs += rhs; }
+    friend Dual operator-(Dual lhs, const Dual& rhs) { return lhs -= rhs; }
+    friend Dual operator*(Dual lhs, const Dual& rhs) { return lhs *= rhs; }
+    friend Dual operator/(Dual lhs, const Dual& rhs) { return lhs /= rhs; }
+    friend Dual operator+(Dual lhs, double rhs) { return lhs += rhs; }
+    friend Dual operator-(Dual lhs, double rhs) { return lhs -= rhs; }
+    friend Dual operator*(Dual lhs, double rhs) { return lhs *= rhs; }
+    friend Dual operator/(Dual lhs, double rhs) { return lhs /= rhs; }
+    friend Dual operator+(double lhs, Dual rhs) { return rhs += lhs; }
+    friend Dual operator*(double lhs, Dual rhs) { return rhs *= lhs; }
+
+    friend Dual operator-(double lhs, const Dual& rhs)
+    {
+        Dual r = -rhs;
+        r.value = lhs - rhs.value;
+        return r;
+    }
+
+    friend Dual operator/(double lhs, const Dual& rhs)
+    {
+        Dual r;
+        r.value = lhs / rhs.value;
+        const double scale = -r.value / rhs.value;
+        for (size_t i = 0; i < N; i++)
+        {
+            r.partials[i] = scale * rhs.partials[i];
+        }
+        return r;
+    }
+
+    friend bool operator<(const Dual& lhs, const Dual& rhs) { return lhs.value < rhs.value; }
+    friend bool operator>(const Dual& lhs, const Dual& rhs) { return lhs.value > rhs.value; }
+    friend bool operator<=(const Dual& lhs, const Dual& rhs) { return lhs.value <= rhs.value; }
+    friend bool operator>=(const Dual& lhs, const Dual& rhs) { return lhs.value >= rhs.value; }
+    friend bool operator<(const Dual& lhs, double rhs) { return lhs.value < rhs; }
+    friend bool operator>(const Dual& lhs, double rhs) { return lhs.value > rhs; }
+    friend bool operator<=(const Dual& lhs, double rhs) { return lhs.value <= rhs; }
+    friend bool operator>=(const Dual& lhs, double rhs) { return lhs.value >= rhs; }
+
+    /*
+     * the <cmath> functions, found by argument dependent lookup so the
+     * kernel calls them unqualified
+     */
+    friend Dual sin(const Dual& x)
+    {
+        return Chain(x, sin(x.value), cos(x.value));
+    }
+
+    friend Dual cos(const Dual& x)
+    {
+        return Chain(x, cos(x.value), -sin(x.value));
+    }
+
+    friend Dual sqrt(const Dual& x)
+    {
+        const double r = sqrt(x.value);
+        return Chain(x, r, 0.5 / r);
+    }
+
+    friend Dual fabs(const Dual& x)
+    {
+        return Chain(x, fabs(x.value), x.value < 0.0 ? -1.0 : 1.0);
+    }
+
+    friend Dual pow(const Dual& x, double p)
+    {
+        return Chain(x, pow(x.value, p), p * pow(x.value, p - 1.0));
+    }
+
+    /*
+     * the result differs from x by a multiple of y, which has no
+     * derivative
+     */
+    friend Dual fmod(const Dual& x, double y)
+    {
+        return Chain(x, fmod(x.value, y), 1.0);
+    }
+
+    friend Dual atan2(const Dual& y, const Dual& x)
+    {
+        const double inv = 1.0 / (x.value * x.value + y.value * y.value);
+        Dual r(atan2(y.value, x.value));
+        for (size_t i = 0; i < N; i++)
+        {
+            r.partials[i] = (x.value * y.partials[i] - y.value * x.partials[i]) * inv;
+        }
+        return r;
+    }
+
+    /*
+     * the FastMath.h functions, with the values of the double ones and
+     * the derivatives pow() would give
+     */
+    friend void SinCos(const Dual& x, Dual& s, Dual& c)
+    {
+        double sv;
+        double cv;
+        csgp4::SinCos(x.value, sv, cv);
+        s = Chain(x, sv, cv);
+        c = Chain(x, cv, -sv);
+    }
+
+    friend Dual Sin(const Dual& x)
+    {
+        return Chain(x, csgp4::Sin(x.value), csgp4::Cos(x.value));
+    }
+
+    friend Dual Cos(const Dual& x)
+    {
+        return Chain(x, csgp4::Cos(x.value), -csgp4::Sin(x.value));
+    }
+
+    friend Dual Atan2(const Dual& y, const Dual& x)
+    {
+        const double inv = 1.0 / (x.value * x.value + y.value * y.value);
+        Dual r(csgp4::Atan2(y.value, x.value));
+        for (size_t i = 0; i < N; i++)
+        {
+            r.partials[i] = (x.value * y.partials[i] - y.value * x.partials[i]) * inv;
+        }
+        return r;
+    }
+
+    friend Dual Cube(const Dual& x)
+    {
+        return Chain(x, csgp4::Cube(x.value), 3.0 * pow(x.value, 2.0));
+    }
+
+    friend Dual PowThreeHalves(const Dual& x)
+    {
+        return Chain(x, csgp4::PowThreeHalves(x.value), 1.5 * pow(x.value, 0.5));
+    }
+
+    /**
+     * Solve Keplers equation, as per Kepler::Solve(). The values are
+     * solved as doubles and the derivatives follow from the implicit
+     * function theorem at the solution, so they are exact rather than
+     * carried through the iterations.
+     */
+    friend int KeplerSolve(const Dual& capu,
+                           const Dual& axn,
+                           const Dual& ayn,
+                           const Dual& elsq,
+                           Dual& sinepw,
+                           Dual& cosepw,
+                           Dual& ecose,
+                           Dual& esine)
+    {
+        const int iterations = Kepler::Solve(capu.value,
+                                             axn.value,
+                                             ayn.value,
+                                             elsq.value,
+                                             sinepw.value,
+                                             cosepw.value,
+                                             ecose.value,
+                                             esine.value);
+
+        /*
+         * f = capu - epw + axn * sin(epw) - ayn * cos(epw) = 0
+         */
+        const double s = sinepw.value;
+        const double c = cosepw.value;
+        const double inv = 1.0 / (1.0 - ecose.value);
+        for (size_t i = 0; i < N; i++)
+        {
+            const double depw = (capu.partials[i]
+                    + s * axn.partials[i] - c * ayn.partials[i]) * inv;
+            sinepw.partials[i] = c * depw;
+            cosepw.partials[i] = -s * depw;
+            ecose.partials[i] = c * axn.partials[i] + s * ayn.partials[i]
+                - esine.value * depw;
+            esine.partials[i] = s * axn.partials[i] - c * ayn.partials[i]
+                + ecose.value * depw;
+        }
+
+        return iterations;
+    }
+
+    double value;
+    double partials[N];
+
+private:
+    /*
+     * f(x) given f(x) and f'(x)
+     */
+    static Dual Chain(const Dual& x, double f, double dfdx)
+    {
+        Dual r(f);
+        for (size_t i = 0; i < N; i++)
+        {
+            r.partials[i] = dfdx * x.partials[i];
+        }
+        return r;
+    }
+};
+
+}; // end namespace csgp4
+
+#endif
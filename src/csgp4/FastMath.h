@@ -0,0 +1,379 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef FASTMATH_H_
+#define FASTMATH_H_
+
+#include "Globals.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace csgp4
+{
+
+/**
+ * @brief Branch free replacements for the libm calls on the propagation
+ * path.
+ *
+ * Each is a straight line of arithmetic the compiler can inline and
+ * vectorise across lanes, unlike a libm call. The largest error of each,
+ * in units in the last place against libm, is given by its kUlps
+ * constant and checked by test_FastMath.
+ *
+ * The propagators only use these when the library is built with
+ * LIBCSGP4_FAST_MATH; see the functions after this class.
+ */
+class FastMath
+{
+public:
+    static const int kSinCosUlps = 1;
+    static const int kAtan2Ulps = 2;
+    static const int kCubeUlps = 1;
+    static const int kPowThreeHalvesUlps = 1;
+    static const int kPowTwoThirdsUlps = 4;
+
+    /**
+     * sin and cos with one argument reduction. The budget holds for
+     * |x| < 2^20 * pi / 2; beyond that the absolute error grows with
+     * |x| as the ulp of x itself does.
+     * @param[in] x the angle (radians)
+     * @param[out] s sin(x)
+     * @param[out] c cos(x)
+     */
+    static void SinCos(const double x, double& s, double& c)
+    {
+        /*
+         * x = n * pi / 2 + r, |r| <= pi / 4, with pi / 2 in three parts
+         * of 33 bits so every n * part is exact. The low bits of n give
+         * the quadrant
+         */
+        const double kInvPio2 = 6.36619772367581382433e-01;
+        const double kPio2_1 = 1.57079632673412561417e+00;
+        const double kPio2_2 = 6.07710050630396597660e-11;
+        const double kPio2_2t = 2.02226624879595063154e-21;
+        const double kPio2_3 = 2.02226624871116645580e-21;
+        const double kPio2_3t = 8.47842766036889956997e-32;
+        const double kRound = 6755399441055744.0; // 1.5 * 2^52
+
+        const double shifted = x * kInvPio2 + kRound;
+        const double n = shifted - kRound;
+        uint64_t bits;
+        std::memcpy(&bits, &shifted, sizeof(bits));
+        const uint64_t quadrant = bits & 3;
+
+        double t = x - n * kPio2_1;
+        double w = n * kPio2_2;
+        double r = t - w;
+        w = n * kPio2_2t - ((t - r) - w);
+        t = r;
+        w = n * kPio2_3;
+        r = t - w;
+        w = n * kPio2_3t - ((t - r) - w);
+        const double y0 = r - w;
+        const double y1 = (r - y0) - w;
+
+        /*
+         * minimax polynomials on [-pi / 4, pi / 4] carrying the tail y1
+         * of the reduced argument, as per fdlibm __kernel_sin / __kernel_cos
+         */
+        const double kS1 = -1.66666666666666324348e-01;
+        const double kS2 = 8.33333333332248946124e-03;
+        const double kS3 = -1.98412698298579493134e-04;
+        const double kS4 = 2.75573137070700676789e-06;
+        const double kS5 = -2.50507602534068634195e-08;
+        const double kS6 = 1.58969099521155010221e-10;
+        const double kC1 = 4.16666666666666019037e-02;
+        const double kC2 = -1.38888888888741095749e-03;
+        const double kC3 = 2.48015872894767294178e-05;
+        const double kC4 = -2.75573143513906633035e-07;
+        const double kC5 = 2.08757232129817482790e-09;
+        const double kC6 = -1.13596475577881948265e-11;
+
+        const double z = y0 * y0;
+        const double z2 = z * z;
+
+        const double sr = kS2 + z * (kS3 + z * kS4) + z * z2 * (kS5 + z * kS6);
+        const double v = z * y0;
+        const double sin_r = y0 - ((z * (0.5 * y1 - v * sr) - y1) - v * kS1);
+
+        const double cr = z * (kC1 + z * (kC2 + z * kC3))
+            + z2 * z2 * (kC4 + z * (kC5 + z * kC6));
+        const double hz = 0.5 * z;
+        const double cw = 1.0 - hz;
+        const double cos_r = cw + (((1.0 - cw) - hz) + (z * cr - y0 * y1));
+
+        const bool swap = (quadrant & 1) != 0;
+        const double sin_q = swap ? cos_r : sin_r;
+        const double cos_q = swap ? sin_r : cos_r;
+
+        s = (quadrant & 2) != 0 ? -sin_q : sin_q;
+        c = ((quadrant + 1) & 2) != 0 ? -cos_q : cos_q;
+    }
+
+    /**
+     * atan2 for finite arguments, 0 for (0, 0)
+     * @param[in] y, x the point
+     * @returns the angle of (x, y) from the x axis (radians)
+     */
+    static double Atan2(const double y, const double x)
+    {
+        const double kTanPio8 = 4.14213562373095034e-01;
+        const double kPio4Hi = 7.85398163397448278999e-01;
+        const double kPio4Lo = 3.06161699786838301793e-17;
+        const double kPio2Hi = 1.57079632679489655800e+00;
+        const double kPio2Lo = 6.12323399573676603587e-17;
+        const double kPiHi = 3.14159265358979311600e+00;
+        const double kPiLo = 1.22464679914735317720e-16;
+
+        const double kT0 = 3.33333333333329318027e-01;
+        const double kT1 = -1.99999999998764832476e-01;
+        const double kT2 = 1.42857142725034663711e-01;
+        const double kT3 = -1.11111104054623557880e-01;
+        const double kT4 = 9.09088713343650656196e-02;
+        const double kT5 = -7.69187620504482999495e-02;
+        const double kT6 = 6.66107313738753120669e-02;
+        const double kT7 = -5.83357013379057348645e-02;
+        const double kT8 = 4.97687799461593236017e-02;
+        const double kT9 = -3.65315727442169155270e-02;
+        const double kT10 = 1.62858201153657823623e-02;
+
+        /*
+         * atan of the ratio of the smaller to the larger, a in [0, 1],
+         * reduced to |t| <= tan(pi / 8) about 0 or pi / 4
+         */
+        const double ax = fabs(x);
+        const double ay = fabs(y);
+        const bool steep = ay > ax;
+        const double big = steep ? ay : ax;
+        const double small = steep ? ax : ay;
+        const double a = big > 0.0 ? small / big : 0.0;
+        const bool shift = a > kTanPio8;
+        const double t = shift ? (a - 1.0) / (a + 1.0) : a;
+        const double hi = shift ? kPio4Hi : 0.0;
+        const double lo = shift ? kPio4Lo : 0.0;
+
+        /*
+         * minimax polynomial, as per fdlibm atan
+         */
+        const double z = t * t;
+        const double w = z * z;
+        const double s1 = z * (kT0 + w * (kT2 + w * (kT4 + w * (kT6 + w * (kT8 + w * kT10)))));
+        const double s2 = w * (kT1 + w * (kT3 + w * (kT5 + w * (kT7 + w * kT9))));
+        double r = hi - ((t * (s1 + s2) - lo) - t);
+
+        /*
+         * back to the quadrant
+         */
+        r = steep ? kPio2Hi - (r - kPio2Lo) : r;
+        r = x < 0.0 ? kPiHi - (r - kPiLo) : r;
+
+        return std::copysign(r, y);
+    }
+
+    /**
+     * @param[in] x the value
+     * @returns x^3
+     */
+    static double Cube(const double x)
+    {
+        return x * x * x;
+    }
+
+    /**
+     * @param[in] x the value, x >= 0
+     * @returns x^1.5
+     */
+    static double PowThreeHalves(const double x)
+    {
+        return x * std::sqrt(x);
+    }
+
+    /**
+     * Not vectorised, cbrt is still a libm call, but a cheaper one than
+     * pow; its own error sets the budget
+     * @param[in] x the value, x >= 0
+     * @returns x^(2/3)
+     */
+    static double PowTwoThirds(const double x)
+    {
+        return x > 0.0 ? x / std::cbrt(x) : 0.0;
+    }
+};
+
+/*
+ * What the propagators call in place of sin, cos, atan2 and pow. Without
+ * LIBCSGP4_FAST_MATH these are the libm calls they replace, so results
+ * do not change by a bit; with it they are FastMath. Scalar types other
+ * than double and float provide their own overloads.
+ */
+#if defined(LIBCSGP4_FAST_MATH)
+
+inline void SinCos(const double x, double& s, double& c)
+{
+    FastMath::SinCos(x, s, c);
+}
+
+inline double Sin(const double x)
+{
+    double s;
+    double c;
+    FastMath::SinCos(x, s, c);
+    return s;
+}
+
+inline double Cos(const double x)
+{
+    double s;
+    double c;
+    FastMath::SinCos(x, s, c);
+    return c;
+}
+
+inline double Atan2(const double y, const double x)
+{
+    return FastMath::Atan2(y, x);
+}
+
+inline double Cube(const double x)
+{
+    return FastMath::Cube(x);
+}
+
+inline double PowThreeHalves(const double x)
+{
+    return FastMath::PowThreeHalves(x);
+}
+
+inline double PowTwoThirds(const double x)
+{
+    return FastMath::PowTwoThirds(x);
+}
+
+/*
+ * single precision goes through double and rounds
+ */
+inline void SinCos(const float x, float& s, float& c)
+{
+    double sd;
+    double cd;
+    FastMath::SinCos(x, sd, cd);
+    s = static_cast<float>(sd);
+    c = static_cast<float>(cd);
+}
+
+inline float Sin(const float x)
+{
+    return static_cast<float>(Sin(static_cast<double>(x)));
+}
+
+inline float Cos(const float x)
+{
+    return static_cast<float>(Cos(static_cast<double>(x)));
+}
+
+inline float Atan2(const float y, const float x)
+{
+    return static_cast<float>(FastMath::Atan2(y, x));
+}
+
+inline float Cube(const float x)
+{
+    return x * x * x;
+}
+
+inline float PowThreeHalves(const float x)
+{
+    return x * std::sqrt(x);
+}
+
+#else
+
+inline void SinCos(const double x, double& s, double& c)
+{
+    s = sin(x);
+    c = cos(x);
+}
+
+inline double Sin(const double x)
+{
+    return sin(x);
+}
+
+inline double Cos(const double x)
+{
+    return cos(x);
+}
+
+inline double Atan2(const double y, const double x)
+{
+    return atan2(y, x);
+}
+
+inline double Cube(const double x)
+{
+    return pow(x, 3.0);
+}
+
+inline double PowThreeHalves(const double x)
+{
+    return pow(x, 1.5);
+}
+
+inline double PowTwoThirds(const double x)
+{
+    return pow(x, kTWOTHIRD);
+}
+
+inline void SinCos(const float x, float& s, float& c)
+{
+    s = std::sin(x);
+    c = std::cos(x);
+}
+
+inline float Sin(const float x)
+{
+    return std::sin(x);
+}
+
+inline float Cos(const float x)
+{
+    return std::cos(x);
+}
+
+inline float Atan2(const float y, const float x)
+{
+    return std::atan2(y, x);
+}
+
+inline float Cube(const float x)
+{
+    return std::pow(x, 3.0f);
+}
+
+inline float PowThreeHalves(const float x)
+{
+    return std::pow(x, 1.5f);
+}
+
+#endif
+
+}; // end namespace csgp4
+
+#endif
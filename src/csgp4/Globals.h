@@ -33,6 +33,9 @@ const double kXJ3 = -2.53881e-6;
 const double kXJ4 = -1.65597e-6;
 
 /*
+ * WGS-72, as used by everything but the propagator, which takes its
+ * constants from the policies in GravityModel.h
+ *
  * alternative XKE
  * affects final results
  * aiaa-2006-6573
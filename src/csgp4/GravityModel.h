@@ -0,0 +1,117 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef GRAVITYMODEL_H_
+#define GRAVITYMODEL_H_
+
+namespace csgp4
+{
+
+/**
+ * @brief The earth gravity models the propagator can use.
+ *
+ * GRAVITY_WGS72 is the default and is what the element sets in the public
+ * catalogs are generated with. GRAVITY_WGS72_OLD is the original
+ * Spacetrack Report #3 set, with its truncated XKE. GRAVITY_WGS84 is
+ * provided for products that must be consistent with WGS-84.
+ * See aiaa-2006-6573.
+ */
+enum GravityModel
+{
+    GRAVITY_WGS72_OLD,
+    GRAVITY_WGS72,
+    GRAVITY_WGS84
+};
+
+/*
+ * Each policy holds the constants of one model as compile time constants.
+ * The propagator kernels are instantiated per policy so the constants are
+ * immediates rather than loads. XKE and QOMS2T need sqrt / pow, so they
+ * are written out to full double precision; they are bit identical to
+ *   XKE = 60.0 / sqrt(XKMPER^3 / MU)
+ *   QOMS2T = ((Q0 - S0) / XKMPER)^4
+ */
+
+/**
+ * @brief WGS-72 as per Spacetrack Report #3
+ */
+struct Wgs72OldGravity
+{
+    static const GravityModel kModel = GRAVITY_WGS72_OLD;
+
+    static constexpr double kAE = 1.0;
+    static constexpr double kMU = 398600.79964;
+    static constexpr double kXKMPER = 6378.135;
+    static constexpr double kXJ2 = 1.082616e-3;
+    static constexpr double kXJ3 = -2.53881e-6;
+    static constexpr double kXJ4 = -1.65597e-6;
+    static constexpr double kXKE = 0.0743669161;
+    static constexpr double kQOMS2T = 1.8802791590152709e-9;
+
+    static constexpr double kCK2 = 0.5 * kXJ2 * kAE * kAE;
+    static constexpr double kCK4 = -0.375 * kXJ4 * kAE * kAE * kAE * kAE;
+    static constexpr double kS = kAE * (1.0 + 78.0 / kXKMPER);
+    static constexpr double kA3OVK2 = -kXJ3 / kCK2 * kAE * kAE * kAE;
+};
+
+/**
+ * @brief WGS-72, the default
+ */
+struct Wgs72Gravity
+{
+    static const GravityModel kModel = GRAVITY_WGS72;
+
+    static constexpr double kAE = 1.0;
+    static constexpr double kMU = 398600.8;
+    static constexpr double kXKMPER = 6378.135;
+    static constexpr double kXJ2 = 1.082616e-3;
+    static constexpr double kXJ3 = -2.53881e-6;
+    static constexpr double kXJ4 = -1.65597e-6;
+    static constexpr double kXKE = 0.074366916133173422;
+    static constexpr double kQOMS2T = 1.8802791590152709e-9;
+
+    static constexpr double kCK2 = 0.5 * kXJ2 * kAE * kAE;
+    static constexpr double kCK4 = -0.375 * kXJ4 * kAE * kAE * kAE * kAE;
+    static constexpr double kS = kAE * (1.0 + 78.0 / kXKMPER);
+    static constexpr double kA3OVK2 = -kXJ3 / kCK2 * kAE * kAE * kAE;
+};
+
+/**
+ * @brief WGS-84
+ */
+struct Wgs84Gravity
+{
+    static const GravityModel kModel = GRAVITY_WGS84;
+
+    static constexpr double kAE = 1.0;
+    static constexpr double kMU = 398600.5;
+    static constexpr double kXKMPER = 6378.137;
+    static constexpr double kXJ2 = 1.08262998905e-3;
+    static constexpr double kXJ3 = -2.53215306e-6;
+    static constexpr double kXJ4 = -1.61098761e-6;
+    static constexpr double kXKE = 0.074366853168713845;
+    static constexpr double kQOMS2T = 1.8802768006108971e-9;
+
+    static constexpr double kCK2 = 0.5 * kXJ2 * kAE * kAE;
+    static constexpr double kCK4 = -0.375 * kXJ4 * kAE * kAE * kAE * kAE;
+    static constexpr double kS = kAE * (1.0 + 78.0 / kXKMPER);
+    static constexpr double kA3OVK2 = -kXJ3 / kCK2 * kAE * kAE * kAE;
+};
+
+}; // end namespace csgp4
+
+#endif
@@ -0,0 +1,311 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef KEPLER_H_
+#define KEPLER_H_
+
+#include "Globals.h"
+#include "FastMath.h"
+#include "Simd.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace csgp4
+{
+
+/**
+ * @brief Solves Keplers equation for the SGP4 short period terms.
+ *
+ * The equation is solved in terms of the modified eccentric anomaly epw
+ * using at most 10 Newton-Raphson iterations, the first one clamped to
+ * 1.25 * sqrt(elsq) and the rest second order, stopping once the
+ * residual is below 1.0e-12.
+ */
+class Kepler
+{
+public:
+    /**
+     * Number of lanes iterated in lockstep by SolveLanes()
+     */
+    static const size_t kLanes = 8;
+
+    /**
+     * Solve for a single satellite / time.
+     * @param[in] capu mean longitude less the node, wrapped to +/-2pi
+     * @param[in] axn e * cos(omega) long period term
+     * @param[in] ayn e * sin(omega) long period term
+     * @param[in] elsq axn * axn + ayn * ayn
+     * @param[out] sinepw sin of the solution
+     * @param[out] cosepw cos of the solution
+     * @param[out] ecose axn * cosepw + ayn * sinepw
+     * @param[out] esine axn * sinepw - ayn * cosepw
+     * @returns the number of iterations taken
+     */
+    static int Solve(const double capu,
+                     const double axn,
+                     const double ayn,
+                     const double elsq,
+                     double& sinepw,
+                     double& cosepw,
+                     double& ecose,
+                     double& esine)
+    {
+        double epw = capu;
+
+        sinepw = 0.0;
+        cosepw = 0.0;
+        ecose = 0.0;
+        esine = 0.0;
+
+        /*
+         * sensibility check for N-R correction
+         */
+        const double max_newton_naphson = 1.25 * fabs(sqrt(elsq));
+
+        bool kepler_running = true;
+        int i = 0;
+
+        for (; i < 10 && kepler_running; i++)
+        {
+            SinCos(epw, sinepw, cosepw);
+            ecose = axn * cosepw + ayn * sinepw;
+            esine = axn * sinepw - ayn * cosepw;
+
+            double f = capu - epw + esine;
+
+            if (fabs(f) < 1.0e-12)
+            {
+                kepler_running = false;
+            }
+            else
+            {
+                /*
+                 * 1st order Newton-Raphson correction
+                 */
+                const double fdot = 1.0 - ecose;
+                double delta_epw = f / fdot;
+
+                /*
+                 * 2nd order Newton-Raphson correction.
+                 * f / (fdot - 0.5 * d2f * f/fdot)
+                 */
+                if (i == 0)
+                {
+                    if (delta_epw > max_newton_naphson)
+                    {
+                        delta_epw = max_newton_naphson;
+                    }
+                    else if (delta_epw < -max_newton_naphson)
+                    {
+                        delta_epw = -max_newton_naphson;
+                    }
+                }
+                else
+                {
+                    delta_epw = f / (fdot + 0.5 * esine * delta_epw);
+                }
+
+                /*
+                 * Newton-Raphson correction of -F/DF
+                 */
+                epw += delta_epw;
+            }
+        }
+
+        return i;
+    }
+
+    /**
+     * Solve for n satellites / times, kLanes at a time in lockstep.
+     *
+     * Every lane follows exactly the iteration sequence of Solve(); lanes
+     * that have converged are masked out and keep their results while
+     * the others carry on, and the block stops as soon as every lane has
+     * converged. The results equal Solve() except where the compiler
+     * contracts a multiply-add in the vector build, which changes ecose
+     * and esine by no more than 1.0e-15 and the solution by no more than
+     * the 1.0e-12 convergence tolerance.
+     *
+     * With LIBCSGP4_FAST_MATH the branch free FastMath::SinCos runs inside
+     * the vectorised step, so the whole iteration is vector code.
+     * Otherwise sin and cos stay libm calls, one lane at a time, and only
+     * the arithmetic around them is vectorised.
+     * @param[in] n number of lanes
+     * @param[in] capu, axn, ayn, elsq inputs as per Solve(), n each
+     * @param[out] sinepw, cosepw, ecose, esine outputs as per Solve()
+     */
+    static void SolveLanes(const size_t n,
+                           const double* capu,
+                           const double* axn,
+                           const double* ayn,
+                           const double* elsq,
+                           double* sinepw,
+                           double* cosepw,
+                           double* ecose,
+                           double* esine)
+    {
+        for (size_t base = 0; base < n; base += kLanes)
+        {
+            if (n - base < kLanes)
+            {
+                /*
+                 * partial tail block
+                 */
+                for (size_t l = base; l < n; l++)
+                {
+                    Solve(capu[l], axn[l], ayn[l], elsq[l],
+                          sinepw[l], cosepw[l], ecose[l], esine[l]);
+                }
+                break;
+            }
+
+            SolveBlock(capu + base,
+                       axn + base,
+                       ayn + base,
+                       elsq + base,
+                       sinepw + base,
+                       cosepw + base,
+                       ecose + base,
+                       esine + base);
+        }
+    }
+
+private:
+    static void SolveBlock(const double* capu,
+                           const double* axn,
+                           const double* ayn,
+                           const double* elsq,
+                           double* sinepw,
+                           double* cosepw,
+                           double* ecose,
+                           double* esine)
+    {
+        double epw[kLanes];
+        double max_newton_naphson[kLanes];
+        double s[kLanes];
+        double c[kLanes];
+        int64_t running[kLanes];
+
+        CSGP4_PRAGMA_SIMD
+        for (size_t l = 0; l < kLanes; l++)
+        {
+            epw[l] = capu[l];
+            max_newton_naphson[l] = 1.25 * fabs(sqrt(elsq[l]));
+            running[l] = 1;
+            sinepw[l] = 0.0;
+            cosepw[l] = 0.0;
+            ecose[l] = 0.0;
+            esine[l] = 0.0;
+        }
+
+        for (int i = 0; i < 10; i++)
+        {
+#if !defined(LIBCSGP4_FAST_MATH)
+            /*
+             * libm sin and cos are calls, which would keep the step from
+             * vectorising, so they are taken a lane at a time first
+             */
+            for (size_t l = 0; l < kLanes; l++)
+            {
+                SinCos(epw[l], s[l], c[l]);
+            }
+#endif
+
+            /*
+             * the first step is split out so no lane loop branches on i
+             */
+            if (i == 0)
+            {
+                StepBlock<true>(capu, axn, ayn, max_newton_naphson, s, c,
+                                epw, running, sinepw, cosepw, ecose, esine);
+            }
+            else
+            {
+                StepBlock<false>(capu, axn, ayn, max_newton_naphson, s, c,
+                                 epw, running, sinepw, cosepw, ecose, esine);
+            }
+
+            int64_t any_running = 0;
+
+            for (size_t l = 0; l < kLanes; l++)
+            {
+                any_running |= running[l];
+            }
+
+            if (!any_running)
+            {
+                break;
+            }
+        }
+    }
+
+    template <bool kFirst>
+    static CSGP4_ALWAYS_INLINE void StepBlock(const double* capu,
+                                              const double* axn,
+                                              const double* ayn,
+                                              const double* max_newton_naphson,
+                                              double* s,
+                                              double* c,
+                                              double* epw,
+                                              int64_t* running,
+                                              double* sinepw,
+                                              double* cosepw,
+                                              double* ecose,
+                                              double* esine)
+    {
+        CSGP4_PRAGMA_SIMD
+        for (size_t l = 0; l < kLanes; l++)
+        {
+#if defined(LIBCSGP4_FAST_MATH)
+            SinCos(epw[l], s[l], c[l]);
+#endif
+            const double ec = axn[l] * c[l] + ayn[l] * s[l];
+            const double es = axn[l] * s[l] - ayn[l] * c[l];
+            const double f = capu[l] - epw[l] + es;
+            const double fdot = 1.0 - ec;
+            const bool active = running[l] != 0;
+
+            sinepw[l] = active ? s[l] : sinepw[l];
+            cosepw[l] = active ? c[l] : cosepw[l];
+            ecose[l] = active ? ec : ecose[l];
+            esine[l] = active ? es : esine[l];
+
+            double delta = f / fdot;
+            if (kFirst)
+            {
+                delta = delta > max_newton_naphson[l]
+                    ? max_newton_naphson[l] : delta;
+                delta = delta < -max_newton_naphson[l]
+                    ? -max_newton_naphson[l] : delta;
+            }
+            else
+            {
+                delta = f / (fdot + 0.5 * es * delta);
+            }
+
+            const bool step = active && !(fabs(f) < 1.0e-12);
+            epw[l] = step ? epw[l] + delta : epw[l];
+            running[l] = step ? 1 : 0;
+        }
+    }
+};
+
+}; // end namespace csgp4
+
+#endif
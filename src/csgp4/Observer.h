@@ -99,13 +99,7 @@ private:
     /**
      * @param[in] dt the date to update the observers position for
      */
-    void Update(const DateTime &dt)
-    {
-        if (m_eci != dt)
-        {
-            m_eci.Update(dt, m_geo);
-        }
-    }
+    void Update(const DateTime &dt);
 
     /** the observers position */
     CoordGeodetic m_geo;
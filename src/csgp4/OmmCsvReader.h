@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef OMMCSVREADER_H_
+#define OMMCSVREADER_H_
+
+#include "OmmRecord.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace csgp4
+{
+
+/**
+ * @brief A streaming reader of CCSDS OMM element sets in CSV.
+ *
+ * Reads the GP CSV of Celestrak and Space-Track: a header row naming the
+ * columns, then one row per satellite. Columns are matched to fields by
+ * their header, as described in OmmRecord; others are skipped, and an
+ * empty value counts as absent. Values may be quoted, with "" for a
+ * quote, but may not run over a line.
+ *
+ * The text is fed in pieces split anywhere. Rows are cut by finding the
+ * commas, quotes and line ends a block of 64 bytes at a time, which
+ * vectorises, and each record is handed on as its row ends.
+ *
+ * A row with a missing or invalid required value is reported to the
+ * error handler with its line.
+ */
+class OmmCsvReader
+{
+public:
+    typedef OmmRecord::RecordHandler RecordHandler;
+    typedef OmmRecord::ErrorHandler ErrorHandler;
+
+    /**
+     * @param[in] on_record called with each element set read
+     * @param[in] on_error called with each row that failed
+     */
+    OmmCsvReader(RecordHandler on_record, ErrorHandler on_error);
+
+    /**
+     * Read the next piece of the text
+     * @param[in] data the text
+     * @param[in] size length of the text in bytes
+     */
+    void Feed(const char* data, size_t size);
+
+    /**
+     * Finish reading, taking a last row without a line end
+     * @returns whether a header was read
+     */
+    bool Finish();
+
+    /**
+     * Read a later part of a file whose header another reader has read,
+     * so that a file can be read in parts in parallel
+     * @param[in] other the reader of the header
+     * @param[in] first_line line number of the first line to be fed
+     */
+    void ContinueFrom(const OmmCsvReader& other, size_t first_line);
+
+    /**
+     * @returns the number of the next line to be read
+     */
+    size_t Line() const
+    {
+        return line_;
+    }
+
+private:
+    size_t ReadRows(const char* data, size_t size);
+    void ReadValue(size_t column, std::string_view value);
+
+    RecordHandler on_record_;
+    ErrorHandler on_error_;
+
+    bool header_{};
+    std::vector<OmmRecord::Field> columns_;
+    size_t line_{ 1 };
+    std::string carry_;    // a row split between pieces
+    std::string unquoted_; // a quoted value with a quote in it
+    OmmRecord record_;
+};
+
+}; // end namespace csgp4
+
+#endif
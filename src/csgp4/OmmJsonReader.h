@@ -0,0 +1,120 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef OMMJSONREADER_H_
+#define OMMJSONREADER_H_
+
+#include "OmmRecord.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace csgp4
+{
+
+/**
+ * @brief A streaming reader of CCSDS OMM element sets in JSON.
+ *
+ * Reads the GP format served by Celestrak and Space-Track: an array of
+ * flat objects, one per satellite, keyed as described in OmmRecord.
+ * Numbers may also be given as strings, as Space-Track does, other keys
+ * are skipped and a sequence of objects without the array is accepted.
+ *
+ * The text is fed in pieces split anywhere and each record is handed on
+ * as soon as its closing brace is read, so no document is built and the
+ * memory used does not grow with the input.
+ *
+ * A record with a missing or invalid field is reported to the error
+ * handler with the line of its opening brace, and reading carries on. A
+ * syntax error is reported once and the rest of the input is ignored.
+ */
+class OmmJsonReader
+{
+public:
+    typedef OmmRecord::RecordHandler RecordHandler;
+    typedef OmmRecord::ErrorHandler ErrorHandler;
+
+    /**
+     * @param[in] on_record called with each element set read
+     * @param[in] on_error called with each record that failed
+     */
+    OmmJsonReader(RecordHandler on_record, ErrorHandler on_error);
+
+    /**
+     * Read the next piece of the text
+     * @param[in] data the text
+     * @param[in] size length of the text in bytes
+     */
+    void Feed(const char* data, size_t size);
+
+    /**
+     * Finish reading, reporting a document that ends part way through
+     * @returns whether the whole text was read without a syntax error
+     */
+    bool Finish();
+
+    /**
+     * @returns whether a syntax error has stopped the reader
+     */
+    bool Failed() const
+    {
+        return state_ == FAILED;
+    }
+
+private:
+    enum State
+    {
+        DOCUMENT,   // between records
+        OBJECT_KEY, // in a record, before a key or the closing brace
+        KEY,        // in a key
+        COLON,      // after a key
+        VALUE,      // before a value
+        STRING,     // in a string value
+        BARE,       // in a number or literal
+        NEXT,       // after a value
+        SKIP,       // in a nested value that is not read
+        FAILED
+    };
+
+    const char* ReadString(const char* p, const char* end, std::string* out, bool& done);
+    void SetField();
+    void SyntaxError(char c);
+
+    RecordHandler on_record_;
+    ErrorHandler on_error_;
+
+    State state_{ DOCUMENT };
+    bool in_array_{};
+    bool in_string_{};    // in a string inside a skipped value
+    bool escape_{};       // after a backslash
+    unsigned int unicode_{}; // hex digits of a \u escape still to come
+    uint32_t code_point_{};
+    unsigned int depth_{}; // of the skipped value
+    size_t line_{ 1 };
+
+    OmmRecord::Field field_{ OmmRecord::NONE };
+    OmmRecord::Field last_field_{ OmmRecord::NONE };
+    bool quoted_{};       // whether the value was a string
+    std::string key_;
+    std::string value_;
+    OmmRecord record_;
+};
+
+}; // end namespace csgp4
+
+#endif
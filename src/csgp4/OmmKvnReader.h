@@ -0,0 +1,84 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef OMMKVNREADER_H_
+#define OMMKVNREADER_H_
+
+#include "OmmRecord.h"
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace csgp4
+{
+
+/**
+ * @brief A streaming reader of CCSDS OMM element sets in KVN.
+ *
+ * Reads the keyword = value lines of the OMM KVN format, one message
+ * after another. Each CCSDS_OMM_VERS line starts a new element set, as
+ * does a field given twice, so messages without the header line are read
+ * too. Units in brackets after a value are dropped, COMMENT lines and
+ * keys other than those in OmmRecord are skipped.
+ *
+ * The text is fed in pieces split anywhere, and each record is handed on
+ * as the next one starts or the text finishes. A record with a missing or
+ * invalid required value, or a line that is not keyword = value, is
+ * reported to the error handler with the line the record starts on.
+ */
+class OmmKvnReader
+{
+public:
+    typedef OmmRecord::RecordHandler RecordHandler;
+    typedef OmmRecord::ErrorHandler ErrorHandler;
+
+    /**
+     * @param[in] on_record called with each element set read
+     * @param[in] on_error called with each record that failed
+     */
+    OmmKvnReader(RecordHandler on_record, ErrorHandler on_error);
+
+    /**
+     * Read the next piece of the text
+     * @param[in] data the text
+     * @param[in] size length of the text in bytes
+     */
+    void Feed(const char* data, size_t size);
+
+    /**
+     * Finish reading, handing on the last record
+     */
+    void Finish();
+
+private:
+    void ReadLine(std::string_view line);
+    void Start();
+
+    RecordHandler on_record_;
+    ErrorHandler on_error_;
+
+    size_t line_{ 1 };
+    bool in_record_{};
+    OmmRecord::Field last_field_{ OmmRecord::NONE };
+    std::string carry_; // a line split between pieces
+    OmmRecord record_;
+};
+
+}; // end namespace csgp4
+
+#endif
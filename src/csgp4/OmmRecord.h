@@ -0,0 +1,135 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef OMMRECORD_H_
+#define OMMRECORD_H_
+
+#include "Tle.h"
+#include "DateTime.h"
+#include "TleCatalog.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace csgp4
+{
+
+/**
+ * @brief One OMM element set being read, shared by the OMM readers.
+ *
+ * A reader starts a record, sets the fields it finds by their OMM key
+ * and ends it, which hands on a Tle or, if a field was missing or could
+ * not be read, an error. The strings are reused from one record to the
+ * next so a record costs no allocations of its own.
+ *
+ * The fields read are OBJECT_NAME, OBJECT_ID, EPOCH, MEAN_MOTION,
+ * ECCENTRICITY, INCLINATION, RA_OF_ASC_NODE, ARG_OF_PERICENTER,
+ * MEAN_ANOMALY, EPHEMERIS_TYPE, CLASSIFICATION_TYPE, NORAD_CAT_ID,
+ * REV_AT_EPOCH, BSTAR, MEAN_MOTION_DOT and MEAN_MOTION_DDOT; the EPOCH
+ * and the mean elements and NORAD_CAT_ID are required. The EPOCH is
+ * read to the microsecond.
+ */
+class OmmRecord
+{
+public:
+    typedef std::function<void(const Tle&)> RecordHandler;
+    typedef std::function<void(const TleCatalog::Error&)> ErrorHandler;
+
+    enum Field
+    {
+        NONE,
+        OBJECT_NAME,
+        OBJECT_ID,
+        EPOCH,
+        MEAN_MOTION,
+        ECCENTRICITY,
+        INCLINATION,
+        RA_OF_ASC_NODE,
+        ARG_OF_PERICENTER,
+        MEAN_ANOMALY,
+        EPHEMERIS_TYPE,
+        CLASSIFICATION_TYPE,
+        NORAD_CAT_ID,
+        REV_AT_EPOCH,
+        BSTAR,
+        MEAN_MOTION_DOT,
+        MEAN_MOTION_DDOT,
+        FIELD_COUNT
+    };
+
+    /**
+     * Look up a key, trying the field after last first since the
+     * servers write the keys in the same order every time
+     * @param[in] key the OMM key
+     * @param[in] last the field found before
+     * @returns the field, NONE for a key that is not read
+     */
+    static Field FindField(std::string_view key, Field last = NONE);
+
+    /**
+     * Start a record
+     * @param[in] line where it starts, for errors
+     */
+    void Begin(size_t line);
+
+    /**
+     * Set a field from its text, noting an error if it cannot be read
+     * @param[in] field the field
+     * @param[in] value the text
+     */
+    void Set(Field field, std::string_view value);
+
+    /**
+     * @returns whether the field has been set in this record
+     */
+    bool Has(Field field) const
+    {
+        return (seen_ & (1u << field)) != 0;
+    }
+
+    /**
+     * Note the field as invalid, whatever it holds
+     */
+    void Invalid(Field field);
+
+    /**
+     * Note an error in the record, the first one noted is reported
+     */
+    void Fail(std::string_view message);
+
+    /**
+     * Finish the record, handing on the element set or the error
+     */
+    void End(const RecordHandler& on_record, const ErrorHandler& on_error);
+
+private:
+    static bool ParseEpoch(std::string_view text, DateTime& epoch);
+    void Fail(const char* message, Field field);
+
+    size_t line_{};
+    uint32_t seen_{};
+    std::string error_;
+    TleArgs args_;
+    DateTime epoch_;
+};
+
+}; // end namespace csgp4
+
+#endif
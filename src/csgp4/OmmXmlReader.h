@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef OMMXMLREADER_H_
+#define OMMXMLREADER_H_
+
+#include "OmmRecord.h"
+
+#include <cstddef>
+#include <string>
+
+namespace csgp4
+{
+
+/**
+ * @brief A streaming reader of CCSDS OMM element sets in XML.
+ *
+ * Reads the OMM XML of Celestrak and Space-Track: an ndm document of omm
+ * elements, or a single omm element. Within each omm element the leaf
+ * elements named as the keys of OmmRecord are read, wherever they are in
+ * the header, metadata and data sections; namespace prefixes are dropped
+ * and entities and CDATA are decoded. An empty element counts as absent.
+ *
+ * The reader does not validate the document, nor does it check that tags
+ * other than omm are closed in order; it follows only enough of XML to
+ * find the text of the elements it wants. Comments, processing
+ * instructions and declarations are skipped.
+ *
+ * The text is fed in pieces split anywhere and each record is handed on
+ * as its omm element closes. A record with a missing or invalid required
+ * value is reported to the error handler with the line of its omm tag.
+ */
+class OmmXmlReader
+{
+public:
+    typedef OmmRecord::RecordHandler RecordHandler;
+    typedef OmmRecord::ErrorHandler ErrorHandler;
+
+    /**
+     * @param[in] on_record called with each element set read
+     * @param[in] on_error called with each record that failed
+     */
+    OmmXmlReader(RecordHandler on_record, ErrorHandler on_error);
+
+    /**
+     * Read the next piece of the text
+     * @param[in] data the text
+     * @param[in] size length of the text in bytes
+     */
+    void Feed(const char* data, size_t size);
+
+    /**
+     * Finish reading, reporting a document that ends part way through
+     * @returns whether the document was complete
+     */
+    bool Finish();
+
+private:
+    enum State
+    {
+        TEXT,
+        TAG_START,
+        TAG_NAME,
+        TAG_REST,
+        MARKUP,
+        COMMENT,
+        CDATA,
+        DECLARATION,
+        INSTRUCTION
+    };
+
+    void EndTag();
+    void SetField();
+
+    RecordHandler on_record_;
+    ErrorHandler on_error_;
+
+    State state_{ TEXT };
+    size_t line_{ 1 };
+    size_t tag_line_{ 1 };
+
+    bool closing_{};       // a </tag>
+    bool empty_{};         // a <tag/>
+    char quote_{};         // the quote of an attribute value, 0 outside one
+    size_t run_{};         // dashes, brackets or the like seen so far
+    size_t depth_{};       // of brackets in a declaration
+    std::string tag_;      // name of the tag being read
+    std::string markup_;   // what follows <! so far
+
+    bool in_record_{};
+    OmmRecord::Field field_{ OmmRecord::NONE };
+    OmmRecord::Field last_field_{ OmmRecord::NONE };
+    std::string value_;    // text of the field, entities not yet decoded
+    std::string decoded_;
+    OmmRecord record_;
+};
+
+}; // end namespace csgp4
+
+#endif
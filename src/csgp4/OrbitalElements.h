@@ -20,6 +20,7 @@
 
 #include "Util.h"
 #include "DateTime.h"
+#include "GravityModel.h"
 
 namespace csgp4
 {
@@ -32,7 +33,34 @@ class Tle;
 class OrbitalElements
 {
 public:
-    explicit OrbitalElements(const Tle& tle);
+    /**
+     * @param[in] tle the element set
+     * @param[in] model the gravity model to recover the elements with
+     */
+    explicit OrbitalElements(const Tle& tle, GravityModel model = GRAVITY_WGS72);
+
+    /**
+     * Build from mean elements directly, in the units of the accessors,
+     * e.g. to propagate a perturbed element set
+     * @param[in] mean_anomoly mean anomaly (radians)
+     * @param[in] ascending_node right ascension of the ascending node (radians)
+     * @param[in] argument_perigee argument of perigee (radians)
+     * @param[in] eccentricity eccentricity
+     * @param[in] inclination inclination (radians)
+     * @param[in] mean_motion mean motion (radians per minute)
+     * @param[in] bstar drag term
+     * @param[in] epoch epoch of the elements
+     * @param[in] model the gravity model to recover the elements with
+     */
+    OrbitalElements(double mean_anomoly,
+                    double ascending_node,
+                    double argument_perigee,
+                    double eccentricity,
+                    double inclination,
+                    double mean_motion,
+                    double bstar,
+                    const DateTime& epoch,
+                    GravityModel model = GRAVITY_WGS72);
 
     /*
      * XMO
@@ -130,6 +158,14 @@ public:
         return epoch_;
     }
 
+    /*
+     * the gravity model the elements were recovered with
+     */
+    GravityModel Gravity() const
+    {
+        return gravity_model_;
+    }
+
     /**
      * Dump this object to a string
      * @returns string
@@ -154,6 +190,17 @@ public:
 
 
 private:
+    friend class SGP4Snapshot;
+
+    /*
+     * for SGP4Snapshot, which restores the elements without recovering
+     * them
+     */
+    OrbitalElements() = default;
+
+    template <class Gravity>
+    void Recover();
+
     double mean_anomoly_;
     double ascending_node_;
     double argument_perigee_;
@@ -166,6 +213,7 @@ private:
     double perigee_;
     double period_;
     DateTime epoch_;
+    GravityModel gravity_model_;
 };
 
 }; // end namespace csgp4
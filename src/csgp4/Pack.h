@@ -0,0 +1,354 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PACK_H_
+#define PACK_H_
+
+#include "SGP4Kernel.h"
+#include "Kepler.h"
+#include "Simd.h"
+
+#include <cmath>
+#include <cstddef>
+
+namespace csgp4
+{
+
+/**
+ * @brief The result of comparing two packs, one flag per lane.
+ */
+template <size_t N>
+struct PackMask
+{
+    bool lanes[N];
+
+    /**
+     * @returns true if any lane is set
+     */
+    friend bool Any(const PackMask& mask)
+    {
+        bool any = false;
+        for (size_t l = 0; l < N; l++)
+        {
+            any = any || mask.lanes[l];
+        }
+        return any;
+    }
+};
+
+/**
+ * @brief N values of type T operated on together.
+ *
+ * Every operation is a straight loop over the lanes, which the compiler
+ * turns into vector instructions where the target has them, and the
+ * <cmath> functions are applied lane by lane. Constants given as double
+ * are converted to T first, so Pack<float, N> is computed entirely in
+ * single precision. Comparisons give a PackMask; use Any() to branch
+ * and Select() to pick per lane.
+ */
+template <class T, size_t N>
+class Pack
+{
+public:
+    typedef PackMask<N> Mask;
+
+    Pack()
+        : lanes()
+    {
+    }
+
+    /**
+     * @param[in] v value for every lane
+     */
+    Pack(double v)
+    {
+        CSGP4_PRAGMA_SIMD
+        for (size_t l = 0; l < N; l++)
+        {
+            lanes[l] = static_cast<T>(v);
+        }
+    }
+
+    /**
+     * @param[in] p N values, one per lane
+     * @returns the pack
+     */
+    static Pack Load(const T* p)
+    {
+        Pack r;
+        for (size_t l = 0; l < N; l++)
+        {
+            r.lanes[l] = p[l];
+        }
+        return r;
+    }
+
+    T& operator[](size_t l)
+    {
+        return lanes[l];
+    }
+
+    const T& operator[](size_t l) const
+    {
+        return lanes[l];
+    }
+
+#define CSGP4_PACK_ASSIGN(op) \
+    Pack& operator op(const Pack& rhs) \
+    { \
+        CSGP4_PRAGMA_SIMD \
+        for (size_t l = 0; l < N; l++) \
+        { \
+            lanes[l] op rhs.lanes[l]; \
+        } \
+        return *this; \
+    } \
+    Pack& operator op(double rhs) \
+    { \
+        const T v = static_cast<T>(rhs); \
+        CSGP4_PRAGMA_SIMD \
+        for (size_t l = 0; l < N; l++) \
+        { \
+            lanes[l] op v; \
+        } \
+        return *this; \
+    }
+
+    CSGP4_PACK_ASSIGN(+=)
+    CSGP4_PACK_ASSIGN(-=)
+    CSGP4_PACK_ASSIGN(*=)
+    CSGP4_PACK_ASSIGN(/=)
+#undef CSGP4_PACK_ASSIGN
+
+#define CSGP4_PACK_BINARY(op) \
+    friend Pack operator op(const Pack& lhs, const Pack& rhs) \
+    { \
+        Pack r; \
+        CSGP4_PRAGMA_SIMD \
+        for (size_t l = 0; l < N; l++) \
+        { \
+            r.lanes[l] = lhs.lanes[l] op rhs.lanes[l]; \
+        } \
+        return r; \
+    } \
+    friend Pack operator op(const Pack& lhs, double rhs) \
+    { \
+        return lhs op Pack(rhs); \
+    } \
+    friend Pack operator op(double lhs, const Pack& rhs) \
+    { \
+        return Pack(lhs) op rhs; \
+    }
+
+    CSGP4_PACK_BINARY(+)
+    CSGP4_PACK_BINARY(-)
+    CSGP4_PACK_BINARY(*)
+    CSGP4_PACK_BINARY(/)
+#undef CSGP4_PACK_BINARY
+
+#define CSGP4_PACK_COMPARE(op) \
+    friend Mask operator op(const Pack& lhs, const Pack& rhs) \
+    { \
+        Mask r; \
+        for (size_t l = 0; l < N; l++) \
+        { \
+            r.lanes[l] = lhs.lanes[l] op rhs.lanes[l]; \
+        } \
+        return r; \
+    } \
+    friend Mask operator op(const Pack& lhs, double rhs) \
+    { \
+        return lhs op Pack(rhs); \
+    }
+
+    CSGP4_PACK_COMPARE(<)
+    CSGP4_PACK_COMPARE(>)
+    CSGP4_PACK_COMPARE(<=)
+    CSGP4_PACK_COMPARE(>=)
+#undef CSGP4_PACK_COMPARE
+
+    friend Pack operator-(const Pack& x)
+    {
+        Pack r;
+        CSGP4_PRAGMA_SIMD
+        for (size_t l = 0; l < N; l++)
+        {
+            r.lanes[l] = -x.lanes[l];
+        }
+        return r;
+    }
+
+    friend Pack Select(const Mask& mask, const Pack& if_true, const Pack& if_false)
+    {
+        Pack r;
+        CSGP4_PRAGMA_SIMD
+        for (size_t l = 0; l < N; l++)
+        {
+            r.lanes[l] = mask.lanes[l] ? if_true.lanes[l] : if_false.lanes[l];
+        }
+        return r;
+    }
+
+    /*
+     * the <cmath> functions, found by argument dependent lookup so the
+     * kernel calls them unqualified
+     */
+#define CSGP4_PACK_FUNCTION(name) \
+    friend Pack name(const Pack& x) \
+    { \
+        Pack r; \
+        for (size_t l = 0; l < N; l++) \
+        { \
+            r.lanes[l] = std::name(x.lanes[l]); \
+        } \
+        return r; \
+    }
+
+    CSGP4_PACK_FUNCTION(sin)
+    CSGP4_PACK_FUNCTION(cos)
+    CSGP4_PACK_FUNCTION(sqrt)
+    CSGP4_PACK_FUNCTION(fabs)
+#undef CSGP4_PACK_FUNCTION
+
+    friend Pack pow(const Pack& x, double p)
+    {
+        Pack r;
+        for (size_t l = 0; l < N; l++)
+        {
+            r.lanes[l] = std::pow(x.lanes[l], static_cast<T>(p));
+        }
+        return r;
+    }
+
+    friend Pack fmod(const Pack& x, double y)
+    {
+        Pack r;
+        for (size_t l = 0; l < N; l++)
+        {
+            r.lanes[l] = std::fmod(x.lanes[l], static_cast<T>(y));
+        }
+        return r;
+    }
+
+    friend Pack atan2(const Pack& y, const Pack& x)
+    {
+        Pack r;
+        for (size_t l = 0; l < N; l++)
+        {
+            r.lanes[l] = std::atan2(y.lanes[l], x.lanes[l]);
+        }
+        return r;
+    }
+
+    /*
+     * the FastMath.h functions, lane by lane
+     */
+    friend void SinCos(const Pack& x, Pack& s, Pack& c)
+    {
+        for (size_t l = 0; l < N; l++)
+        {
+            csgp4::SinCos(x.lanes[l], s.lanes[l], c.lanes[l]);
+        }
+    }
+
+#define CSGP4_PACK_FAST_FUNCTION(name) \
+    friend Pack name(const Pack& x) \
+    { \
+        Pack r; \
+        for (size_t l = 0; l < N; l++) \
+        { \
+            r.lanes[l] = csgp4::name(x.lanes[l]); \
+        } \
+        return r; \
+    }
+
+    CSGP4_PACK_FAST_FUNCTION(Sin)
+    CSGP4_PACK_FAST_FUNCTION(Cos)
+    CSGP4_PACK_FAST_FUNCTION(Cube)
+    CSGP4_PACK_FAST_FUNCTION(PowThreeHalves)
+#undef CSGP4_PACK_FAST_FUNCTION
+
+    friend Pack Atan2(const Pack& y, const Pack& x)
+    {
+        Pack r;
+        for (size_t l = 0; l < N; l++)
+        {
+            r.lanes[l] = csgp4::Atan2(y.lanes[l], x.lanes[l]);
+        }
+        return r;
+    }
+
+    /**
+     * Solve Keplers equation for every lane, in lockstep with
+     * Kepler::SolveLanes() for double lanes and with the scalar
+     * KeplerSolve() one lane at a time otherwise
+     */
+    friend void KeplerSolve(const Pack& capu,
+                            const Pack& axn,
+                            const Pack& ayn,
+                            const Pack& elsq,
+                            Pack& sinepw,
+                            Pack& cosepw,
+                            Pack& ecose,
+                            Pack& esine)
+    {
+        SolveLanes(capu.lanes,
+                   axn.lanes,
+                   ayn.lanes,
+                   elsq.lanes,
+                   sinepw.lanes,
+                   cosepw.lanes,
+                   ecose.lanes,
+                   esine.lanes);
+    }
+
+    T lanes[N];
+
+private:
+    static void SolveLanes(const double* capu,
+                           const double* axn,
+                           const double* ayn,
+                           const double* elsq,
+                           double* sinepw,
+                           double* cosepw,
+                           double* ecose,
+                           double* esine)
+    {
+        Kepler::SolveLanes(N, capu, axn, ayn, elsq, sinepw, cosepw, ecose, esine);
+    }
+
+    template <class U>
+    static void SolveLanes(const U* capu,
+                           const U* axn,
+                           const U* ayn,
+                           const U* elsq,
+                           U* sinepw,
+                           U* cosepw,
+                           U* ecose,
+                           U* esine)
+    {
+        for (size_t l = 0; l < N; l++)
+        {
+            KeplerSolve(capu[l], axn[l], ayn[l], elsq[l],
+                        sinepw[l], cosepw[l], ecose[l], esine[l]);
+        }
+    }
+};
+
+}; // end namespace csgp4
+
+#endif
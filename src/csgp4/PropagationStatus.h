@@ -0,0 +1,57 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef PROPAGATIONSTATUS_H_
+#define PROPAGATIONSTATUS_H_
+
+namespace csgp4
+{
+
+/**
+ * @brief The outcome of a propagation that does not throw.
+ *
+ * Each error matches an exception of the throwing API. PROPAGATION_DECAYED
+ * matches DecayedException, the others SatelliteException.
+ */
+enum PropagationStatus
+{
+    PROPAGATION_OK = 0,
+    /*
+     * mean motion <= 0 after deep space secular effects
+     */
+    PROPAGATION_MEAN_MOTION,
+    /*
+     * perturbed eccentricity <= -0.001
+     */
+    PROPAGATION_ECCENTRICITY,
+    /*
+     * long period eccentricity squared >= 1
+     */
+    PROPAGATION_ELSQ,
+    /*
+     * negative semi-latus rectum
+     */
+    PROPAGATION_SEMI_LATUS,
+    /*
+     * radius below one earth radius, the state is still returned
+     */
+    PROPAGATION_DECAYED
+};
+
+}; // end namespace csgp4
+
+#endif
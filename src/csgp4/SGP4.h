@@ -24,6 +24,14 @@
 #include "Eci.h"
 #include "SatelliteException.h"
 #include "DecayedException.h"
+#include "PropagationStatus.h"
+#include "GravityModel.h"
+#include "SGP4Kernel.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace csgp4
 {
@@ -34,58 +42,316 @@ namespace csgp4
  * This documents the SGP4 tracking library.
  */
 
+template <class T> class BasicSGP4Batch;
+
 /**
  * @brief The simplified perturbations model 4 propagater.
  */
 class SGP4
 {
 public:
-    explicit SGP4(const Tle& tle)
-        : elements_(tle)
+    /**
+     * @brief State of the deep space resonance integrator.
+     *
+     * Resonant (12 hour and synchronous) orbits are integrated forward
+     * from epoch in fixed steps, and the state reached is kept so later
+     * calls can carry on from it rather than start again. A default
+     * constructed state is valid and simply starts from epoch.
+     *
+     * A state belongs to one satellite and must not be used by two
+     * threads at once. Passing your own state to FindPosition lets a
+     * single SGP4 object be shared by any number of threads.
+     */
+    struct IntegratorParams
+    {
+        double xli{};
+        double xni{};
+        double atime{};
+    };
+
+    /**
+     * @brief The mean elements the state is differentiated against.
+     */
+    enum Element
+    {
+        ELEMENT_INCLINATION,        // radians
+        ELEMENT_ASCENDING_NODE,     // radians
+        ELEMENT_ECCENTRICITY,
+        ELEMENT_ARGUMENT_PERIGEE,   // radians
+        ELEMENT_MEAN_ANOMALY,       // radians
+        ELEMENT_MEAN_MOTION,        // radians per minute
+        ELEMENT_BSTAR,
+        ELEMENT_COUNT
+    };
+
+    /**
+     * @brief Partial derivatives of the state with respect to the mean
+     * elements, in the units of OrbitalElements.
+     *
+     * Rows 0 to 2 are the position x, y, z (km) and rows 3 to 5 the
+     * velocity xdot, ydot, zdot (km/s); each column is an Element.
+     */
+    struct StateJacobian
+    {
+        double partials[6][ELEMENT_COUNT];
+    };
+
+    /**
+     * @param[in] tle the element set
+     * @param[in] model the gravity model, WGS-72 unless the element set
+     * was generated with another
+     * @exception SatelliteException
+     */
+    explicit SGP4(const Tle& tle, GravityModel model = GRAVITY_WGS72)
+        : elements_(tle, model)
     {
         Initialise();
     }
 
+    /**
+     * @param[in] elements the elements, with the gravity model they were
+     * recovered with
+     * @exception SatelliteException
+     */
+    explicit SGP4(const OrbitalElements& elements)
+        : elements_(elements)
+    {
+        Initialise();
+    }
+
+    SGP4(const SGP4& other);
+    SGP4(SGP4&& other) = default;
+    SGP4& operator=(const SGP4& other);
+    SGP4& operator=(SGP4&& other) = default;
+
+    /**
+     * Replace the element set, keeping the gravity model
+     * @param[in] tle the element set
+     * @exception SatelliteException
+     */
     void SetTle(const Tle& tle);
+
+    /**
+     * @returns the gravity model in use
+     */
+    GravityModel Gravity() const
+    {
+        return elements_.Gravity();
+    }
+
+    /**
+     * The memory held by this object. Near space satellites carry only
+     * the constants their model needs; the deep space constants and any
+     * integrator checkpoints are allocated only for deep space ones.
+     * @returns the size in bytes, including what is owned on the heap
+     */
+    size_t MemoryUsage() const;
+
+    /**
+     * Find the position at a time since epoch. The integrator state for
+     * resonant orbits is cached per thread, so these may be called on a
+     * shared object from several threads.
+     * @param[in] tsince minutes since epoch
+     * @exception SatelliteException
+     * @exception DecayedException
+     */
     Eci FindPosition(double tsince) const;
     Eci FindPosition(const DateTime& date) const;
 
+    /**
+     * Find the position using a caller owned integrator state.
+     * @param[in] tsince minutes since epoch
+     * @param[in,out] integ integrator state for this satellite
+     * @exception SatelliteException
+     * @exception DecayedException
+     */
+    Eci FindPosition(double tsince, IntegratorParams& integ) const;
+    Eci FindPosition(const DateTime& date, IntegratorParams& integ) const;
+
+    /**
+     * Find the position without throwing. Errors are returned instead,
+     * which avoids the cost of unwinding when sweeping whole catalogs.
+     * For PROPAGATION_DECAYED the position and velocity are still set,
+     * for other errors they are unspecified.
+     * @param[in] tsince minutes since epoch
+     * @param[out] position position (km)
+     * @param[out] velocity velocity (km/s)
+     * @returns the propagation status
+     */
+    PropagationStatus TryFindPosition(double tsince,
+                                      Vector& position,
+                                      Vector& velocity) const noexcept;
+    PropagationStatus TryFindPosition(double tsince,
+                                      IntegratorParams& integ,
+                                      Vector& position,
+                                      Vector& velocity) const noexcept;
+
+    /**
+     * Find the position only. The velocity terms (a pow, two square
+     * roots and the velocity rotation) are compiled out of this path.
+     * The position equals that of FindPosition exactly.
+     * @param[in] tsince minutes since epoch
+     * @returns the position (km)
+     * @exception SatelliteException
+     * @exception DecayedException, with a zero velocity
+     */
+    Vector FindPositionOnly(double tsince) const;
+    Vector FindPositionOnly(const DateTime& date) const;
+
+    /**
+     * Find the position only without throwing, as per TryFindPosition.
+     * @param[in] tsince minutes since epoch
+     * @param[out] position position (km)
+     * @returns the propagation status
+     */
+    PropagationStatus TryFindPositionOnly(double tsince,
+                                          Vector& position) const noexcept;
+    PropagationStatus TryFindPositionOnly(double tsince,
+                                          IntegratorParams& integ,
+                                          Vector& position) const noexcept;
+
+    /**
+     * Find the position and its partial derivatives with respect to the
+     * mean elements and B*, e.g. to propagate a covariance.
+     *
+     * Near space orbits run the model once on dual numbers (see
+     * SGP4Kernel and Dual), which gives exact derivatives of the model
+     * at the cost of about one initialisation and a few propagations.
+     * The position and velocity equal those of FindPosition. Deep space
+     * orbits fall back to central differences of perturbed models.
+     * @param[in] tsince minutes since epoch
+     * @param[out] jacobian the partial derivatives
+     * @exception SatelliteException
+     * @exception DecayedException
+     */
+    Eci FindPositionJacobian(double tsince, StateJacobian& jacobian) const;
+    Eci FindPositionJacobian(const DateTime& date, StateJacobian& jacobian) const;
+
+    /**
+     * Find the position and its partial derivatives without throwing, as
+     * per TryFindPosition
+     * @param[in] tsince minutes since epoch
+     * @param[out] position position (km)
+     * @param[out] velocity velocity (km/s)
+     * @param[out] jacobian the partial derivatives
+     * @returns the propagation status
+     */
+    PropagationStatus TryFindPositionJacobian(double tsince,
+                                              Vector& position,
+                                              Vector& velocity,
+                                              StateJacobian& jacobian) const noexcept;
+
+    /**
+     * Precompute resonance integrator checkpoints.
+     *
+     * The resonance integrator of 12 hour and synchronous orbits steps
+     * from epoch in 720 minute steps, so a query that goes back in time
+     * restarts at epoch. With checkpoints any query between start and
+     * end only integrates from the nearest step at or before it, which
+     * makes random order queries cheap. Results are identical to those
+     * without checkpoints. Does nothing for other orbits.
+     *
+     * Call this before sharing the object between threads.
+     * @param[in] start minutes since epoch to cover from
+     * @param[in] end minutes since epoch to cover to
+     */
+    void BuildIntegratorCheckpoints(double start, double end);
+
+    /**
+     * Discard any integrator checkpoints
+     */
+    void ClearIntegratorCheckpoints();
+
+    /**
+     * Propagate to a series of times in one call.
+     *
+     * The results are written into caller owned structure-of-arrays
+     * buffers, each of which must hold at least n values. Position is
+     * in kilometers and velocity in kilometers per second, as per Eci.
+     * @param[in] tsince minutes since epoch for each sample
+     * @param[in] n number of samples
+     * @param[out] x, y, z position for each sample
+     * @param[out] xdot, ydot, zdot velocity for each sample
+     * @exception SatelliteException
+     * @exception DecayedException
+     */
+    void FindPositions(const double* tsince,
+                       size_t n,
+                       double* x,
+                       double* y,
+                       double* z,
+                       double* xdot,
+                       double* ydot,
+                       double* zdot) const;
+
+    /**
+     * Propagate over a uniform time grid starting at start and
+     * advancing by step, writing n samples as per the array overload.
+     * @param[in] start minutes since epoch of the first sample
+     * @param[in] step minutes between samples
+     */
+    void FindPositions(double start,
+                       double step,
+                       size_t n,
+                       double* x,
+                       double* y,
+                       double* z,
+                       double* xdot,
+                       double* ydot,
+                       double* zdot) const;
+
+    /**
+     * As the array overload of FindPositions, but never throws; the
+     * outcome of each sample is written to status instead.
+     * @param[out] status status for each sample
+     */
+    void FindPositions(const double* tsince,
+                       size_t n,
+                       double* x,
+                       double* y,
+                       double* z,
+                       double* xdot,
+                       double* ydot,
+                       double* zdot,
+                       PropagationStatus* status) const noexcept;
+
+    /**
+     * Position only form of the status overload of FindPositions.
+     */
+    void FindPositions(const double* tsince,
+                       size_t n,
+                       double* x,
+                       double* y,
+                       double* z,
+                       PropagationStatus* status) const noexcept;
+
 private:
-    struct CommonConstants
-    {
-        double cosio;
-        double sinio;
-        double eta;
-        double t2cof;
-        double x1mth2;
-        double x3thm1;
-        double x7thm1;
-        double aycof;
-        double xlcof;
-        double xnodcf;
-        double c1;
-        double c4;
-        double omgdot; // secular rate of omega (radians/sec)
-        double xnodot; // secular rate of xnode (radians/sec)
-        double xmdot;  // secular rate of xmo   (radians/sec)
-    };
+    template <class T> friend class BasicSGP4Batch;
+    friend class SGP4Stepper;
+    friend class ChebyshevEphemeris;
+    friend class CatalogPropagator;
+    friend class SGP4Snapshot;
+
+    /*
+     * the constants are those of the kernel, see SGP4Kernel
+     */
+    typedef SGP4Kernel<double>::CommonConstants CommonConstants;
+    typedef SGP4Kernel<double>::NearSpaceConstants NearSpaceConstants;
 
-    struct NearSpaceConstants
+    struct IntegratorCheckpoints
     {
-        double c5;
-        double omgcof;
-        double xmcof;
-        double delmo;
-        double sinmo;
-        double d2;
-        double d3;
-        double d4;
-        double t3cof;
-        double t4cof;
-        double t5cof;
+        /*
+         * states[i] is the integrator state at atime = (first + i) * 720
+         */
+        int first;
+        std::vector<IntegratorParams> states;
     };
 
-    struct DeepSpaceConstants
+    /*
+     * the deep space constants themselves, all doubles so they can be
+     * copied as a block, see SGP4Snapshot
+     */
+    struct DeepSpaceTerms
     {
         double gsto;
         double zmol;
@@ -149,51 +415,101 @@ private:
          */
         double xfact;
         double xlamo;
+    };
 
+    struct DeepSpaceConstants : DeepSpaceTerms
+    {
         enum TOrbitShape
         {
             NONE,
             RESONANCE,
             SYNCHRONOUS
         } shape;
-    };
 
-    struct IntegratorParams
-    {
         /*
-         * integrator values
+         * see BuildIntegratorCheckpoints()
          */
-        double xli;
-        double xni;
-        double atime;
+        IntegratorCheckpoints checkpoints;
+    };
+
+    /*
+     * for SGP4Snapshot, which restores the constants itself
+     */
+    struct Restored
+    {
     };
-    
+
+    SGP4(const OrbitalElements& elements, Restored)
+        : elements_(elements)
+    {
+        Reset();
+    }
+
     void Initialise();
-    static void RecomputeConstants(const double xinc,
-                                   double& sinio,
-                                   double& cosio,
-                                   double& x3thm1,
-                                   double& x1mth2,
-                                   double& x7thm1,
-                                   double& xlcof,
-                                   double& aycof);
-    Eci FindPositionSDP4(const double tsince) const;
-    Eci FindPositionSGP4(double tsince) const;
-    static Eci CalculateFinalPositionVelocity(
-            const DateTime& date,
-            const double e,
-            const double a,
-            const double omega,
-            const double xl,
-            const double xnode,
-            const double xinc,
-            const double xlcof,
-            const double aycof,
-            const double x3thm1,
-            const double x1mth2,
-            const double x7thm1,
-            const double cosio,
-            const double sinio);
+    template <class Gravity>
+    void InitialiseModel();
+    SGP4Kernel<double>::Elements KernelElements() const;
+    IntegratorParams& ThreadIntegratorParams() const;
+    void FindPosition(double tsince,
+                      IntegratorParams& integ,
+                      Vector& position,
+                      Vector& velocity) const;
+    template <bool kVelocity>
+    PropagationStatus Propagate(double tsince,
+                                IntegratorParams& integ,
+                                Vector& position,
+                                Vector& velocity) const noexcept;
+    template <class Gravity, bool kVelocity>
+    PropagationStatus PropagateModel(double tsince,
+                                     IntegratorParams& integ,
+                                     Vector& position,
+                                     Vector& velocity) const noexcept;
+    /**
+     * FindPositions for every sample at time(i), the model dispatched once
+     * for the whole series; throws as FindPosition when status is null
+     */
+    template <bool kVelocity, class Time>
+    void PropagateSeries(Time time,
+                         size_t n,
+                         double* x,
+                         double* y,
+                         double* z,
+                         double* xdot,
+                         double* ydot,
+                         double* zdot,
+                         PropagationStatus* status) const;
+    template <class Gravity, bool kVelocity, class Time>
+    void PropagateSeries(Time time,
+                         size_t n,
+                         double* x,
+                         double* y,
+                         double* z,
+                         double* xdot,
+                         double* ydot,
+                         double* zdot,
+                         PropagationStatus* status) const;
+    template <class Gravity, bool kVelocity>
+    PropagationStatus FindPositionSDP4(const double tsince,
+                                       IntegratorParams& integ,
+                                       Vector& position,
+                                       Vector& velocity) const noexcept;
+    template <class Gravity, bool kVelocity>
+    PropagationStatus FindPositionSGP4(double tsince,
+                                       Vector& position,
+                                       Vector& velocity) const noexcept;
+    template <class Gravity>
+    PropagationStatus NearSpaceJacobian(double tsince,
+                                        Vector& position,
+                                        Vector& velocity,
+                                        StateJacobian& jacobian) const noexcept;
+    PropagationStatus DeepSpaceJacobian(double tsince,
+                                        Vector& position,
+                                        Vector& velocity,
+                                        StateJacobian& jacobian) const noexcept;
+    static void ThrowStatus(PropagationStatus status,
+                            const DateTime& date,
+                            const Vector& position,
+                            const Vector& velocity);
     /**
      * Deep space initialisation
      */
@@ -240,12 +556,16 @@ private:
     void Reset();
 
     /*
-     * the constants used
+     * the constants used, the deep space ones only for deep space
+     */
+    CommonConstants common_consts_;
+    NearSpaceConstants nearspace_consts_;
+    std::unique_ptr<DeepSpaceConstants> deepspace_consts_;
+
+    /*
+     * identifies these constants in the per thread integrator cache
      */
-    struct CommonConstants common_consts_;
-    struct NearSpaceConstants nearspace_consts_;
-    struct DeepSpaceConstants deepspace_consts_;
-    mutable struct IntegratorParams integrator_params_;
+    uint64_t instance_id_;
 
     /*
      * the orbit data
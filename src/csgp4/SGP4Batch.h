@@ -0,0 +1,400 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SGP4BATCH_H_
+#define SGP4BATCH_H_
+
+#include "Tle.h"
+#include "SGP4.h"
+#include "SGP4Kernel.h"
+#include "Pack.h"
+#include "DateTime.h"
+#include "Globals.h"
+#include "PropagationStatus.h"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace csgp4
+{
+
+/**
+ * @brief The secular update of N lanes of a batch, per lane type.
+ *
+ * Double lanes need nothing kept aside; SGP4Kernel::Propagate updates the
+ * mean anomaly, argument of perigee and node itself.
+ */
+template <class T, size_t N>
+struct BatchSecular
+{
+    void Scatter(size_t,
+                 const SGP4Kernel<double>::Elements&,
+                 const SGP4Kernel<double>::CommonConstants&)
+    {
+    }
+
+    void Gather(size_t, BatchSecular<T, 1>&) const
+    {
+    }
+
+    template <class Gravity, bool kVelocity, class Block>
+    PropagationStatus Propagate(const Block& block,
+                                const double* tsince,
+                                Pack<T, N>* position,
+                                Pack<T, N>* velocity) const
+    {
+        return Block::Kernel::template Propagate<Gravity, kVelocity>(block.elements,
+                                                                     block.use_simple_model,
+                                                                     block.common_consts,
+                                                                     block.nearspace_consts,
+                                                                     Pack<T, N>::Load(tsince),
+                                                                     position,
+                                                                     velocity);
+    }
+};
+
+/**
+ * Float lanes keep the epoch angles and their rates in double. The angles
+ * are updated in double and reduced to one revolution before the rest of
+ * the model runs in float; otherwise the error would grow with the number
+ * of revolutions since epoch.
+ */
+template <size_t N>
+struct BatchSecular<float, N>
+{
+    void Scatter(size_t lane,
+                 const SGP4Kernel<double>::Elements& elements,
+                 const SGP4Kernel<double>::CommonConstants& common_consts)
+    {
+        xmo[lane] = elements.mean_anomaly;
+        xmdot[lane] = common_consts.xmdot;
+        omegao[lane] = elements.argument_perigee;
+        omgdot[lane] = common_consts.omgdot;
+        xnodeo[lane] = elements.ascending_node;
+        xnodot[lane] = common_consts.xnodot;
+        xnodcf[lane] = common_consts.xnodcf;
+    }
+
+    void Gather(size_t lane, BatchSecular<float, 1>& to) const
+    {
+        to.xmo[0] = xmo[lane];
+        to.xmdot[0] = xmdot[lane];
+        to.omegao[0] = omegao[lane];
+        to.omgdot[0] = omgdot[lane];
+        to.xnodeo[0] = xnodeo[lane];
+        to.xnodot[0] = xnodot[lane];
+        to.xnodcf[0] = xnodcf[lane];
+    }
+
+    template <class Gravity, bool kVelocity, class Block>
+    PropagationStatus Propagate(const Block& block,
+                                const double* tsince,
+                                Pack<float, N>* position,
+                                Pack<float, N>* velocity) const
+    {
+        Pack<float, N> t;
+        Pack<float, N> xmdf;
+        Pack<float, N> omgadf;
+        Pack<float, N> xnode;
+
+        for (size_t l = 0; l < N; l++)
+        {
+            const double ts = tsince[l];
+
+            t[l] = static_cast<float>(ts);
+            xmdf[l] = static_cast<float>(fmod(xmo[l] + xmdot[l] * ts, kTWOPI));
+            omgadf[l] = static_cast<float>(fmod(omegao[l] + omgdot[l] * ts, kTWOPI));
+            xnode[l] = static_cast<float>(fmod(xnodeo[l] + xnodot[l] * ts
+                + xnodcf[l] * (ts * ts), kTWOPI));
+        }
+
+        return Block::Kernel::template PropagateSecular<Gravity, kVelocity>(block.elements,
+                                                                            block.use_simple_model,
+                                                                            block.common_consts,
+                                                                            block.nearspace_consts,
+                                                                            t,
+                                                                            xmdf,
+                                                                            omgadf,
+                                                                            xnode,
+                                                                            position,
+                                                                            velocity);
+    }
+
+    double xmo[N];
+    double xmdot[N];
+    double omegao[N];
+    double omgdot[N];
+    double xnodeo[N];
+    double xnodot[N];
+    double xnodcf[N];
+};
+
+/**
+ * @brief Propagates many satellites at once.
+ *
+ * The near space satellites are stored in blocks of Lanes(), every
+ * constant a Pack<T, Lanes()> the width of one 512 bit register, and run
+ * through SGP4Kernel so that the model evaluates several satellites per
+ * instruction. The constants are initialised in double by SGP4 and only
+ * then rounded to T; the secular update is that of BatchSecular. When
+ * built with LIBCSGP4_SIMD the kernel is compiled for AVX-512, AVX2 and a
+ * scalar fallback, and the best one for the host is picked at load time.
+ *
+ * Deep space satellites, and any satellite whose gravity model differs
+ * from the first, are kept in a separate queue and propagated with the
+ * double precision SDP4 model.
+ *
+ * Results are always returned in the order the satellites were given.
+ * Use it as SGP4Batch or SGP4BatchFloat.
+ */
+template <class T>
+class BasicSGP4Batch
+{
+public:
+    /**
+     * @param[in] tles the satellites to propagate
+     * @param[in] model the gravity model to propagate them with
+     * @exception SatelliteException
+     */
+    explicit BasicSGP4Batch(const std::vector<Tle>& tles,
+                            GravityModel model = GRAVITY_WGS72);
+
+    /**
+     * The near space kernel uses the gravity model of the first
+     * satellite; any satellite with a different model joins the deep
+     * space queue and is propagated with the scalar model.
+     * @param[in] models already initialised propagators
+     */
+    explicit BasicSGP4Batch(const std::vector<SGP4>& models);
+
+    /**
+     * @returns the number of satellites
+     */
+    size_t Size() const
+    {
+        return size_;
+    }
+
+    /**
+     * @returns the number of satellites using the near space kernel
+     */
+    size_t NearSpaceCount() const
+    {
+        return near_count_;
+    }
+
+    /**
+     * @returns the number of satellites using the deep space queue,
+     * which also takes those with a different gravity model
+     */
+    size_t DeepSpaceCount() const
+    {
+        return deep_index_.size();
+    }
+
+    /**
+     * @returns the number of satellites evaluated per kernel call
+     */
+    static size_t Lanes()
+    {
+        return kLanes;
+    }
+
+    /**
+     * @returns the memory held by the batch in bytes, including the
+     * blocks and the deep space queue
+     */
+    size_t MemoryUsage() const;
+
+    /**
+     * Propagate every satellite to the same date.
+     * @param[in] date the date to propagate to
+     * @param[out] x, y, z position of each satellite (km)
+     * @param[out] xdot, ydot, zdot velocity of each satellite (km/s)
+     * @exception SatelliteException
+     * @exception DecayedException
+     */
+    void FindPositions(const DateTime& date,
+                       T* x,
+                       T* y,
+                       T* z,
+                       T* xdot,
+                       T* ydot,
+                       T* zdot) const;
+
+    /**
+     * Propagate every satellite to its own time since epoch.
+     * @param[in] tsince minutes since epoch, one per satellite
+     * @param[out] x, y, z position of each satellite (km)
+     * @param[out] xdot, ydot, zdot velocity of each satellite (km/s)
+     * @exception SatelliteException
+     * @exception DecayedException
+     */
+    void FindPositions(const double* tsince,
+                       T* x,
+                       T* y,
+                       T* z,
+                       T* xdot,
+                       T* ydot,
+                       T* zdot) const;
+
+    /**
+     * Propagate every satellite to the same date without throwing. A
+     * satellite that fails is marked in status and the rest carry on.
+     * @param[in] date the date to propagate to
+     * @param[out] x, y, z position of each satellite (km)
+     * @param[out] xdot, ydot, zdot velocity of each satellite (km/s)
+     * @param[out] status outcome for each satellite
+     */
+    void FindPositions(const DateTime& date,
+                       T* x,
+                       T* y,
+                       T* z,
+                       T* xdot,
+                       T* ydot,
+                       T* zdot,
+                       PropagationStatus* status) const;
+
+    /**
+     * Propagate every satellite to its own time since epoch without
+     * throwing, as per the date overload.
+     * @param[in] tsince minutes since epoch, one per satellite
+     * @param[out] x, y, z position of each satellite (km)
+     * @param[out] xdot, ydot, zdot velocity of each satellite (km/s)
+     * @param[out] status outcome for each satellite
+     */
+    void FindPositions(const double* tsince,
+                       T* x,
+                       T* y,
+                       T* z,
+                       T* xdot,
+                       T* ydot,
+                       T* zdot,
+                       PropagationStatus* status) const noexcept;
+
+    /**
+     * Position only forms of the status overloads, which skip the
+     * velocity terms entirely.
+     * @param[out] x, y, z position of each satellite (km)
+     * @param[out] status outcome for each satellite
+     */
+    void FindPositions(const DateTime& date,
+                       T* x,
+                       T* y,
+                       T* z,
+                       PropagationStatus* status) const;
+    void FindPositions(const double* tsince,
+                       T* x,
+                       T* y,
+                       T* z,
+                       PropagationStatus* status) const noexcept;
+
+private:
+    static const size_t kLanes = 64 / sizeof(T);
+
+    /*
+     * N near space satellites sharing one simple model flag
+     */
+    template <size_t N>
+    struct Block
+    {
+        typedef SGP4Kernel<Pack<T, N> > Kernel;
+
+        typename Kernel::Elements elements;
+        typename Kernel::CommonConstants common_consts;
+        typename Kernel::NearSpaceConstants nearspace_consts;
+        bool use_simple_model;
+        BatchSecular<T, N> secular;
+
+        /*
+         * the satellite in each lane; padding lanes repeat the last one
+         */
+        size_t index[N];
+        size_t count;
+    };
+
+    /*
+     * the cloned kernel entry points, one per gravity model and mode
+     */
+    struct Entry;
+
+    void Build(const std::vector<SGP4>& models);
+
+    template <bool kVelocity>
+    void Propagate(const double* tsince,
+                   T* x,
+                   T* y,
+                   T* z,
+                   T* xdot,
+                   T* ydot,
+                   T* zdot,
+                   PropagationStatus* status) const noexcept;
+
+    template <class Gravity, bool kVelocity>
+    void PropagateNearSpace(const double* tsince,
+                            T* x,
+                            T* y,
+                            T* z,
+                            T* xdot,
+                            T* ydot,
+                            T* zdot,
+                            PropagationStatus* status) const noexcept;
+
+    template <class Gravity, bool kVelocity, size_t N>
+    static PropagationStatus PropagateBlock(const Block<N>& block,
+                                            const double* tsince,
+                                            T* out);
+
+    /*
+     * number of satellites
+     */
+    size_t size_;
+
+    /*
+     * near space blocks and the gravity model they are run with
+     */
+    std::vector<Block<kLanes> > blocks_;
+    GravityModel gravity_;
+    size_t near_count_;
+
+    /*
+     * deep space queue
+     */
+    std::vector<SGP4> deep_;
+    std::vector<size_t> deep_index_;
+
+    /*
+     * epoch of every satellite, in the order given
+     */
+    std::vector<DateTime> epochs_;
+};
+
+/**
+ * @brief Propagates many satellites at once in double precision.
+ *
+ * Results agree with SGP4::FindPosition to within 1.0e-8 km and
+ * 1.0e-11 km/s; any difference comes from fused multiply-add contraction
+ * in the vector builds.
+ */
+typedef BasicSGP4Batch<double> SGP4Batch;
+
+extern template class BasicSGP4Batch<double>;
+
+}; // end namespace csgp4
+
+#endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+
+#ifndef SGP4BATCHFLOAT_H_
+#define SGP4BATCHFLOAT_H_
+
+#include "SGP4Batch.h"
+
+namespace csgp4
+{
+
+/**
+ * @brief Propagates many satellites at once in single precision.
+ *
+ * For display and coarse screening, where a few metres of error do not
+ * matter. The near space satellites run with Pack<float, 16>, twice the
+ * lanes of SGP4Batch per vector register, and the constants take half the
+ * memory. Time since epoch is given in double and the secular angles are
+ * reduced to one revolution in double, see BatchSecular.
+ *
+ * Against SGP4::FindPosition on the near space cases of the SGP4-VER
+ * verification set (WGS-72, each case every 5 minutes out to 30 days
+ * either side of epoch, up to its first failure) the largest errors with
+ * |tsince| in each interval are
+ *
+ *     |tsince| (days)     0   to 0.25    to 1    to 3    to 7   to 14   to 30
+ *     position (m)        3        18      38      31      49     242    1686
+ *     velocity (m/s)  0.003     0.015   0.036   0.035   0.052   0.226   1.325
+ *
+ * The error grows with tsince through the drag terms, which are powers of
+ * tsince evaluated in float. Beyond 3 days the largest errors all come
+ * from COSMOS 2405, a decaying satellite run back from epoch; without it
+ * they stay below 60 m and 0.07 m/s out to 30 days.
+ *
+ * Deep space satellites, and any satellite whose gravity model differs
+ * from the first, are propagated with the double precision SDP4 model
+ * and the results rounded to float.
+ */
+typedef BasicSGP4Batch<float> SGP4BatchFloat;
+
+extern template class BasicSGP4Batch<float>;
+
+}; // end namespace csgp4
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SGP4CATALOG_H_
+#define SGP4CATALOG_H_
+
+#include "Tle.h"
+#include "SGP4.h"
+#include "GravityModel.h"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+namespace csgp4
+{
+
+/**
+ * @brief A catalog of initialised propagators keyed by norad number.
+ *
+ * Refreshing the catalog with a new set of element sets only
+ * re-initialises the satellites whose elements actually changed, in
+ * parallel and in place, so a periodic reload of the whole catalog costs
+ * little more than comparing it.
+ */
+class SGP4Catalog
+{
+public:
+    /**
+     * @brief Counts from Update()
+     */
+    struct UpdateResult
+    {
+        size_t unchanged{};
+        size_t updated{};
+        size_t added{};
+        size_t failed{};
+    };
+
+    /**
+     * @param[in] model the gravity model for every satellite
+     */
+    explicit SGP4Catalog(GravityModel model = GRAVITY_WGS72)
+        : gravity_(model)
+    {
+    }
+
+    /**
+     * Merge a set of element sets into the catalog.
+     *
+     * A satellite already in the catalog whose epoch and elements are
+     * unchanged is skipped. One that has changed is re-initialised in
+     * place, reusing its storage, with the work spread over threads.
+     * Satellites not seen before are appended and satellites absent from
+     * tles are left as they are. A changed element set that fails to
+     * initialise is counted as failed and the satellite keeps its
+     * previous elements; a new one that fails is not added.
+     * @param[in] tles the element sets
+     * @param[in] threads number of threads, 0 for one per core
+     * @returns what was done
+     */
+    UpdateResult Update(const std::vector<Tle>& tles, unsigned int threads = 0);
+
+    /**
+     * @returns the number of satellites
+     */
+    size_t Size() const
+    {
+        return models_.size();
+    }
+
+    /**
+     * @param[in] index position in the catalog, in order of addition
+     * @returns the propagator
+     */
+    const SGP4& At(size_t index) const
+    {
+        return models_[index];
+    }
+
+    /**
+     * @param[in] index position in the catalog, in order of addition
+     * @returns the element set the propagator was initialised with
+     */
+    const Tle& TleAt(size_t index) const
+    {
+        return tles_[index];
+    }
+
+    /**
+     * @param[in] norad_number the satellite
+     * @returns the propagator, or nullptr if it is not in the catalog
+     */
+    const SGP4* Find(unsigned int norad_number) const;
+
+    /**
+     * @returns every propagator, in order of addition
+     */
+    const std::vector<SGP4>& Models() const
+    {
+        return models_;
+    }
+
+private:
+    static bool SameElements(const Tle& a, const Tle& b);
+
+    GravityModel gravity_;
+    std::vector<SGP4> models_;
+    std::vector<Tle> tles_;
+    std::unordered_map<unsigned int, size_t> index_;
+};
+
+}; // end namespace csgp4
+
+#endif
@@ -0,0 +1,828 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SGP4KERNEL_H_
+#define SGP4KERNEL_H_
+
+#include "Globals.h"
+#include "FastMath.h"
+#include "Kepler.h"
+#include "PropagationStatus.h"
+#include "Stats.h"
+
+#include <cmath>
+
+namespace csgp4
+{
+
+/*
+ * Keplers equation for the double and float kernels, other scalar types
+ * provide their own overload. Float is solved in double, its 1.0e-12
+ * tolerance is out of reach in single precision.
+ */
+inline int KeplerSolve(const double capu,
+                       const double axn,
+                       const double ayn,
+                       const double elsq,
+                       double& sinepw,
+                       double& cosepw,
+                       double& ecose,
+                       double& esine)
+{
+    const int iterations =
+        Kepler::Solve(capu, axn, ayn, elsq, sinepw, cosepw, ecose, esine);
+    CSGP4_STATS_INC(KEPLER_SOLVES);
+    CSGP4_STATS_ADD(KEPLER_ITERATIONS, iterations);
+
+    return iterations;
+}
+
+inline int KeplerSolve(const float capu,
+                       const float axn,
+                       const float ayn,
+                       const float elsq,
+                       float& sinepw,
+                       float& cosepw,
+                       float& ecose,
+                       float& esine)
+{
+    double s;
+    double c;
+    double ec;
+    double es;
+    const int iterations = KeplerSolve(capu, axn, ayn, elsq, s, c, ec, es);
+
+    sinepw = static_cast<float>(s);
+    cosepw = static_cast<float>(c);
+    ecose = static_cast<float>(ec);
+    esine = static_cast<float>(es);
+
+    return iterations;
+}
+
+/*
+ * Branches of the kernel go through these so that a scalar type whose
+ * comparisons give one result per lane (see Pack) can be used. Any()
+ * is true if the condition holds for any lane, Select() picks per lane.
+ */
+inline bool Any(const bool condition)
+{
+    return condition;
+}
+
+template <class T>
+inline T Select(const bool condition, const T& if_true, const T& if_false)
+{
+    return condition ? if_true : if_false;
+}
+
+/**
+ * @brief The SGP4 model written against a scalar type.
+ *
+ * This is the one copy of the near space model and of the short period
+ * stage that SGP4 shares with its deep space model; SGP4 runs it with
+ * T = double. Any type with the arithmetic operators, comparisons
+ * against double and unqualified sin, cos, sqrt, fabs, pow, fmod, atan2,
+ * the FastMath.h functions Sin, Cos, SinCos, Atan2, Cube and
+ * PowThreeHalves, KeplerSolve, Any and Select can be used:
+ *
+ * - double, the library itself
+ * - float, where every named intermediate is rounded to single
+ *   precision; the expressions themselves promote to double through
+ *   their double constants, and Keplers equation is solved in double
+ * - Pack<T, N>, N satellites at once in lockstep, all lanes sharing one
+ *   simple model flag; a status other than PROPAGATION_OK means some
+ *   lane failed, and the failed lanes should be redone one at a time
+ * - Dual<N>, which gives the partial derivatives of the state
+ *
+ * Only Propagate() and FinalPositionVelocity() are needed per lane;
+ * Recover() and Initialise() branch on the orbit so take scalars.
+ * The elements must already have been checked by SGP4.
+ */
+template <class T>
+class SGP4Kernel
+{
+public:
+    struct Elements
+    {
+        T mean_anomaly;
+        T ascending_node;
+        T argument_perigee;
+        T eccentricity;
+        T inclination;
+        T mean_motion;
+        T bstar;
+        /*
+         * set by Recover()
+         */
+        T recovered_semi_major_axis;
+        T recovered_mean_motion;
+    };
+
+    struct CommonConstants
+    {
+        T cosio;
+        T sinio;
+        T eta;
+        T t2cof;
+        T x1mth2;
+        T x3thm1;
+        T x7thm1;
+        T aycof;
+        T xlcof;
+        T xnodcf;
+        T c1;
+        T c4;
+        T omgdot; // secular rate of omega (radians/sec)
+        T xnodot; // secular rate of xnode (radians/sec)
+        T xmdot;  // secular rate of xmo   (radians/sec)
+    };
+
+    struct NearSpaceConstants
+    {
+        T c5;
+        T omgcof;
+        T xmcof;
+        T delmo;
+        T sinmo;
+        T d2;
+        T d3;
+        T d4;
+        T t3cof;
+        T t4cof;
+        T t5cof;
+    };
+
+    /**
+     * Call f(from.x, to.x) for every field x of the elements or
+     * constants, e.g. to move one satellite into or out of a lane of a
+     * pack
+     * @param[in] from the elements or constants to read
+     * @param[in,out] to the elements or constants to write
+     * @param[in] f the function to call
+     */
+    template <class U, class F>
+    static void ForEachField(const typename SGP4Kernel<U>::Elements& from,
+                             Elements& to,
+                             F f)
+    {
+        f(from.mean_anomaly, to.mean_anomaly);
+        f(from.ascending_node, to.ascending_node);
+        f(from.argument_perigee, to.argument_perigee);
+        f(from.eccentricity, to.eccentricity);
+        f(from.inclination, to.inclination);
+        f(from.mean_motion, to.mean_motion);
+        f(from.bstar, to.bstar);
+        f(from.recovered_semi_major_axis, to.recovered_semi_major_axis);
+        f(from.recovered_mean_motion, to.recovered_mean_motion);
+    }
+
+    template <class U, class F>
+    static void ForEachField(const typename SGP4Kernel<U>::CommonConstants& from,
+                             CommonConstants& to,
+                             F f)
+    {
+        f(from.cosio, to.cosio);
+        f(from.sinio, to.sinio);
+        f(from.eta, to.eta);
+        f(from.t2cof, to.t2cof);
+        f(from.x1mth2, to.x1mth2);
+        f(from.x3thm1, to.x3thm1);
+        f(from.x7thm1, to.x7thm1);
+        f(from.aycof, to.aycof);
+        f(from.xlcof, to.xlcof);
+        f(from.xnodcf, to.xnodcf);
+        f(from.c1, to.c1);
+        f(from.c4, to.c4);
+        f(from.omgdot, to.omgdot);
+        f(from.xnodot, to.xnodot);
+        f(from.xmdot, to.xmdot);
+    }
+
+    template <class U, class F>
+    static void ForEachField(const typename SGP4Kernel<U>::NearSpaceConstants& from,
+                             NearSpaceConstants& to,
+                             F f)
+    {
+        f(from.c5, to.c5);
+        f(from.omgcof, to.omgcof);
+        f(from.xmcof, to.xmcof);
+        f(from.delmo, to.delmo);
+        f(from.sinmo, to.sinmo);
+        f(from.d2, to.d2);
+        f(from.d3, to.d3);
+        f(from.d4, to.d4);
+        f(from.t3cof, to.t3cof);
+        f(from.t4cof, to.t4cof);
+        f(from.t5cof, to.t5cof);
+    }
+
+    /**
+     * Convert elements or constants computed with another scalar type,
+     * e.g. to initialise in double and propagate in float, or to
+     * broadcast one satellite to every lane of a pack
+     * @param[in] from the elements or constants to convert
+     * @param[out] to the converted values
+     */
+    template <class U>
+    static void Convert(const typename SGP4Kernel<U>::Elements& from,
+                        Elements& to)
+    {
+        ForEachField<U>(from, to, ConvertField<U>);
+    }
+
+    template <class U>
+    static void Convert(const typename SGP4Kernel<U>::CommonConstants& from,
+                        CommonConstants& to)
+    {
+        ForEachField<U>(from, to, ConvertField<U>);
+    }
+
+    template <class U>
+    static void Convert(const typename SGP4Kernel<U>::NearSpaceConstants& from,
+                        NearSpaceConstants& to)
+    {
+        ForEachField<U>(from, to, ConvertField<U>);
+    }
+
+    /**
+     * Recover the original mean motion and semi major axis, as per
+     * OrbitalElements
+     * @param[in,out] elements the elements
+     */
+    template <class Gravity>
+    static void Recover(Elements& elements)
+    {
+        const T a1 = pow(Gravity::kXKE / elements.mean_motion, kTWOTHIRD);
+        const T cosio = cos(elements.inclination);
+        const T theta2 = cosio * cosio;
+        const T x3thm1 = 3.0 * theta2 - 1.0;
+        const T eosq = elements.eccentricity * elements.eccentricity;
+        const T betao2 = 1.0 - eosq;
+        const T betao = sqrt(betao2);
+        const T temp = (1.5 * Gravity::kCK2) * x3thm1 / (betao * betao2);
+        const T del1 = temp / (a1 * a1);
+        const T a0 = a1 * (1.0 - del1 * (1.0 / 3.0 + del1 * (1.0 + del1 * 134.0 / 81.0)));
+        const T del0 = temp / (a0 * a0);
+
+        elements.recovered_mean_motion = elements.mean_motion / (1.0 + del0);
+        elements.recovered_semi_major_axis = a0 / (1.0 - del0);
+    }
+
+    /**
+     * Generate the constants, as per SGP4 initialisation
+     * @param[in] elements recovered elements
+     * @param[out] use_simple_model set for perigee below 220 km
+     * @param[out] common_consts the constants of every orbit
+     * @param[out] nearspace_consts the near space constants, or nullptr
+     * for a deep space orbit which does not use them
+     */
+    template <class Gravity>
+    static void Initialise(const Elements& elements,
+                           bool& use_simple_model,
+                           CommonConstants& common_consts,
+                           NearSpaceConstants* nearspace_consts)
+    {
+        const T& aodp = elements.recovered_semi_major_axis;
+        const T& xnodp = elements.recovered_mean_motion;
+        const T& eo = elements.eccentricity;
+
+        RecomputeConstants<Gravity>(elements.inclination,
+                                    common_consts.sinio,
+                                    common_consts.cosio,
+                                    common_consts.x3thm1,
+                                    common_consts.x1mth2,
+                                    common_consts.x7thm1,
+                                    common_consts.xlcof,
+                                    common_consts.aycof);
+
+        const T theta2 = common_consts.cosio * common_consts.cosio;
+        const T eosq = eo * eo;
+        const T betao2 = 1.0 - eosq;
+        const T betao = sqrt(betao2);
+
+        const T perigee = (aodp * (1.0 - eo) - Gravity::kAE) * Gravity::kXKMPER;
+        use_simple_model = perigee < 220.0;
+
+        /*
+         * for perigee below 156km, the values of
+         * s4 and qoms2t are altered
+         */
+        T s4 = Gravity::kS;
+        T qoms24 = Gravity::kQOMS2T;
+        if (perigee < 156.0)
+        {
+            s4 = perigee - 78.0;
+            if (perigee < 98.0)
+            {
+                s4 = 20.0;
+            }
+            qoms24 = pow((120.0 - s4) * Gravity::kAE / Gravity::kXKMPER, 4.0);
+            s4 = s4 / Gravity::kXKMPER + Gravity::kAE;
+        }
+
+        /*
+         * generate constants
+         */
+        const T pinvsq = 1.0 / (aodp * aodp * betao2 * betao2);
+        const T tsi = 1.0 / (aodp - s4);
+        common_consts.eta = aodp * eo * tsi;
+        const T etasq = common_consts.eta * common_consts.eta;
+        const T eeta = eo * common_consts.eta;
+        const T psisq = fabs(1.0 - etasq);
+        const T coef = qoms24 * pow(tsi, 4.0);
+        const T coef1 = coef / pow(psisq, 3.5);
+        const T c2 = coef1 * xnodp
+            * (aodp * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq))
+            + 0.75 * Gravity::kCK2 * tsi / psisq * common_consts.x3thm1
+            * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+        common_consts.c1 = elements.bstar * c2;
+        common_consts.c4 = 2.0 * xnodp * coef1 * aodp * betao2
+            * (common_consts.eta * (2.0 + 0.5 * etasq) + eo * (0.5 + 2.0 * etasq)
+            - 2.0 * Gravity::kCK2 * tsi / (aodp * psisq)
+            * (-3.0 * common_consts.x3thm1 * (1.0 - 2.0 * eeta + etasq
+            * (1.5 - 0.5 * eeta))
+            + 0.75 * common_consts.x1mth2 * (2.0 * etasq - eeta *
+                (1.0 + etasq)) * cos(2.0 * elements.argument_perigee)));
+        const T theta4 = theta2 * theta2;
+        const T temp1 = 3.0 * Gravity::kCK2 * pinvsq * xnodp;
+        const T temp2 = temp1 * Gravity::kCK2 * pinvsq;
+        const T temp3 = 1.25 * Gravity::kCK4 * pinvsq * pinvsq * xnodp;
+        common_consts.xmdot = xnodp + 0.5 * temp1 * betao *
+                common_consts.x3thm1 + 0.0625 * temp2 * betao *
+                (13.0 - 78.0 * theta2 + 137.0 * theta4);
+        const T x1m5th = 1.0 - 5.0 * theta2;
+        common_consts.omgdot = -0.5 * temp1 * x1m5th +
+                0.0625 * temp2 * (7.0 - 114.0 * theta2 + 395.0 * theta4) +
+                temp3 * (3.0 - 36.0 * theta2 + 49.0 * theta4);
+        const T xhdot1 = -temp1 * common_consts.cosio;
+        common_consts.xnodot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * theta2) + 2.0 * temp3 *
+                (3.0 - 7.0 * theta2)) * common_consts.cosio;
+        common_consts.xnodcf = 3.5 * betao2 * xhdot1 * common_consts.c1;
+        common_consts.t2cof = 1.5 * common_consts.c1;
+
+        if (nearspace_consts == nullptr)
+        {
+            return;
+        }
+
+        T c3 = 0.0;
+        if (eo > 1.0e-4)
+        {
+            c3 = coef * tsi * Gravity::kA3OVK2 * xnodp * Gravity::kAE *
+                    common_consts.sinio / eo;
+        }
+
+        nearspace_consts->c5 = 2.0 * coef1 * aodp * betao2 * (1.0 + 2.75 *
+                (etasq + eeta) + eeta * etasq);
+        nearspace_consts->omgcof = elements.bstar * c3 * cos(elements.argument_perigee);
+
+        nearspace_consts->xmcof = 0.0;
+        if (eo > 1.0e-4)
+        {
+            nearspace_consts->xmcof = -kTWOTHIRD * coef * elements.bstar * Gravity::kAE / eeta;
+        }
+
+        nearspace_consts->delmo = Cube(1.0 + common_consts.eta * Cos(elements.mean_anomaly));
+        nearspace_consts->sinmo = sin(elements.mean_anomaly);
+
+        nearspace_consts->d2 = 0.0;
+        nearspace_consts->d3 = 0.0;
+        nearspace_consts->d4 = 0.0;
+        nearspace_consts->t3cof = 0.0;
+        nearspace_consts->t4cof = 0.0;
+        nearspace_consts->t5cof = 0.0;
+
+        if (!use_simple_model)
+        {
+            const T c1sq = common_consts.c1 * common_consts.c1;
+            nearspace_consts->d2 = 4.0 * aodp * tsi * c1sq;
+            const T temp = nearspace_consts->d2 * tsi * common_consts.c1 / 3.0;
+            nearspace_consts->d3 = (17.0 * aodp + s4) * temp;
+            nearspace_consts->d4 = 0.5 * temp * aodp *
+                    tsi * (221.0 * aodp + 31.0 * s4) * common_consts.c1;
+            nearspace_consts->t3cof = nearspace_consts->d2 + 2.0 * c1sq;
+            nearspace_consts->t4cof = 0.25 * (3.0 * nearspace_consts->d3 + common_consts.c1 *
+                    (12.0 * nearspace_consts->d2 + 10.0 * c1sq));
+            nearspace_consts->t5cof = 0.2 * (3.0 * nearspace_consts->d4 + 12.0 * common_consts.c1 *
+                    nearspace_consts->d3 + 6.0 * nearspace_consts->d2 * nearspace_consts->d2 + 15.0 *
+                    c1sq * (2.0 * nearspace_consts->d2 + c1sq));
+        }
+    }
+
+    /**
+     * The functions PropagateSecular() and FinalPositionVelocity() take
+     * of each sample, from the library functions. The sin and cos of the
+     * secular angles once drag and the short periodics have moved them
+     * come from the moved angles themselves, but each member is also
+     * given the move, so a caller that already holds the sin and cos of
+     * the unmoved angles can pass an object with the same members that
+     * rotates those by the move instead (SGP4Stepper).
+     */
+    struct DirectMath
+    {
+        T Cube(const T& x) const
+        {
+            using csgp4::Cube;
+            return Cube(x);
+        }
+
+        T PowThreeHalves(const T& x) const
+        {
+            using csgp4::PowThreeHalves;
+            return PowThreeHalves(x);
+        }
+
+        /**
+         * @returns cos of the secular mean anomaly xmdf
+         */
+        T CosMeanAnomaly(const T& xmdf) const
+        {
+            return Cos(xmdf);
+        }
+
+        /**
+         * @returns sin of xmp = xmdf + temp
+         */
+        T SinMeanAnomaly(const T& xmp, const T& /*temp*/) const
+        {
+            return Sin(xmp);
+        }
+
+        /**
+         * sin and cos of omega = omgadf - temp
+         */
+        void SinCosPerigee(const T& omega, const T& /*temp*/, T& s, T& c) const
+        {
+            SinCos(omega, s, c);
+        }
+
+        /**
+         * sin and cos of xnodek = xnode + delta
+         */
+        void SinCosNode(const T& xnodek, const T& /*delta*/, T& s, T& c) const
+        {
+            SinCos(xnodek, s, c);
+        }
+
+        /**
+         * sin and cos of xinck = xinc + delta, where sinio and cosio are
+         * those of xinc
+         */
+        void SinCosInclination(const T& xinck,
+                               const T& /*delta*/,
+                               const T& /*sinio*/,
+                               const T& /*cosio*/,
+                               T& s,
+                               T& c) const
+        {
+            SinCos(xinck, s, c);
+        }
+
+        /**
+         * sin and cos of uk = atan2(sinu, cosu) - delta
+         */
+        void SinCosLatitude(const T& sinu, const T& cosu, const T& delta, T& s, T& c) const
+        {
+            const T u = Atan2(sinu, cosu);
+            SinCos(u - delta, s, c);
+        }
+    };
+
+    /**
+     * Propagate, as per SGP4::FindPosition
+     * @param[in] elements recovered elements
+     * @param[in] use_simple_model, common_consts, nearspace_consts as set
+     * by Initialise()
+     * @param[in] tsince minutes since epoch
+     * @param[out] position x, y, z (km)
+     * @param[out] velocity xdot, ydot, zdot (km/s), untouched unless
+     * kVelocity
+     * @returns the propagation status
+     */
+    template <class Gravity, bool kVelocity>
+    static PropagationStatus Propagate(const Elements& elements,
+                                       const bool use_simple_model,
+                                       const CommonConstants& common_consts,
+                                       const NearSpaceConstants& nearspace_consts,
+                                       const T& tsince,
+                                       T* position,
+                                       T* velocity)
+    {
+        /*
+         * update for secular gravity
+         */
+        const T xmdf = elements.mean_anomaly
+            + common_consts.xmdot * tsince;
+        const T omgadf = elements.argument_perigee
+            + common_consts.omgdot * tsince;
+        const T xnoddf = elements.ascending_node
+            + common_consts.xnodot * tsince;
+        const T xnode = xnoddf + common_consts.xnodcf * (tsince * tsince);
+
+        return PropagateSecular<Gravity, kVelocity>(elements,
+                                                    use_simple_model,
+                                                    common_consts,
+                                                    nearspace_consts,
+                                                    tsince,
+                                                    xmdf,
+                                                    omgadf,
+                                                    xnode,
+                                                    position,
+                                                    velocity);
+    }
+
+    /**
+     * The rest of Propagate() from the secular mean anomaly, argument of
+     * perigee and node. A caller may update these in more precision than
+     * T and reduce them to one revolution first.
+     * @param[in] xmdf, omgadf, xnode the secular angles at tsince
+     * @param[in] math the functions of the sample, see DirectMath
+     */
+    template <class Gravity, bool kVelocity, class Math = DirectMath>
+    static PropagationStatus PropagateSecular(const Elements& elements,
+                                              const bool use_simple_model,
+                                              const CommonConstants& common_consts,
+                                              const NearSpaceConstants& nearspace_consts,
+                                              const T& tsince,
+                                              const T& xmdf,
+                                              const T& omgadf,
+                                              const T& xnode,
+                                              T* position,
+                                              T* velocity,
+                                              const Math& math = Math())
+    {
+        /*
+         * the final values
+         */
+        T e;
+        T a;
+        T omega;
+        T xl;
+        T sinomg;
+        T cosomg;
+        const T& xinc = elements.inclination;
+
+        /*
+         * update for atmospheric drag
+         */
+        omega = omgadf;
+        T xmp = xmdf;
+
+        const T tsq = tsince * tsince;
+        T tempa = 1.0 - common_consts.c1 * tsince;
+        T tempe = elements.bstar * common_consts.c4 * tsince;
+        T templ = common_consts.t2cof * tsq;
+
+        if (!use_simple_model)
+        {
+            const T delomg = nearspace_consts.omgcof * tsince;
+            const T delm = nearspace_consts.xmcof
+                * (math.Cube(1.0 + common_consts.eta * math.CosMeanAnomaly(xmdf))
+                        - nearspace_consts.delmo);
+            const T temp = delomg + delm;
+
+            xmp += temp;
+            omega -= temp;
+            math.SinCosPerigee(omega, temp, sinomg, cosomg);
+
+            const T tcube = tsq * tsince;
+            const T tfour = tsince * tcube;
+
+            tempa = tempa - nearspace_consts.d2 * tsq - nearspace_consts.d3
+                * tcube - nearspace_consts.d4 * tfour;
+            tempe += elements.bstar * nearspace_consts.c5
+                * (math.SinMeanAnomaly(xmp, temp) - nearspace_consts.sinmo);
+            templ += nearspace_consts.t3cof * tcube + tfour
+                * (nearspace_consts.t4cof + tsince * nearspace_consts.t5cof);
+        }
+        else
+        {
+            math.SinCosPerigee(omega, T(0.0), sinomg, cosomg);
+        }
+
+        a = elements.recovered_semi_major_axis * tempa * tempa;
+        e = elements.eccentricity - tempe;
+        xl = xmp + omega + xnode + elements.recovered_mean_motion * templ;
+
+        /*
+         * fix tolerance for error recognition
+         */
+        if (Any(e <= -0.001))
+        {
+            return PROPAGATION_ECCENTRICITY;
+        }
+        e = Select(e < 1.0e-6, T(1.0e-6), e);
+        e = Select(e > (1.0 - 1.0e-6), T(1.0 - 1.0e-6), e);
+
+        return FinalPositionVelocity<Gravity, kVelocity>(e,
+                                                         a,
+                                                         sinomg,
+                                                         cosomg,
+                                                         xl,
+                                                         xnode,
+                                                         xinc,
+                                                         common_consts.xlcof,
+                                                         common_consts.aycof,
+                                                         common_consts.x3thm1,
+                                                         common_consts.x1mth2,
+                                                         common_consts.x7thm1,
+                                                         common_consts.cosio,
+                                                         common_consts.sinio,
+                                                         position,
+                                                         velocity,
+                                                         math);
+    }
+
+    /**
+     * Long period periodics, Keplers equation and short period
+     * periodics, as per SGP4
+     * @param[in] sinomg, cosomg sin and cos of the argument of perigee
+     * @param[in] math the functions of the sample, see DirectMath
+     */
+    template <class Gravity, bool kVelocity, class Math = DirectMath>
+    static PropagationStatus FinalPositionVelocity(const T& e,
+                                                   const T& a,
+                                                   const T& sinomg,
+                                                   const T& cosomg,
+                                                   const T& xl,
+                                                   const T& xnode,
+                                                   const T& xinc,
+                                                   const T& xlcof,
+                                                   const T& aycof,
+                                                   const T& x3thm1,
+                                                   const T& x1mth2,
+                                                   const T& x7thm1,
+                                                   const T& cosio,
+                                                   const T& sinio,
+                                                   T* position,
+                                                   T* velocity,
+                                                   const Math& math = Math())
+    {
+        const T beta2 = 1.0 - e * e;
+        /*
+         * long period periodics
+         */
+        const T axn = e * cosomg;
+        const T temp11 = 1.0 / (a * beta2);
+        const T xll = temp11 * xlcof * axn;
+        const T aynl = temp11 * aycof;
+        const T xlt = xl + xll;
+        const T ayn = e * sinomg + aynl;
+        const T elsq = axn * axn + ayn * ayn;
+
+        if (Any(elsq >= 1.0))
+        {
+            return PROPAGATION_ELSQ;
+        }
+
+        /*
+         * solve keplers equation
+         */
+        const T capu = fmod(xlt - xnode, kTWOPI);
+
+        T sinepw;
+        T cosepw;
+        T ecose;
+        T esine;
+
+        KeplerSolve(capu, axn, ayn, elsq, sinepw, cosepw, ecose, esine);
+
+        /*
+         * short period preliminary quantities
+         */
+        const T temp21 = 1.0 - elsq;
+        const T pl = a * temp21;
+
+        if (Any(pl < 0.0))
+        {
+            return PROPAGATION_SEMI_LATUS;
+        }
+
+        const T r = a * (1.0 - ecose);
+        const T temp31 = 1.0 / r;
+        const T temp32 = a * temp31;
+        const T betal = sqrt(temp21);
+        const T temp33 = 1.0 / (1.0 + betal);
+        const T cosu = temp32 * (cosepw - axn + ayn * esine * temp33);
+        const T sinu = temp32 * (sinepw - ayn - axn * esine * temp33);
+        const T sin2u = 2.0 * sinu * cosu;
+        const T cos2u = 2.0 * cosu * cosu - 1.0;
+
+        /*
+         * update for short periodics
+         */
+        const T temp41 = 1.0 / pl;
+        const T temp42 = Gravity::kCK2 * temp41;
+        const T temp43 = temp42 * temp41;
+
+        const T rk = r * (1.0 - 1.5 * temp43 * betal * x3thm1)
+            + 0.5 * temp42 * x1mth2 * cos2u;
+        const T deluk = 0.25 * temp43 * x7thm1 * sin2u;
+        const T delnok = 1.5 * temp43 * cosio * sin2u;
+        const T xnodek = xnode + delnok;
+        const T delik = 1.5 * temp43 * cosio * sinio * cos2u;
+        const T xinck = xinc + delik;
+
+        /*
+         * orientation vectors
+         */
+        T sinuk;
+        T cosuk;
+        T sinik;
+        T cosik;
+        T sinnok;
+        T cosnok;
+        math.SinCosLatitude(sinu, cosu, deluk, sinuk, cosuk);
+        math.SinCosInclination(xinck, delik, sinio, cosio, sinik, cosik);
+        math.SinCosNode(xnodek, delnok, sinnok, cosnok);
+        const T xmx = -sinnok * cosik;
+        const T xmy = cosnok * cosik;
+        const T ux = xmx * sinuk + cosnok * cosuk;
+        const T uy = xmy * sinuk + sinnok * cosuk;
+        const T uz = sinik * sinuk;
+
+        position[0] = rk * ux * Gravity::kXKMPER;
+        position[1] = rk * uy * Gravity::kXKMPER;
+        position[2] = rk * uz * Gravity::kXKMPER;
+
+        if (kVelocity)
+        {
+            const T xn = Gravity::kXKE / math.PowThreeHalves(a);
+            const T rdot = Gravity::kXKE * sqrt(a) * esine * temp31;
+            const T rfdot = Gravity::kXKE * sqrt(pl) * temp31;
+            const T rdotk = rdot - xn * temp42 * x1mth2 * sin2u;
+            const T rfdotk = rfdot + xn * temp42 * (x1mth2 * cos2u + 1.5 * x3thm1);
+            const T vx = xmx * cosuk - cosnok * sinuk;
+            const T vy = xmy * cosuk - sinnok * sinuk;
+            const T vz = sinik * cosuk;
+
+            velocity[0] = (rdotk * ux + rfdotk * vx) * Gravity::kXKMPER / 60.0;
+            velocity[1] = (rdotk * uy + rfdotk * vy) * Gravity::kXKMPER / 60.0;
+            velocity[2] = (rdotk * uz + rfdotk * vz) * Gravity::kXKMPER / 60.0;
+        }
+
+        if (Any(rk < 1.0))
+        {
+            return PROPAGATION_DECAYED;
+        }
+
+        return PROPAGATION_OK;
+    }
+
+    template <class Gravity>
+    static void RecomputeConstants(const T& xinc,
+                                   T& sinio,
+                                   T& cosio,
+                                   T& x3thm1,
+                                   T& x1mth2,
+                                   T& x7thm1,
+                                   T& xlcof,
+                                   T& aycof)
+    {
+        sinio = sin(xinc);
+        cosio = cos(xinc);
+
+        const T theta2 = cosio * cosio;
+
+        x3thm1 = 3.0 * theta2 - 1.0;
+        x1mth2 = 1.0 - theta2;
+        x7thm1 = 7.0 * theta2 - 1.0;
+
+        if (fabs(cosio + 1.0) > 1.5e-12)
+        {
+            xlcof = 0.125 * Gravity::kA3OVK2 * sinio * (3.0 + 5.0 * cosio) / (1.0 + cosio);
+        }
+        else
+        {
+            xlcof = 0.125 * Gravity::kA3OVK2 * sinio * (3.0 + 5.0 * cosio) / 1.5e-12;
+        }
+
+        aycof = 0.25 * Gravity::kA3OVK2 * sinio;
+    }
+
+private:
+    template <class U>
+    static void ConvertField(const U& from, T& to)
+    {
+        to = static_cast<T>(from);
+    }
+};
+
+}; // end namespace csgp4
+
+#endif
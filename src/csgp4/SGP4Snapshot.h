@@ -0,0 +1,147 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SGP4SNAPSHOT_H_
+#define SGP4SNAPSHOT_H_
+
+#include "SGP4.h"
+#include "SGP4Catalog.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace csgp4
+{
+
+/**
+ * @brief A binary file of initialised propagators, mapped into memory.
+ *
+ * Saving writes the recovered elements and the constants SGP4 worked out
+ * for each satellite; loading maps the file and checks its header, so a
+ * process can start propagating a whole catalog without parsing a TLE or
+ * initialising a model. The propagators restored are identical to the
+ * ones saved, to the bit.
+ *
+ * The file is a header followed by fixed size records, one per
+ * satellite, and a table of the deep space constants of the deep space
+ * ones. The header carries a version, the byte order, record sizes and a
+ * fingerprint of the record fields it was written with and whether
+ * LIBCSGP4_FAST_MATH was on; a file that
+ * does not match this build in any of them is refused rather than
+ * converted, since the records are read in place. Integrator checkpoints
+ * are not saved.
+ *
+ * A snapshot is moveable but not copyable, it owns the mapping.
+ */
+class SGP4Snapshot
+{
+public:
+    /**
+     * the version of the file format written
+     */
+    static const uint32_t kVersion = 2;
+
+    SGP4Snapshot() = default;
+    SGP4Snapshot(SGP4Snapshot&& other) noexcept;
+    SGP4Snapshot& operator=(SGP4Snapshot&& other) noexcept;
+    SGP4Snapshot(const SGP4Snapshot&) = delete;
+    SGP4Snapshot& operator=(const SGP4Snapshot&) = delete;
+    ~SGP4Snapshot();
+
+    /**
+     * Save propagators to a file
+     * @param[in] path the file
+     * @param[in] models the propagators
+     * @param[in] norad_numbers the satellite of each propagator
+     * @returns whether the file was written
+     */
+    static bool Save(const std::string& path,
+                     const std::vector<SGP4>& models,
+                     const std::vector<unsigned int>& norad_numbers);
+
+    /**
+     * Save the propagators of a catalog to a file
+     * @param[in] path the file
+     * @param[in] catalog the catalog
+     * @returns whether the file was written
+     */
+    static bool Save(const std::string& path, const SGP4Catalog& catalog);
+
+    /**
+     * Map a file. A file that cannot be mapped, or was written by another
+     * version or build, gives an empty snapshot and an Error().
+     * @param[in] path the file
+     * @returns the snapshot
+     */
+    static SGP4Snapshot Load(const std::string& path);
+
+    /**
+     * @returns why the file could not be loaded, empty if it was
+     */
+    const std::string& Error() const
+    {
+        return error_;
+    }
+
+    /**
+     * @returns the number of propagators
+     */
+    size_t Size() const
+    {
+        return count_;
+    }
+
+    /**
+     * @param[in] index position in the file
+     * @returns the satellite
+     */
+    unsigned int NoradNumber(size_t index) const;
+
+    /**
+     * Restore a propagator, by copying its constants out of the file
+     * @param[in] index position in the file
+     * @returns the propagator
+     */
+    SGP4 Model(size_t index) const;
+
+    /**
+     * @returns every propagator, in file order
+     */
+    std::vector<SGP4> Models() const;
+
+private:
+    struct Header;
+    struct Record;
+    struct DeepSpaceRecord;
+
+    static uint64_t LayoutFingerprint();
+
+    void Unmap();
+
+    void* map_{};
+    size_t size_{};
+    size_t count_{};
+    const Record* records_{};
+    const DeepSpaceRecord* deep_space_records_{};
+    std::string error_;
+};
+
+}; // end namespace csgp4
+
+#endif
@@ -0,0 +1,146 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SGP4STEPPER_H_
+#define SGP4STEPPER_H_
+
+#include "SGP4.h"
+#include "Vector.h"
+#include "PropagationStatus.h"
+
+#include <cstddef>
+
+namespace csgp4
+{
+
+/**
+ * @brief Propagates one satellite along a uniform time grid.
+ *
+ * Dense ephemerides (1 Hz antenna pointing, ground tracks) evaluate the
+ * same satellite at evenly spaced times, so most of the trigonometry of
+ * the near space model can be carried from one sample to the next rather
+ * than recomputed. The secular mean anomaly and argument of perigee
+ * advance by a fixed angle per step and the node by a fixed second
+ * difference, so their sin / cos pairs are rotated by angle addition.
+ * The drag and short periodic corrections are small angles applied the
+ * same way, which removes the atan2 and the remaining sin / cos calls
+ * outside Keplers equation. The model itself is SGP4Kernel's, handed the
+ * rotated pairs through its per-sample functions (SGP4Kernel::DirectMath).
+ *
+ * The rotated pairs are rebuilt from the exact angles every
+ * renormalise_interval samples, bounding the rounding drift of the
+ * recurrences. Results agree with SGP4::FindPosition to within
+ * 1.0e-8 km and 1.0e-11 km/s; the default interval keeps the drift well
+ * below that.
+ *
+ * Deep space satellites are propagated with the scalar SDP4 model at
+ * each sample, carrying the resonance integrator from one to the next.
+ */
+class SGP4Stepper
+{
+public:
+    static const unsigned int kDefaultRenormaliseInterval = 256;
+
+    /**
+     * The propagator is copied, so the stepper may outlive it.
+     * @param[in] sgp4 the satellite to propagate
+     * @param[in] start minutes since epoch of the first sample
+     * @param[in] step minutes between samples
+     * @param[in] renormalise_interval samples between rebuilding the
+     * rotated sin / cos pairs from the exact angles
+     */
+    SGP4Stepper(const SGP4& sgp4,
+                double start,
+                double step,
+                unsigned int renormalise_interval = kDefaultRenormaliseInterval);
+
+    /**
+     * @returns minutes since epoch of the next sample
+     */
+    double Time() const
+    {
+        return start_ + step_ * static_cast<double>(index_);
+    }
+
+    /**
+     * @returns the number of samples taken so far
+     */
+    size_t Index() const
+    {
+        return index_;
+    }
+
+    /**
+     * Find the position and velocity at the next sample. The stepper
+     * moves on to the following sample whatever the outcome.
+     * @param[out] position position (km)
+     * @param[out] velocity velocity (km/s)
+     * @returns the propagation status
+     */
+    PropagationStatus Next(Vector& position, Vector& velocity) noexcept;
+
+    /**
+     * Find the position only at the next sample, as per Next().
+     * @param[out] position position (km)
+     * @returns the propagation status
+     */
+    PropagationStatus Next(Vector& position) noexcept;
+
+private:
+    struct Rotation
+    {
+        double s;
+        double c;
+    };
+
+    template <bool kVelocity>
+    PropagationStatus Step(Vector& position, Vector& velocity) noexcept;
+
+    template <class Gravity, bool kVelocity>
+    PropagationStatus StepNearSpace(double tsince,
+                                    Vector& position,
+                                    Vector& velocity) const noexcept;
+
+    void Renormalise();
+
+    SGP4 sgp4_;
+    SGP4::IntegratorParams integ_;
+
+    double start_;
+    double step_;
+    size_t index_;
+    unsigned int interval_;
+    unsigned int countdown_;
+
+    /*
+     * sin / cos of the secular mean anomaly, argument of perigee and
+     * node at the next sample, with the rotations that advance them.
+     * The node moves by node_step_, which itself advances by
+     * node_step2_ each sample.
+     */
+    Rotation xmdf_;
+    Rotation xmdf_step_;
+    Rotation omgadf_;
+    Rotation omgadf_step_;
+    Rotation xnode_;
+    Rotation node_step_;
+    Rotation node_step2_;
+};
+
+}; // end namespace csgp4
+
+#endif
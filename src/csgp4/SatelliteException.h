@@ -31,10 +31,7 @@ namespace csgp4
 class SatelliteException : public std::runtime_error
 {
 public:
-    explicit SatelliteException(const char* message)
-        : runtime_error(message)
-    {
-    }
+    explicit SatelliteException(const char* message);
 };
 
 }; // end namespace csgp4
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef SIMD_H_
+#define SIMD_H_
+
+/*
+ * Lane kernels are written as straight line passes over a block of lanes
+ * so the arithmetic vectorises. When the library is built with
+ * LIBCSGP4_SIMD the entry points are cloned for each instruction set and
+ * the best one for the host is picked at load time. Anything else that
+ * includes this header gets plain scalar code.
+ */
+#if defined(LIBCSGP4_SIMD) && defined(__GNUC__) && defined(__x86_64__)
+#define CSGP4_SIMD_CLONES \
+    __attribute__((target_clones("arch=skylake-avx512", "arch=haswell", "default")))
+#else
+#define CSGP4_SIMD_CLONES
+#endif
+
+/*
+ * Loop hints only mean something to a translation unit compiled with
+ * OpenMP, or with -fopenmp-simd and LIBCSGP4_OPENMP_SIMD as the build sets
+ * for the batch sources; anywhere else the pragma would only draw an
+ * "ignoring pragma" warning, so it expands to nothing.
+ */
+#if defined(_OPENMP) || defined(LIBCSGP4_OPENMP_SIMD)
+#define CSGP4_PRAGMA_SIMD _Pragma("omp simd")
+#else
+#define CSGP4_PRAGMA_SIMD
+#endif
+
+/*
+ * lane kernels shared by several cloned entry points are forced inline so
+ * each clone gets its own copy compiled for its instruction set
+ */
+#if defined(__GNUC__)
+#define CSGP4_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+#define CSGP4_ALWAYS_INLINE inline
+#endif
+
+/*
+ * likewise a cloned entry point built from a templated kernel has every
+ * call inlined into it, so none of the kernel runs in the default
+ * instruction set
+ */
+#if defined(__GNUC__)
+#define CSGP4_FLATTEN __attribute__((flatten))
+#else
+#define CSGP4_FLATTEN
+#endif
+
+#endif
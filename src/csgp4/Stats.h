@@ -0,0 +1,115 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <cstdint>
+
+namespace csgp4
+{
+
+/**
+ * @brief Counts of events inside the library.
+ */
+struct StatsCounters
+{
+    uint64_t kepler_solves{};
+    uint64_t kepler_iterations{};      // over all solves
+    uint64_t integrator_steps{};       // full resonance integrator steps
+    uint64_t integrator_restarts{};    // restarts from epoch
+    uint64_t integrator_checkpoints{}; // jumps to a checkpoint
+    uint64_t satellite_exceptions{};
+    uint64_t decayed_exceptions{};
+    uint64_t tle_exceptions{};
+    uint64_t observer_cache_hits{};    // observer position reused
+    uint64_t observer_cache_misses{};
+    uint64_t initialise_calls{};       // SGP4 model initialisations
+};
+
+/**
+ * @brief Counters of internal events, built in with LIBCSGP4_STATS.
+ *
+ * Every thread counts into its own counters, so counting needs no
+ * synchronisation; the totals of a thread are kept when it exits. Without
+ * LIBCSGP4_STATS the counting compiles away entirely and every snapshot
+ * is zero.
+ *
+ * The scalar propagation paths are counted. The Kepler solves of
+ * SGP4Batch, which run in lockstep across lanes, are not.
+ */
+class Stats
+{
+public:
+    enum Counter
+    {
+        KEPLER_SOLVES,
+        KEPLER_ITERATIONS,
+        INTEGRATOR_STEPS,
+        INTEGRATOR_RESTARTS,
+        INTEGRATOR_CHECKPOINTS,
+        SATELLITE_EXCEPTIONS,
+        DECAYED_EXCEPTIONS,
+        TLE_EXCEPTIONS,
+        OBSERVER_CACHE_HITS,
+        OBSERVER_CACHE_MISSES,
+        INITIALISE_CALLS,
+        COUNTER_COUNT
+    };
+
+    /**
+     * @returns whether the library was built with LIBCSGP4_STATS
+     */
+    static bool Enabled();
+
+    /**
+     * @returns the totals over every thread, running or finished
+     */
+    static StatsCounters Snapshot();
+
+    /**
+     * @returns the counts of the calling thread
+     */
+    static StatsCounters ThreadSnapshot();
+
+    /**
+     * Zero every counter. Counts made by other threads while this runs may
+     * or may not be kept.
+     */
+    static void Reset();
+
+    /**
+     * Count an event on the calling thread; used through CSGP4_STATS_ADD
+     */
+    static void Add(Counter counter, uint64_t n) noexcept;
+};
+
+}; // end namespace csgp4
+
+/*
+ * counting macros for use inside the library
+ */
+#if defined(LIBCSGP4_STATS)
+#define CSGP4_STATS_ADD(counter, n) \
+    csgp4::Stats::Add(csgp4::Stats::counter, static_cast<uint64_t>(n))
+#else
+#define CSGP4_STATS_ADD(counter, n) ((void)(n))
+#endif
+
+#define CSGP4_STATS_INC(counter) CSGP4_STATS_ADD(counter, 1)
+
+#endif
@@ -23,6 +23,9 @@
 #include "DateTime.h"
 #include "TleException.h"
 
+#include <string>
+#include <string_view>
+
 namespace csgp4
 {
 
@@ -78,7 +81,7 @@ public:
      * @param[in] line_one Tle line one
      * @param[in] line_two Tle line two
      */
-    Tle(std::string& line_one, std::string& line_two)
+    Tle(std::string_view line_one, std::string_view line_two)
         : line_one_(line_one)
         , line_two_(line_two)
     {
@@ -91,7 +94,7 @@ public:
      * @param[in] line_one Tle line one
      * @param[in] line_two Tle line two
      */
-    Tle(const std::string& name, std::string& line_one, std::string& line_two)
+    Tle(std::string_view name, std::string_view line_one, std::string_view line_two)
         : name_(name)
         , line_one_(line_one)
         , line_two_(line_two)
@@ -103,37 +106,30 @@ public:
      * Copy constructor
      * @param[in] tle Tle object to copy from
      */
-    Tle(const Tle& tle)
-    {
-        name_ = tle.name_;
-        line_one_ = tle.line_one_;
-        line_two_ = tle.line_two_;
-
-        norad_number_ = tle.norad_number_;
-        int_designator_ = tle.int_designator_;
-        epoch_ = tle.epoch_;
-        mean_motion_dt2_ = tle.mean_motion_dt2_;
-        mean_motion_ddt6_ = tle.mean_motion_ddt6_;
-        bstar_ = tle.bstar_;
-        inclination_ = tle.inclination_;
-        right_ascending_node_ = tle.right_ascending_node_;
-        eccentricity_ = tle.eccentricity_;
-        argument_perigee_ = tle.argument_perigee_;
-        mean_anomaly_ = tle.mean_anomaly_;
-        mean_motion_ = tle.mean_motion_;
-        orbit_number_ = tle.orbit_number_;
-        ephemeris_type_ = 0; // Not available in two line format.
-    }
+    Tle(const Tle& tle) = default;
+    Tle(Tle&& tle) = default;
+    Tle& operator=(const Tle& tle) = default;
+    Tle& operator=(Tle&& tle) = default;
     
-       /**
+    /**
      * @details Initialise given a TleArgs struct
      * @param[in] args The setup parameters.
      */
-    Tle(const TleArgs& args) :
+    Tle(const TleArgs& args)
+        : Tle(args, DateTime(args.epoch))
+    {}
+
+    /**
+     * @details Initialise given a TleArgs struct and an epoch already
+     * decoded, args.epoch is not read
+     * @param[in] args The setup parameters.
+     * @param[in] epoch The epoch.
+     */
+    Tle(const TleArgs& args, const DateTime& epoch) :
         name_(args.name),
         classification_type_(args.classification_type),
         int_designator_(args.int_designator),
-        epoch_(DateTime(args.epoch)),
+        epoch_(epoch),
         mean_motion_dt2_(args.mean_motion_dot),
         mean_motion_ddt6_(args.mean_motion_ddot),
         bstar_(args.bstar),
@@ -148,6 +144,39 @@ public:
         orbit_number_(args.orbit_number)
     {}
 
+    /**
+     * Replace the element set with the two lines of a tle, the name
+     * becoming the norad number. The fields are decoded straight from
+     * the lines and the strings already held are reused, so once the
+     * object has held a tle this does not allocate.
+     * @param[in] line_one Tle line one
+     * @param[in] line_two Tle line two
+     * @exception TleException, leaving the object unspecified
+     */
+    void SetLines(std::string_view line_one, std::string_view line_two)
+    {
+        name_.clear();
+        line_one_.assign(line_one.data(), line_one.size());
+        line_two_.assign(line_two.data(), line_two.size());
+        Initialize();
+    }
+
+    /**
+     * Replace the element set with a satellite name and the two lines of
+     * a tle, as SetLines(line_one, line_two)
+     * @param[in] name Satellite name
+     * @param[in] line_one Tle line one
+     * @param[in] line_two Tle line two
+     * @exception TleException, leaving the object unspecified
+     */
+    void SetLines(std::string_view name, std::string_view line_one, std::string_view line_two)
+    {
+        name_.assign(name.data(), name.size());
+        line_one_.assign(line_one.data(), line_one.size());
+        line_two_.assign(line_two.data(), line_two.size());
+        Initialize();
+    }
+
     /**
      * Get the satellite name
      * @returns the satellite name
@@ -382,10 +411,10 @@ public:
 
 private:
     void Initialize();
-    static bool IsValidLineLength(const std::string& str);
-    void ExtractInteger(const std::string& str, unsigned int& val);
-    void ExtractDouble(const std::string& str, int point_pos, double& val);
-    void ExtractExponential(const std::string& str, double& val);
+    static bool IsValidLineLength(std::string_view str);
+    static void ExtractInteger(std::string_view str, unsigned int& val);
+    static void ExtractDouble(std::string_view str, int point_pos, double& val);
+    static void ExtractExponential(std::string_view str, double& val);
 
 private:
     std::string name_;
@@ -0,0 +1,172 @@
+/*
+ * Copyright 2022 Andy Kirkham
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef TLECATALOG_H_
+#define TLECATALOG_H_
+
+#include "Tle.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace csgp4
+{
+
+/**
+ * @brief A bulk loaded set of element sets.
+ *
+ * Reads a whole 2LE or 3LE file at once. The file is mapped into memory,
+ * cut into chunks that each start on a record and the chunks are parsed
+ * in parallel, then joined in file order. A name line before line one is
+ * picked up as the satellite name, with the "0 " prefix of the 3LE format
+ * dropped, so a file may mix records with and without names.
+ *
+ * The OMM element sets of Celestrak and Space-Track are read too.
+ * LoadOmmCsvFile maps a CSV file and reads it in parallel chunks of rows
+ * with OmmCsvReader, while LoadOmmJsonFile, LoadOmmKvnFile and
+ * LoadOmmXmlFile stream the file through OmmJsonReader, OmmKvnReader and
+ * OmmXmlReader. All give the element sets the TleArgs constructor would.
+ *
+ * A record that fails to parse does not stop the load; it is left out
+ * and reported in Errors() with its line number.
+ */
+class TleCatalog
+{
+public:
+    /**
+     * @brief A record that could not be loaded
+     */
+    struct Error
+    {
+        size_t line{};       // first line of the record, from 1; 0 for the file
+        std::string message;
+    };
+
+    TleCatalog() = default;
+
+    /**
+     * Load a file. A file that cannot be opened or mapped gives an empty
+     * catalog with a single error on line 0.
+     * @param[in] path the file
+     * @param[in] threads number of threads, 0 for one per core
+     * @returns the catalog
+     */
+    static TleCatalog LoadFile(const std::string& path, unsigned int threads = 0);
+
+    /**
+     * Load a file of OMM element sets in JSON, see OmmJsonReader. A file
+     * that cannot be opened gives an empty catalog with a single error on
+     * line 0.
+     * @param[in] path the file
+     * @returns the catalog
+     */
+    static TleCatalog LoadOmmJsonFile(const std::string& path);
+
+    /**
+     * Load a file of OMM element sets in CSV, see OmmCsvReader. A file
+     * that cannot be opened or mapped gives an empty catalog with a
+     * single error on line 0.
+     * @param[in] path the file
+     * @param[in] threads number of threads, 0 for one per core
+     * @returns the catalog
+     */
+    static TleCatalog LoadOmmCsvFile(const std::string& path, unsigned int threads = 0);
+
+    /**
+     * Load a file of OMM element sets in KVN, see OmmKvnReader. A file
+     * that cannot be opened gives an empty catalog with a single error on
+     * line 0.
+     * @param[in] path the file
+     * @returns the catalog
+     */
+    static TleCatalog LoadOmmKvnFile(const std::string& path);
+
+    /**
+     * Load a file of OMM element sets in XML, see OmmXmlReader. A file
+     * that cannot be opened gives an empty catalog with a single error on
+     * line 0.
+     * @param[in] path the file
+     * @returns the catalog
+     */
+    static TleCatalog LoadOmmXmlFile(const std::string& path);
+
+    /**
+     * Load from text already in memory
+     * @param[in] data the text
+     * @param[in] size length of the text in bytes
+     * @param[in] threads number of threads, 0 for one per core
+     * @returns the catalog
+     */
+    static TleCatalog Parse(const char* data, size_t size, unsigned int threads = 0);
+
+    /**
+     * Load OMM CSV text already in memory
+     * @param[in] data the text
+     * @param[in] size length of the text in bytes
+     * @param[in] threads number of threads, 0 for one per core
+     * @returns the catalog
+     */
+    static TleCatalog ParseOmmCsv(const char* data, size_t size, unsigned int threads = 0);
+
+    /**
+     * @returns the number of element sets loaded
+     */
+    size_t Size() const
+    {
+        return tles_.size();
+    }
+
+    /**
+     * @param[in] index position in the file, counting loaded records only
+     * @returns the element set
+     */
+    const Tle& At(size_t index) const
+    {
+        return tles_[index];
+    }
+
+    /**
+     * @returns every element set, in file order
+     */
+    const std::vector<Tle>& Tles() const
+    {
+        return tles_;
+    }
+
+    /**
+     * @returns the records that failed, in file order
+     */
+    const std::vector<Error>& Errors() const
+    {
+        return errors_;
+    }
+
+private:
+    static TleCatalog LoadMapped(const std::string& path, unsigned int threads,
+                                 TleCatalog (*parse)(const char*, size_t, unsigned int));
+
+    template <typename Reader>
+    static TleCatalog LoadStreamed(const std::string& path);
+
+    std::vector<Tle> tles_;
+    std::vector<Error> errors_;
+};
+
+}; // end namespace csgp4
+
+#endif
@@ -37,10 +37,7 @@ public:
      * Constructor
      * @param message Exception message
      */
-    explicit TleException(const char* message)
-        : runtime_error(message)
-    {
-    }
+    explicit TleException(const char* message);
 };
 
 }; // end namespace csgp4
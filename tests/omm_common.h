@@ -0,0 +1,70 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#ifndef OMM_COMMON_H_
+#define OMM_COMMON_H_
+
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/Tle.h"
+#include "csgp4/TleCatalog.h"
+
+// Collects what an OMM reader hands on, for any of the OMM readers
+
+template <typename ReaderType>
+struct Collected
+{
+    std::vector<csgp4::Tle> tles;
+    std::vector<csgp4::TleCatalog::Error> errors;
+
+    ReaderType Reader()
+    {
+        return ReaderType(
+            [this](const csgp4::Tle& tle) { tles.push_back(tle); },
+            [this](const csgp4::TleCatalog::Error& error) { errors.push_back(error); });
+    }
+};
+
+// Read the whole of text in one piece, expecting Finish() to report
+// finished where the reader reports anything
+
+template <typename ReaderType>
+static Collected<ReaderType> Read(const std::string& text, bool finished = true)
+{
+    Collected<ReaderType> collected;
+    ReaderType reader = collected.Reader();
+    reader.Feed(text.data(), text.size());
+    if constexpr (std::is_void<decltype(reader.Finish())>::value)
+    {
+        reader.Finish();
+    }
+    else
+    {
+        EXPECT_EQ(finished, reader.Finish());
+    }
+    return collected;
+}
+
+#endif
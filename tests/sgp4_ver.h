@@ -0,0 +1,329 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#ifndef SGP4_VER_H_
+#define SGP4_VER_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "csgp4/Tle.h"
+#include "csgp4/PropagationStatus.h"
+
+// The element sets of the SGP4-VER.TLE verification set from "Revisiting
+// Spacetrack Report #3" (Vallado et al, AIAA 2006-6753): near space with
+// and without the simple drag model, deep space, 12 hour resonant, 24 hour
+// synchronous, decaying objects and the three deliberately broken ones.
+// Each is propagated from start to stop inclusive in steps, as per the
+// start / stop / step columns of that file.
+//
+// This library implements the original STR#3 model rather than the revised
+// one of the paper, so the expected results are not those of the paper's
+// tcppver.out. The reference values below were produced by the scalar
+// SGP4::TryFindPosition of this library and make the set a regression
+// check for it and an accuracy gate for every other propagation path.
+
+enum Regime
+{
+    REGIME_NEAR_SPACE,
+    REGIME_DEEP_SPACE,
+    REGIME_RESONANT_12H,
+    REGIME_SYNCHRONOUS_24H,
+    REGIME_ERROR
+};
+
+struct VerificationCase
+{
+    const char* name;
+    const char* line1;
+    const char* line2;
+    double start;
+    double stop;
+    double step;
+    Regime regime;
+};
+
+// samples is the number propagated before the first failure, if any, and
+// first / last are the first and last of those
+struct VerificationReference
+{
+    size_t samples;
+    csgp4::PropagationStatus failure;
+    double first_tsince;
+    double first_position[3];
+    double first_velocity[3];
+    double last_tsince;
+    double last_position[3];
+    double last_velocity[3];
+};
+
+static const VerificationCase kVerificationCases[] = {
+    {"TEME example",
+     "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753",
+     "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667",
+     0.00, 4320.0, 360.00, REGIME_NEAR_SPACE},
+    {"DELTA 1 DEB",
+     "1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985",
+     "2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774",
+     0.0, 2880.0, 120.00, REGIME_NEAR_SPACE},
+    {"MOLNIYA 2-14",
+     "1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813",
+     "2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656",
+     0.0, 2880.0, 120.00, REGIME_RESONANT_12H},
+    {"MOLNIYA 1-36",
+     "1 09880U 77021A   06176.56157475  .00000421  00000-0  10000-3 0  9814",
+     "2 09880  64.5968 349.3786 7069051 270.0229  16.3320  2.00813614112380",
+     0.0, 2880.0, 120.00, REGIME_RESONANT_12H},
+    {"04632",
+     "1 04632U 70093B   04031.91070959 -.00000084  00000-0  10000-3 0  9955",
+     "2 04632  11.4628 273.1101 1450506 207.6000 143.9350  1.20231981 44145",
+     -5184.0, -4896.0, 120.00, REGIME_DEEP_SPACE},
+    {"SMS 1 AKM",
+     "1 09998U 74033F   05148.79417928 -.00000112  00000-0  00000+0 0  4480",
+     "2 09998   9.4958 313.1750 0270971 327.5225  30.8097  1.16186785 45878",
+     -1440.0, -720.00, 60.0, REGIME_SYNCHRONOUS_24H},
+    {"Original STR#3 SDP4 test",
+     "1 11801U          80230.29629788  .01431103  00000-0  14311-1      13",
+     "2 11801  46.7916 230.4354 7318036  47.4722  10.4117  2.28537848    13",
+     0.0, 1440.0, 360.00, REGIME_DEEP_SPACE},
+    {"EUTELSAT 1-F1 (ECS1)",
+     "1 14128U 83058A   06176.02844893 -.00000158  00000-0  10000-3 0  9627",
+     "2 14128   0.0000  89.5225 0002426  10.8720 283.4622  1.00272544 83450",
+     0.0, 2880.0, 120.00, REGIME_SYNCHRONOUS_24H},
+    {"SL-6 R/B(2)",
+     "1 16925U 86065D   06151.67415771  .02550794 -30915-6  18784-3 0  4486",
+     "2 16925  62.0906 295.0239 5596327 245.1593  47.9690  4.88511875148616",
+     0.0, 1440.0, 120.00, REGIME_DEEP_SPACE},
+    {"SL-12 R/B",
+     "1 20413U 83020D   05363.79166667  .00000000  00000-0  00000+0 0  7041",
+     "2 20413  12.3514 187.4253 7864447 196.3027 356.5478  0.24690082  7978",
+     1844000.0, 1845100.0, 5.00, REGIME_DEEP_SPACE},
+    {"MOLNIYA 1-83",
+     "1 21897U 92011A   06176.02341244 -.00001273  00000-0 -13525-3 0  3044",
+     "2 21897  62.1749 198.0096 7421690 253.0462  20.1561  2.01269994104880",
+     0.0, 2880.0, 120.00, REGIME_RESONANT_12H},
+    {"SL-6 R/B(2)",
+     "1 22312U 93002D   06094.46235912  .99999999  81888-5  49949-3 0  3953",
+     "2 22312  62.1486  77.4698 0308723 267.9229  88.7392 15.95744531 98783",
+     54.2028672, 1440.0, 20.00, REGIME_NEAR_SPACE},
+    {"SL-6 R/B(2)",
+     "1 22674U 93035D   06176.55909107  .00002121  00000-0  29868-3 0  6569",
+     "2 22674  63.5035 354.4452 7541712 253.3264  18.7754  1.96679808 93877",
+     0.0, 2880.0, 120.00, REGIME_RESONANT_12H},
+    {"ARIANE 44L+ R/B",
+     "1 23177U 94040C   06175.45752052  .00000386  00000-0  76590-3 0    95",
+     "2 23177   7.0496 179.8238 7258491 296.0482   8.3061  2.25906668 97438",
+     0.0, 1440.0, 120.00, REGIME_DEEP_SPACE},
+    {"WIND",
+     "1 23333U 94071A   94305.49999999 -.00172956  26967-3  10000-3 0    15",
+     "2 23333  28.7490   2.3720 9728298  30.4360   1.3500  0.07309491    70",
+     0.0, 1600.0, 120.00, REGIME_DEEP_SPACE},
+    {"ARIANE 42P+3 R/B",
+     "1 23599U 95029B   06171.76535463  .00085586  12891-6  12956-2 0  2905",
+     "2 23599   6.9327   0.2849 5782022 274.4436  25.2425  4.47796565123555",
+     0.0, 720.0, 20.00, REGIME_DEEP_SPACE},
+    {"ITALSAT 2",
+     "1 24208U 96044A   06177.04061740 -.00000094  00000-0  10000-3 0  1600",
+     "2 24208   3.8536  80.0121 0026640 311.0977  48.3000  1.00778054 36119",
+     0.0, 1440.0, 120.00, REGIME_SYNCHRONOUS_24H},
+    {"AMC-4",
+     "1 25954U 99060A   04039.68057285 -.00000108  00000-0  00000-0 0  6847",
+     "2 25954   0.0004 243.8136 0001765  15.5294  22.7134  1.00271289 15615",
+     -1440.0, 1440.0, 120.00, REGIME_SYNCHRONOUS_24H},
+    {"INTELSAT 902",
+     "1 26900U 01039A   06106.74503247  .00000045  00000-0  10000-3 0  8290",
+     "2 26900   0.0164 266.5378 0003319  86.1794 182.2590  1.00273847 16981",
+     9300.00, 9400.00, 60.00, REGIME_SYNCHRONOUS_24H},
+    {"COSMOS 1024 DEB",
+     "1 26975U 78066F   06174.85818871  .00000620  00000-0  10000-3 0  6809",
+     "2 26975  68.4714 236.1303 5602877 123.7484 302.5767  2.05657553 67521",
+     0.0, 2880.0, 120.00, REGIME_RESONANT_12H},
+    {"CBERS 2",
+     "1 28057U 03049A   06177.78615833  .00000060  00000-0  35940-4 0  1836",
+     "2 28057  98.4283 247.6961 0000884  88.1964 271.9322 14.35478080140550",
+     0.0, 2880.0, 120.00, REGIME_NEAR_SPACE},
+    {"NAVSTAR 53 (USA 175)",
+     "1 28129U 03058A   06175.57071136 -.00000104  00000-0  10000-3 0   459",
+     "2 28129  54.7298 324.8098 0048506 266.2640  93.1663  2.00562768 18443",
+     0.0, 1440.0, 120.00, REGIME_DEEP_SPACE},
+    {"COSMOS 2405",
+     "1 28350U 04020A   06167.21788666  .16154492  76267-5  18678-3 0  8894",
+     "2 28350  64.9977 345.6130 0024870 260.7578  99.9590 16.47856722116490",
+     0.0, 2880.0, 120.00, REGIME_NEAR_SPACE},
+    {"H-2 R/B",
+     "1 28623U 05006B   06177.81079184  .00637644  69054-6  96390-3 0  6000",
+     "2 28623  28.5200 114.9834 6249053 170.2550 212.8965  3.79477162 12753",
+     0.0, 1440.0, 120.00, REGIME_DEEP_SPACE},
+    {"XM-3",
+     "1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190",
+     "2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891",
+     0.0, 1440.0, 120.00, REGIME_SYNCHRONOUS_24H},
+    {"MINOTAUR R/B",
+     "1 28872U 05037B   05333.02012661  .25992681  00000-0  24476-3 0  1534",
+     "2 28872  96.4736 157.9986 0303955 244.0492 110.6523 16.46015938 10708",
+     0.0, 60.0, 5.00, REGIME_NEAR_SPACE},
+    {"SL-14 DEB",
+     "1 29141U 85108AA  06170.26783845  .99999999  00000-0  13519-0 0   718",
+     "2 29141  82.4288 273.4882 0015848 277.2124  83.9133 15.93343074  6828",
+     0.0, 440.0, 20.00, REGIME_NEAR_SPACE},
+    {"SL-12 DEB",
+     "1 29238U 06022G   06177.28732010  .00766286  10823-4  13334-2 0   101",
+     "2 29238  51.5595 213.7903 0202579  95.2503 267.9010 15.73823839  1061",
+     0.0, 1440.0, 120.00, REGIME_NEAR_SPACE},
+    {"STR#3 near space test",
+     "1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    87",
+     "2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518  1058",
+     0.0, 1440.0, 120.00, REGIME_NEAR_SPACE},
+    {"broken, eccentricity near 1",
+     "1 33333U 05037B   05333.02012661  .25992681  00000-0  24476-3 0  1534",
+     "2 33333  96.4736 157.9986 9950000 244.0492 110.6523  4.00004038 10708",
+     0.0, 150.0, 5.00, REGIME_ERROR},
+    {"broken, mean motion near 0",
+     "1 33334U 78066F   06174.85818871  .00000620  00000-0  10000-3 0  6809",
+     "2 33334  68.4714 236.1303 5602877 123.7484 302.5767  0.00001000 67521",
+     0.0, 1440.0, 1.00, REGIME_ERROR},
+    {"broken, mean motion 0",
+     "1 33335U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190",
+     "2 33335   0.0001 286.9433 0000004  13.7918  55.6504  0.00000000  4891",
+     0.0, 1440.0, 20.00, REGIME_ERROR}
+};
+
+static const size_t kVerificationCount = sizeof(kVerificationCases) / sizeof(kVerificationCases[0]);
+
+static const VerificationReference kVerificationReferences[] = {
+    {13, csgp4::PROPAGATION_OK,
+     0, {7022.4652926656663, -1400.0829675562127, 0.039951552606632239}, {1.893841014515278, 6.4058937592082925, 4.5348072503540093},
+     4320, {-9060.4737356990081, 4658.7095250209504, 813.68673153266741}, {-2.2328327827397261, -4.1104534899376306, -3.1573454334570585}},
+    {25, csgp4::PROPAGATION_OK,
+     0, {3988.3102269938713, 5498.966572352193, 0.9005587865923893}, {-3.2900327379388776, 2.357652819634739, 6.496623474956845},
+     2880, {1159.2780289717566, 5056.6017549539811, 4353.4941857887497}, {-5.9680603409111646, -2.3147904058674076, 4.2307226690901532}},
+    {25, csgp4::PROPAGATION_OK,
+     0, {2349.894833500729, -14785.938115615489, 0.02119378606273882}, {2.7214880955587302, -3.2568116546584061, 4.4984166723716719},
+     2880, {3417.2093158296311, -16038.795106619596, 1894.7493405188116}, {2.5855158640642739, -2.5968181456335171, 4.4568825561969323}},
+    {25, csgp4::PROPAGATION_OK,
+     0, {13020.067507850448, -2449.0719349926158, 1.1589603111726945}, {4.2473639348582273, 1.5971785008494639, 4.9567086113913774},
+     2880, {15500.534450679654, -1332.9098104195159, 3419.7231530769973}, {2.9609179743587082, 1.7583316344487792, 4.8136986378953939}},
+    {3, csgp4::PROPAGATION_OK,
+     -5184, {-29020.025871273054, 13819.844190638534, -5713.33679182591}, {-1.7680683899903948, -3.2353711920129671, -0.39520613549735356},
+     -4944, {-22097.687305129428, -31583.138292836888, -4836.3432932816813}, {2.2305974990854009, -2.1665946668679874, 0.42644306968499451}},
+    {13, csgp4::PROPAGATION_OK,
+     -1440, {-11362.182651175986, -35117.558678134374, -5413.6253799446113}, {3.137861261367668, -1.0116782604838579, 0.26751005855368304},
+     -720, {-8535.8159815755462, 38171.790738513373, 3331.0031128536903}, {-3.043839957769622, -0.64446252749283828, -0.44580889406270746}},
+    {5, csgp4::PROPAGATION_OK,
+     0, {7473.3710249142878, 428.94748312434803, 5828.7484678268402}, {5.1071553908634861, 6.4446803046263588, -0.18613329734153311},
+     1440, {9787.8783625552951, 33753.32249666765, -15030.798746254255}, {-1.0942515528493539, 0.92358990561712573, -1.5223110076706354}},
+    {25, csgp4::PROPAGATION_OK,
+     0, {38564.012795426919, 17041.631744647952, 0.24647727805701433}, {-1.2435350669345386, 2.8122291211339117, 4.8456491612357964e-05},
+     2880, {37952.942366200303, 18362.115749735764, -0.72433430806009103}, {-1.3398329011577839, 2.767661920578159, 0.00056930231459205688}},
+    {13, csgp4::PROPAGATION_OK,
+     0, {5559.1168683591932, -11941.040907811874, -19.41235206068027}, {3.3921167616329195, -1.9469851242328717, 4.25075585244781},
+     1440, {-984.62035146435323, -5187.0348081313787, -5745.5959414429508}, {4.3402719164754275, -7.2668113540721011, 1.7776688881756089}},
+    {69, csgp4::PROPAGATION_DECAYED,
+     1844000, {-35697.350254499579, -70749.924959614233, 14190.124615450048}, {1.6496361128536894, 1.7699939420295194, -0.57629005279045942},
+     1844340, {5091.5554638014246, -5030.011343576919, -1222.1421054874174}, {0.25279200465699286, 10.276493768175881, -0.6218141320462377}},
+    {25, csgp4::PROPAGATION_OK,
+     0, {-14464.72135182129, -4699.1951758727646, 0.066816857066658367}, {-3.2493120134996927, -3.2810327069534031, 4.0070469396112305},
+     2880, {-17246.310756783772, -7890.7260150808715, 4315.3941030664755}, {-1.9109684576828081, -2.7409456718464398, 3.8447227256011485}},
+    {22, csgp4::PROPAGATION_ECCENTRICITY,
+     54.2028672, {306.10478453261044, -5816.4565552455151, -2979.5584606822458}, {3.9506638545948487, 3.4153325425378163, -5.8799743289118336},
+     474.20286720000001, {-3181.5469804258046, -3831.2997650299012, 4096.8024279006313}, {1.1141599698057467, -6.1047735778419341, -4.829967400200152}},
+    {25, csgp4::PROPAGATION_OK,
+     0, {14712.220232805956, -1443.81061850277, 0.83497888352364658}, {4.4189654703647347, 1.6295920975134464, 4.1155318017349272},
+     2880, {-7331.6500671665572, -604.17323412832093, -2723.510145659895}, {6.1689972648414084, -3.6340115541462472, -5.9635316816698953}},
+    {13, csgp4::PROPAGATION_OK,
+     0, {-8801.6004670645889, -0.033575572851914384, -0.44522742648904778}, {-3.8352791008026439, -7.6625521754535235, 0.94456132314764707},
+     1440, {4021.3143858312806, -36066.092096090782, 4442.9158741094307}, {2.0073223541409342, -1.2274613757147648, 0.14938389668466817}},
+    {14, csgp4::PROPAGATION_OK,
+     0, {-9301.2454316870153, 3326.1020031642011, 2318.3644112426455}, {-8.7293030013120809, -0.82822503807907788, -0.12231482769643644},
+     1560, {-197898.69401571047, -80928.290152378089, -38698.579724740652}, {-1.2042118882271842, -0.67254470883403361, -0.34041373051999579}},
+    {37, csgp4::PROPAGATION_OK,
+     0, {9892.637943404925, 35.761449687022207, -1.0822883769340983}, {3.5566432367170453, 6.4560093751019627, 0.78361088984995719},
+     720, {7141.2474252654456, 20538.971151583108, 2501.1805996568469}, {-2.2930796234724227, 2.3335989929010301, 0.28272744128092314}},
+    {13, csgp4::PROPAGATION_OK,
+     0, {7534.1098718941048, 41266.392668428482, -0.10801028480460627}, {-3.0271680083581436, 0.55884899615950212, 0.20798275547193004},
+     1440, {5501.0813709956365, 41590.277844053759, 138.32522929719207}, {-3.0506918744694329, 0.40920305196128087, 0.20795813278547456}},
+    {25, csgp4::PROPAGATION_OK,
+     -1440, {8118.1851922096685, -41368.405373777219, 4.110466873303535}, {3.0176967405173363, 0.59199429658209612, 0.00093301582208016114},
+     1440, {9533.2775081838172, -41065.523902136309, 3.3075648210737856}, {2.9955961712664174, 0.69520023626389404, 0.00093852478682154882}},
+    {2, csgp4::PROPAGATION_OK,
+     9300, {40968.68133294709, -9905.991561014107, 11.84946837085386}, {0.72275684813554564, 2.989645389042459, -0.00016126106923378},
+     9360, {42135.668584822291, 1072.9919560243895, 10.834817522785107}, {-0.078150602085676674, 3.0747724554098279, -0.00038006297333279519}},
+    {25, csgp4::PROPAGATION_OK,
+     0, {-14506.923137680475, -21613.560432814982, 10.050188933331503}, {2.2129433081186267, 1.1599708917037821, 3.0206002019524663},
+     2880, {43.693053078679206, -8145.9029920720477, 11634.570799133113}, {3.7806616824272345, 5.1053154234097367, 0.71440134457717464}},
+    {25, csgp4::PROPAGATION_OK,
+     0, {-2715.2823748584569, -6619.2643688956923, -0.013414430162584744}, {-1.0085872732744863, 0.42278200278283978, 7.3852729415992782},
+     2880, {1788.4233458045908, 1990.5053095690055, -6640.5933772577691}, {-2.0741690906395394, -6.6833812880321934, -2.562777775598863}},
+    {13, csgp4::PROPAGATION_OK,
+     0, {21707.464123512284, -15318.617523902101, 0.13551152261174343}, {1.3040292142524363, 1.8169049742450543, 3.1619199762172889},
+     1440, {22002.200745619579, -14879.725955925043, 774.32827099038263}, {1.1915736192897037, 1.8945611646537832, 3.1599530470186021}},
+    {13, csgp4::PROPAGATION_ECCENTRICITY,
+     0, {6333.0812312828994, -1580.8285232594865, 90.693557203898834}, {0.71463442344214256, 3.2242465495631185, 7.0831281322883513},
+     1440, {-4527.9087184264326, -723.291990300522, -4527.446083061147}, {5.1216742170312655, -3.909895426865134, -4.5002185557696235}},
+    {13, csgp4::PROPAGATION_OK,
+     0, {-11665.709023241458, 24943.614333572572, 25.805436333061632}, {-1.5962286214488486, -1.4761279612118723, 1.1260597536482997},
+     1440, {-2914.3106582782693, 26665.203927583647, -4511.09814335185}, {-2.2162619088276263, 0.71006776923422132, 0.94069182366584347}},
+    {13, csgp4::PROPAGATION_OK,
+     0, {42080.718522126044, -2646.8638743565052, 0.81851293913223377}, {0.19310517736659402, 3.0686882505727104, 0.00043844943148627996},
+     1440, {42119.962634985932, -1925.775672629916, -0.19827433154334889}, {0.14052120636715815, 3.0715416134674318, 0.00017956116681519058}},
+    {11, csgp4::PROPAGATION_DECAYED,
+     0, {-6131.8273045681144, 2446.5281552853376, -253.64211033518816}, {-0.14492022756075582, 0.9951009627960159, 7.6586450668150219},
+     50, {5548.4332592230594, -2480.164692452227, -1979.243145283933}, {-2.7632695338963074, 0.19969191531906855, -7.4827969962918131}},
+    {22, csgp4::PROPAGATION_DECAYED,
+     0, {423.99295523911064, -6658.1225614969071, 136.13040356390002}, {1.006373612879778, 0.21730998326138212, 7.662587892234364},
+     420, {-852.93910080913929, 192.65232178324428, -6322.4705479246686}, {0.39600619399993059, -7.8829649192912994, -0.28933151924412964}},
+    {13, csgp4::PROPAGATION_OK,
+     0, {-5566.595128190922, -3789.7599115862645, 67.603822453900321}, {2.8737593669497246, -3.825340522660611, 6.0232539255361388},
+     1440, {-2629.5501144882587, 3400.9804015773639, -5344.3821712884519}, {-6.3685484483643755, -3.9989635089318756, 0.57725306376830698}},
+    {13, csgp4::PROPAGATION_OK,
+     0, {2328.9697526221557, -5995.2205133820498, 1719.9729719172271}, {2.9120732812523804, -0.98341795579548963, -7.0908162100601801},
+     1440, {2742.5539883178344, -6079.6700912320339, -326.39012648996419}, {1.9484976514784813, 1.2110726784402681, -7.3561931312756892}},
+    {5, csgp4::PROPAGATION_ELSQ,
+     0, {-12908.671358696914, 8084.5646437795058, 22887.749600083403}, {-0.076981979031620171, 0.25265206229793635, 1.837356357538126},
+     20, {21196.99960812003, -35760.504828033409, -6675.0841215674336}, {0.55574597704353601, -0.79621535723511505, -0.27196823215929983}},
+    {0, csgp4::PROPAGATION_ECCENTRICITY,
+     0, {0, 0, 0}, {0, 0, 0},
+     0, {0, 0, 0}, {0, 0, 0}},
+    {0, csgp4::PROPAGATION_MEAN_MOTION,
+     0, {0, 0, 0}, {0, 0, 0},
+     0, {0, 0, 0}, {0, 0, 0}}
+};
+
+static inline csgp4::Tle VerificationTle(const VerificationCase& c)
+{
+    std::string line1(c.line1);
+    std::string line2(c.line2);
+    return csgp4::Tle(line1, line2);
+}
+
+// the grid of a case
+static inline std::vector<double> VerificationGrid(const VerificationCase& c)
+{
+    std::vector<double> tsince;
+    for (size_t k = 0; c.start + c.step * k <= c.stop + 1.0e-9; k++) {
+        tsince.push_back(c.start + c.step * k);
+    }
+    return tsince;
+}
+
+#endif
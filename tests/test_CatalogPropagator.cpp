@@ -0,0 +1,170 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/CatalogPropagator.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+static std::string molniya_tle1("1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813");
+static std::string molniya_tle2("2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+static std::string str3_tle1("1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    18");
+static std::string str3_tle2("2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518   105");
+
+struct Results
+{
+    explicit Results(size_t n)
+        : x(n), y(n), z(n), xdot(n), ydot(n), zdot(n), status(n)
+    {
+    }
+
+    std::vector<double> x, y, z, xdot, ydot, zdot;
+    std::vector<csgp4::PropagationStatus> status;
+};
+
+static std::vector<csgp4::SGP4> models()
+{
+    std::vector<csgp4::SGP4> sgp4;
+    for (int i = 0; i < 3; i++) {
+        sgp4.emplace_back(csgp4::Tle(iss_tle1, iss_tle2));
+        sgp4.emplace_back(csgp4::Tle(geo_tle1, geo_tle2));
+        sgp4.emplace_back(csgp4::Tle(molniya_tle1, molniya_tle2));
+        sgp4.emplace_back(csgp4::Tle(str3_tle1, str3_tle2));
+    }
+    return sgp4;
+}
+
+static std::vector<double> grid(size_t steps, double step)
+{
+    std::vector<double> tsince(steps);
+    for (size_t k = 0; k < steps; k++) {
+        tsince[k] = -1440.0 + step * k;
+    }
+    return tsince;
+}
+
+static Results propagate(const csgp4::CatalogPropagator& dut,
+    const std::vector<csgp4::SGP4>& sgp4, const std::vector<double>& tsince)
+{
+    Results r(sgp4.size() * tsince.size());
+    dut.Propagate(sgp4, tsince.data(), tsince.size(), r.x.data(), r.y.data(), r.z.data(),
+        r.xdot.data(), r.ydot.data(), r.zdot.data(), r.status.data());
+    return r;
+}
+
+TEST(CatalogPropagator_suite, CatalogPropagator_matches_scalar)
+{
+    const std::vector<csgp4::SGP4> sgp4 = models();
+    const std::vector<double> tsince = grid(300, 1800.0);
+    csgp4::CatalogPropagator dut(3);
+    EXPECT_EQ(3u, dut.Threads());
+    Results r = propagate(dut, sgp4, tsince);
+
+    size_t errors = 0;
+    for (size_t i = 0; i < sgp4.size(); i++) {
+        for (size_t k = 0; k < tsince.size(); k++) {
+            const size_t slot = i * tsince.size() + k;
+            csgp4::SGP4::IntegratorParams integ;
+            csgp4::Vector position, velocity;
+            ASSERT_EQ(sgp4[i].TryFindPosition(tsince[k], integ, position, velocity), r.status[slot]);
+            if (r.status[slot] != csgp4::PROPAGATION_OK) {
+                errors++;
+                continue;
+            }
+            ASSERT_EQ(position.x, r.x[slot]);
+            ASSERT_EQ(position.y, r.y[slot]);
+            ASSERT_EQ(position.z, r.z[slot]);
+            ASSERT_EQ(velocity.x, r.xdot[slot]);
+            ASSERT_EQ(velocity.y, r.ydot[slot]);
+            ASSERT_EQ(velocity.z, r.zdot[slot]);
+        }
+    }
+    // STR#3 fails before the end of the year long grid
+    EXPECT_GT(errors, 0u);
+}
+
+TEST(CatalogPropagator_suite, CatalogPropagator_independent_of_threads)
+{
+    const std::vector<csgp4::SGP4> sgp4 = models();
+    const std::vector<double> tsince = grid(517, 10.0);
+    Results one = propagate(csgp4::CatalogPropagator(1), sgp4, tsince);
+
+    for (unsigned int threads : {2u, 5u, 64u}) {
+        csgp4::CatalogPropagator dut(threads);
+        dut.SetCostWeights(4.0, 16.0);
+        Results r = propagate(dut, sgp4, tsince);
+        const size_t bytes = one.x.size() * sizeof(double);
+        EXPECT_EQ(0, memcmp(one.x.data(), r.x.data(), bytes));
+        EXPECT_EQ(0, memcmp(one.y.data(), r.y.data(), bytes));
+        EXPECT_EQ(0, memcmp(one.z.data(), r.z.data(), bytes));
+        EXPECT_EQ(0, memcmp(one.xdot.data(), r.xdot.data(), bytes));
+        EXPECT_EQ(0, memcmp(one.ydot.data(), r.ydot.data(), bytes));
+        EXPECT_EQ(0, memcmp(one.zdot.data(), r.zdot.data(), bytes));
+        EXPECT_TRUE(one.status == r.status);
+    }
+}
+
+TEST(CatalogPropagator_suite, CatalogPropagator_pinned)
+{
+    const std::vector<csgp4::SGP4> sgp4 = models();
+    const std::vector<double> tsince = grid(200, 10.0);
+    Results expected = propagate(csgp4::CatalogPropagator(1), sgp4, tsince);
+
+    csgp4::CatalogPropagator dut(4);
+    dut.SetThreadAffinity({0});
+    Results r = propagate(dut, sgp4, tsince);
+    EXPECT_TRUE(expected.x == r.x);
+    EXPECT_TRUE(expected.zdot == r.zdot);
+    EXPECT_TRUE(expected.status == r.status);
+}
+
+TEST(CatalogPropagator_suite, CatalogPropagator_dates)
+{
+    csgp4::SGP4Catalog catalog;
+    catalog.Update({csgp4::Tle(iss_tle1, iss_tle2), csgp4::Tle(geo_tle1, geo_tle2)});
+    const csgp4::DateTime start = catalog.At(0).FindPosition(0.0).GetDateTime();
+    std::vector<csgp4::DateTime> dates;
+    for (int k = 0; k < 150; k++) {
+        dates.push_back(start.AddMinutes(k));
+    }
+
+    Results r(catalog.Size() * dates.size());
+    csgp4::CatalogPropagator dut(2);
+    dut.Propagate(catalog, dates.data(), dates.size(), r.x.data(), r.y.data(), r.z.data(),
+        r.xdot.data(), r.ydot.data(), r.zdot.data(), r.status.data());
+
+    for (size_t i = 0; i < catalog.Size(); i++) {
+        for (size_t k = 0; k < dates.size(); k++) {
+            const size_t slot = i * dates.size() + k;
+            csgp4::Eci eci = catalog.At(i).FindPosition(dates[k]);
+            EXPECT_EQ(csgp4::PROPAGATION_OK, r.status[slot]);
+            EXPECT_EQ(eci.Position().x, r.x[slot]);
+            EXPECT_EQ(eci.Velocity().z, r.zdot[slot]);
+        }
+    }
+}
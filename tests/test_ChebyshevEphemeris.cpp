@@ -0,0 +1,123 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "csgp4/ChebyshevEphemeris.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string molniya_tle1("1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813");
+static std::string molniya_tle2("2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+
+// the largest difference from SGP4 over a dense grid, independent of the
+// points the fit checks itself at
+static void dense_errors(const csgp4::SGP4& sgp4, const csgp4::ChebyshevEphemeris& dut,
+    double& position_error, double& velocity_error)
+{
+    position_error = 0.0;
+    velocity_error = 0.0;
+    for (double t = dut.Start(); t <= dut.End(); t += 0.37) {
+        csgp4::Eci truth = sgp4.FindPosition(t);
+        csgp4::Eci fit = dut.FindPosition(t);
+        position_error = fmax(position_error, (fit.Position() - truth.Position()).Magnitude());
+        velocity_error = fmax(velocity_error, (fit.Velocity() - truth.Velocity()).Magnitude());
+    }
+}
+
+TEST(ChebyshevEphemeris_suite, ChebyshevEphemeris_fixed_segments)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    csgp4::ChebyshevEphemeris dut(sgp4, 0.0, 1440.0, 25.0);
+    EXPECT_EQ(58u, dut.SegmentCount());
+    EXPECT_DOUBLE_EQ(1440.0 / 58.0, dut.SegmentLength());
+    EXPECT_DOUBLE_EQ(1440.0, dut.End());
+    EXPECT_EQ(csgp4::ChebyshevEphemeris::kDefaultDegree, dut.Degree());
+
+    double position_error, velocity_error;
+    dense_errors(sgp4, dut, position_error, velocity_error);
+    EXPECT_GT(dut.MaxPositionError(), 0.0);
+    EXPECT_LT(dut.MaxPositionError(), 1.0e-3);
+    EXPECT_LT(dut.MaxVelocityError(), 1.0e-6);
+    // the reported error bounds the dense one to within a small margin
+    EXPECT_LT(position_error, 1.5 * dut.MaxPositionError());
+    EXPECT_LT(velocity_error, 1.5 * dut.MaxVelocityError());
+
+    for (size_t i = 0; i < dut.SegmentCount(); i++) {
+        EXPECT_LE(dut.SegmentPositionError(i), dut.MaxPositionError());
+    }
+}
+
+TEST(ChebyshevEphemeris_suite, ChebyshevEphemeris_fit_to_tolerance)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    csgp4::ChebyshevEphemeris coarse = csgp4::ChebyshevEphemeris::Fit(sgp4, 0.0, 720.0, 1.0);
+    csgp4::ChebyshevEphemeris fine = csgp4::ChebyshevEphemeris::Fit(sgp4, 0.0, 720.0, 1.0e-6);
+    EXPECT_LE(coarse.MaxPositionError(), 1.0);
+    EXPECT_LE(fine.MaxPositionError(), 1.0e-6);
+    EXPECT_LT(coarse.SegmentCount(), fine.SegmentCount());
+
+    double position_error, velocity_error;
+    dense_errors(sgp4, fine, position_error, velocity_error);
+    EXPECT_LT(position_error, 1.0e-6);
+}
+
+TEST(ChebyshevEphemeris_suite, ChebyshevEphemeris_deep_space)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(molniya_tle1, molniya_tle2));
+    csgp4::ChebyshevEphemeris dut = csgp4::ChebyshevEphemeris::Fit(sgp4, 0.0, 2880.0, 1.0e-3);
+    EXPECT_LE(dut.MaxPositionError(), 1.0e-3);
+
+    double position_error, velocity_error;
+    dense_errors(sgp4, dut, position_error, velocity_error);
+    EXPECT_LT(position_error, 1.0e-3);
+}
+
+TEST(ChebyshevEphemeris_suite, ChebyshevEphemeris_date_and_position_only)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    csgp4::ChebyshevEphemeris dut(sgp4, 0.0, 180.0, 10.0);
+    const csgp4::DateTime date = sgp4.FindPosition(95.5).GetDateTime();
+    csgp4::Eci eci = dut.FindPosition(date);
+    csgp4::Vector position;
+    ASSERT_TRUE(dut.Evaluate(95.5, position));
+    EXPECT_DOUBLE_EQ(eci.Position().x, position.x);
+    EXPECT_DOUBLE_EQ(eci.Position().y, position.y);
+    EXPECT_DOUBLE_EQ(eci.Position().z, position.z);
+}
+
+TEST(ChebyshevEphemeris_suite, ChebyshevEphemeris_outside_span)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    csgp4::ChebyshevEphemeris dut(sgp4, 0.0, 180.0, 30.0);
+    csgp4::Vector position, velocity;
+    EXPECT_TRUE(dut.Contains(0.0));
+    EXPECT_TRUE(dut.Contains(180.0));
+    EXPECT_FALSE(dut.Evaluate(-0.1, position, velocity));
+    EXPECT_FALSE(dut.Evaluate(180.1, position));
+    EXPECT_THROW(dut.FindPosition(200.0), std::out_of_range);
+    EXPECT_THROW(csgp4::ChebyshevEphemeris(sgp4, 10.0, 10.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(csgp4::ChebyshevEphemeris(sgp4, 0.0, 180.0, 30.0, 0), std::invalid_argument);
+}
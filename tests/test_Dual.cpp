@@ -0,0 +1,91 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+#include "csgp4/Dual.h"
+
+typedef csgp4::Dual<2> D2;
+
+TEST(Dual_suite, Dual_arithmetic)
+{
+    const D2 x = D2::Variable(0.7, 0);
+    const D2 y = D2::Variable(-1.3, 1);
+
+    const D2 f = x * y + x / y - 2.0 * x + 1.0 / y;
+    EXPECT_DOUBLE_EQ(0.7 * -1.3 + 0.7 / -1.3 - 1.4 + 1.0 / -1.3, f.value);
+    EXPECT_DOUBLE_EQ(-1.3 + 1.0 / -1.3 - 2.0, f.partials[0]);
+    EXPECT_DOUBLE_EQ(0.7 - 0.7 / (1.3 * 1.3) - 1.0 / (1.3 * 1.3), f.partials[1]);
+
+    EXPECT_TRUE(x > y);
+    EXPECT_TRUE(x < 1.0);
+    EXPECT_TRUE(y <= -1.3);
+}
+
+TEST(Dual_suite, Dual_functions)
+{
+    const D2 x = D2::Variable(0.7, 0);
+    const D2 y = D2::Variable(-1.3, 1);
+
+    EXPECT_DOUBLE_EQ(cos(0.7), sin(x).partials[0]);
+    EXPECT_DOUBLE_EQ(-sin(0.7), cos(x).partials[0]);
+    EXPECT_DOUBLE_EQ(0.5 / sqrt(0.7), sqrt(x).partials[0]);
+    EXPECT_DOUBLE_EQ(1.5 * sqrt(0.7), pow(x, 1.5).partials[0]);
+    EXPECT_DOUBLE_EQ(-1.0, fabs(y).partials[1]);
+    EXPECT_DOUBLE_EQ(1.0, fmod(y * 10.0, 2.0).partials[1] / 10.0);
+
+    // d/dy atan2(y, x) = x / r^2, d/dx = -y / r^2
+    const D2 a = atan2(y, x);
+    EXPECT_DOUBLE_EQ(atan2(-1.3, 0.7), a.value);
+    EXPECT_DOUBLE_EQ(1.3 / (0.49 + 1.69), a.partials[0]);
+    EXPECT_DOUBLE_EQ(0.7 / (0.49 + 1.69), a.partials[1]);
+}
+
+TEST(Dual_suite, Dual_kepler)
+{
+    // derivatives of the solution against central differences in capu and axn
+    const double capu = 1.1;
+    const double axn = 0.3;
+    const double ayn = 0.1;
+
+    const D2 u = D2::Variable(capu, 0);
+    const D2 x = D2::Variable(axn, 1);
+    const D2 y(ayn);
+    D2 sinepw, cosepw, ecose, esine;
+    KeplerSolve(u, x, y, x * x + y * y, sinepw, cosepw, ecose, esine);
+
+    const double h = 1.0e-6;
+    double s[2][2], es[2][2];
+    for (int k = 0; k < 2; k++) {
+        const double d = k ? h : -h;
+        double c, ec;
+        csgp4::Kepler::Solve(capu + d, axn, ayn, axn * axn + ayn * ayn, s[0][k], c, ec, es[0][k]);
+        csgp4::Kepler::Solve(capu, axn + d, ayn, (axn + d) * (axn + d) + ayn * ayn,
+                             s[1][k], c, ec, es[1][k]);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        EXPECT_NEAR((s[i][1] - s[i][0]) / (2.0 * h), sinepw.partials[i], 1.0e-6);
+        EXPECT_NEAR((es[i][1] - es[i][0]) / (2.0 * h), esine.partials[i], 1.0e-6);
+    }
+}
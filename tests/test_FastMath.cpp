@@ -0,0 +1,125 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <gtest/gtest.h>
+
+#include "csgp4/FastMath.h"
+
+// the distance between two doubles in units in the last place
+static int64_t ulps(double a, double b)
+{
+    int64_t ia, ib;
+    std::memcpy(&ia, &a, sizeof(ia));
+    std::memcpy(&ib, &b, sizeof(ib));
+    ia = ia < 0 ? INT64_MIN - ia : ia;
+    ib = ib < 0 ? INT64_MIN - ib : ib;
+    return ia > ib ? ia - ib : ib - ia;
+}
+
+TEST(FastMath_suite, FastMath_sincos)
+{
+    std::mt19937_64 generator(1);
+    for (double range : {1.0, 10.0, 1.0e3, 1.0e6}) {
+        std::uniform_real_distribution<double> angle(-range, range);
+        for (int i = 0; i < 200000; i++) {
+            const double x = angle(generator);
+            double s, c;
+            csgp4::FastMath::SinCos(x, s, c);
+            ASSERT_LE(ulps(std::sin(x), s), static_cast<int64_t>(csgp4::FastMath::kSinCosUlps)) << x;
+            ASSERT_LE(ulps(std::cos(x), c), static_cast<int64_t>(csgp4::FastMath::kSinCosUlps)) << x;
+        }
+    }
+    double s, c;
+    csgp4::FastMath::SinCos(0.0, s, c);
+    EXPECT_EQ(0.0, s);
+    EXPECT_EQ(1.0, c);
+}
+
+TEST(FastMath_suite, FastMath_atan2)
+{
+    std::mt19937_64 generator(2);
+    for (double range : {1.0e-3, 1.0, 1.0e3}) {
+        std::uniform_real_distribution<double> coordinate(-range, range);
+        for (int i = 0; i < 200000; i++) {
+            const double y = coordinate(generator);
+            const double x = coordinate(generator);
+            ASSERT_LE(ulps(std::atan2(y, x), csgp4::FastMath::Atan2(y, x)),
+                static_cast<int64_t>(csgp4::FastMath::kAtan2Ulps)) << y << " " << x;
+        }
+    }
+    // the axes and diagonals
+    for (double y : {-1.0, 0.0, 1.0}) {
+        for (double x : {-1.0, 0.0, 1.0}) {
+            if (x != 0.0 || y != 0.0) {
+                EXPECT_LE(ulps(std::atan2(y, x), csgp4::FastMath::Atan2(y, x)),
+                    static_cast<int64_t>(csgp4::FastMath::kAtan2Ulps)) << y << " " << x;
+            }
+        }
+    }
+}
+
+TEST(FastMath_suite, FastMath_powers)
+{
+    std::mt19937_64 generator(3);
+    std::uniform_real_distribution<double> value(1.0e-3, 20.0);
+    for (int i = 0; i < 200000; i++) {
+        const double x = value(generator);
+        ASSERT_LE(ulps(std::pow(x, 3.0), csgp4::FastMath::Cube(x)),
+            static_cast<int64_t>(csgp4::FastMath::kCubeUlps)) << x;
+        ASSERT_LE(ulps(std::pow(x, 1.5), csgp4::FastMath::PowThreeHalves(x)),
+            static_cast<int64_t>(csgp4::FastMath::kPowThreeHalvesUlps)) << x;
+        ASSERT_LE(ulps(std::pow(x, 2.0 / 3.0), csgp4::FastMath::PowTwoThirds(x)),
+            static_cast<int64_t>(csgp4::FastMath::kPowTwoThirdsUlps)) << x;
+    }
+    EXPECT_EQ(0.0, csgp4::FastMath::PowTwoThirds(0.0));
+}
+
+TEST(FastMath_suite, FastMath_selection)
+{
+    // the default build must give libm bit for bit
+    const double x = 2.345;
+    double s, c;
+    csgp4::SinCos(x, s, c);
+#if defined(LIBCSGP4_FAST_MATH)
+    double fs, fc;
+    csgp4::FastMath::SinCos(x, fs, fc);
+    EXPECT_EQ(fs, s);
+    EXPECT_EQ(fc, c);
+    EXPECT_EQ(csgp4::FastMath::Atan2(x, -1.0), csgp4::Atan2(x, -1.0));
+    EXPECT_EQ(csgp4::FastMath::Cube(x), csgp4::Cube(x));
+    EXPECT_EQ(csgp4::FastMath::PowThreeHalves(x), csgp4::PowThreeHalves(x));
+    EXPECT_EQ(csgp4::FastMath::PowTwoThirds(x), csgp4::PowTwoThirds(x));
+#else
+    EXPECT_EQ(std::sin(x), s);
+    EXPECT_EQ(std::cos(x), c);
+    EXPECT_EQ(std::sin(x), csgp4::Sin(x));
+    EXPECT_EQ(std::cos(x), csgp4::Cos(x));
+    EXPECT_EQ(std::atan2(x, -1.0), csgp4::Atan2(x, -1.0));
+    EXPECT_EQ(std::pow(x, 3.0), csgp4::Cube(x));
+    EXPECT_EQ(std::pow(x, 1.5), csgp4::PowThreeHalves(x));
+    EXPECT_EQ(std::pow(x, 2.0 / 3.0), csgp4::PowTwoThirds(x));
+#endif
+}
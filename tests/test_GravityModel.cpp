@@ -0,0 +1,124 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/Globals.h"
+#include "csgp4/GravityModel.h"
+#include "csgp4/SGP4.h"
+#include "csgp4/SGP4Batch.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+
+template <class Gravity>
+static void expect_derived_constants()
+{
+    EXPECT_DOUBLE_EQ(60.0 / sqrt(Gravity::kXKMPER * Gravity::kXKMPER * Gravity::kXKMPER / Gravity::kMU),
+        Gravity::kXKE);
+    EXPECT_EQ(pow((120.0 - 78.0) / Gravity::kXKMPER, 4.0), Gravity::kQOMS2T);
+}
+
+TEST(GravityModel_suite, GravityModel_derived_constants)
+{
+    // WGS-72 old keeps the truncated XKE of Spacetrack Report #3
+    EXPECT_NEAR(60.0 / sqrt(pow(csgp4::Wgs72OldGravity::kXKMPER, 3.0) / csgp4::Wgs72OldGravity::kMU),
+        csgp4::Wgs72OldGravity::kXKE, 1.0e-10);
+    EXPECT_EQ(pow((120.0 - 78.0) / csgp4::Wgs72OldGravity::kXKMPER, 4.0), csgp4::Wgs72OldGravity::kQOMS2T);
+    expect_derived_constants<csgp4::Wgs72Gravity>();
+    expect_derived_constants<csgp4::Wgs84Gravity>();
+}
+
+TEST(GravityModel_suite, GravityModel_wgs72_matches_globals)
+{
+    EXPECT_EQ(csgp4::kXKE, csgp4::Wgs72Gravity::kXKE);
+    EXPECT_EQ(csgp4::kQOMS2T, csgp4::Wgs72Gravity::kQOMS2T);
+    EXPECT_EQ(csgp4::kCK2, csgp4::Wgs72Gravity::kCK2);
+    EXPECT_EQ(csgp4::kCK4, csgp4::Wgs72Gravity::kCK4);
+    EXPECT_EQ(csgp4::kS, csgp4::Wgs72Gravity::kS);
+    EXPECT_EQ(csgp4::kA3OVK2, csgp4::Wgs72Gravity::kA3OVK2);
+    EXPECT_EQ(csgp4::kXKMPER, csgp4::Wgs72Gravity::kXKMPER);
+}
+
+TEST(GravityModel_suite, GravityModel_select_model)
+{
+    csgp4::Tle tle(iss_tle1, iss_tle2);
+    csgp4::SGP4 standard(tle);
+    csgp4::SGP4 wgs72(tle, csgp4::GRAVITY_WGS72);
+    csgp4::SGP4 wgs72old(tle, csgp4::GRAVITY_WGS72_OLD);
+    csgp4::SGP4 wgs84(tle, csgp4::GRAVITY_WGS84);
+    EXPECT_EQ(csgp4::GRAVITY_WGS72, standard.Gravity());
+    EXPECT_EQ(csgp4::GRAVITY_WGS84, wgs84.Gravity());
+
+    const double tsince = 1440.0;
+    const csgp4::Vector p72 = wgs72.FindPosition(tsince).Position();
+    EXPECT_EQ(standard.FindPosition(tsince).Position().x, p72.x);
+
+    // the models differ by metres to a few kilometres after a day
+    const double d84 = (wgs84.FindPosition(tsince).Position() - p72).Magnitude();
+    const double d72old = (wgs72old.FindPosition(tsince).Position() - p72).Magnitude();
+    EXPECT_GT(d84, 0.0);
+    EXPECT_LT(d84, 10.0);
+    EXPECT_GT(d72old, 0.0);
+    EXPECT_LT(d72old, 1.0);
+
+    // SetTle keeps the model
+    wgs84.SetTle(tle);
+    EXPECT_EQ(csgp4::GRAVITY_WGS84, wgs84.Gravity());
+}
+
+TEST(GravityModel_suite, GravityModel_batch)
+{
+    std::vector<csgp4::Tle> tles(9, csgp4::Tle(iss_tle1, iss_tle2));
+    tles.push_back(csgp4::Tle(geo_tle1, geo_tle2));
+    csgp4::SGP4Batch dut(tles, csgp4::GRAVITY_WGS84);
+    const size_t n = tles.size();
+    std::vector<double> tsince(n);
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = 100.0 * i;
+    }
+    std::vector<double> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    dut.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data());
+    for (size_t i = 0; i < n; i++) {
+        csgp4::Eci eci = csgp4::SGP4(tles[i], csgp4::GRAVITY_WGS84).FindPosition(tsince[i]);
+        EXPECT_NEAR(eci.Position().x, x[i], 1.0e-8);
+        EXPECT_NEAR(eci.Position().z, z[i], 1.0e-8);
+        EXPECT_NEAR(eci.Velocity().y, ydot[i], 1.0e-11);
+    }
+
+    // a satellite with another model is still propagated with its own
+    std::vector<csgp4::SGP4> models;
+    models.push_back(csgp4::SGP4(tles[0], csgp4::GRAVITY_WGS84));
+    models.push_back(csgp4::SGP4(tles[0], csgp4::GRAVITY_WGS72));
+    csgp4::SGP4Batch mixed(models);
+    EXPECT_EQ(1u, mixed.NearSpaceCount());
+    EXPECT_EQ(1u, mixed.DeepSpaceCount());
+    mixed.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data());
+    EXPECT_EQ(models[1].FindPosition(tsince[1]).Position().x, x[1]);
+}
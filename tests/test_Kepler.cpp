@@ -0,0 +1,75 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/Kepler.h"
+
+// Inputs chosen so lanes converge after different numbers of iterations,
+// including near-circular, highly eccentric and clamped first steps.
+static void make_inputs(size_t n, std::vector<double>& capu, std::vector<double>& axn,
+    std::vector<double>& ayn, std::vector<double>& elsq)
+{
+    capu.resize(n); axn.resize(n); ayn.resize(n); elsq.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        const double e = (i % 7 == 0) ? 1.0e-6 : 0.98 * static_cast<double>(i % 11) / 10.0;
+        const double omega = 0.37 * static_cast<double>(i);
+        axn[i] = e * cos(omega);
+        ayn[i] = e * sin(omega);
+        elsq[i] = axn[i] * axn[i] + ayn[i] * ayn[i];
+        capu[i] = fmod(-6.0 + 0.61 * static_cast<double>(i), 2.0 * M_PI);
+    }
+}
+
+TEST(Kepler_suite, Kepler_solve_satisfies_equation)
+{
+    std::vector<double> capu, axn, ayn, elsq;
+    make_inputs(40, capu, axn, ayn, elsq);
+    for (size_t i = 0; i < capu.size(); i++) {
+        double s, c, ec, es;
+        csgp4::Kepler::Solve(capu[i], axn[i], ayn[i], elsq[i], s, c, ec, es);
+        EXPECT_NEAR(1.0, s * s + c * c, 1.0e-15);
+        EXPECT_NEAR(axn[i] * c + ayn[i] * s, ec, 1.0e-15);
+        EXPECT_NEAR(axn[i] * s - ayn[i] * c, es, 1.0e-15);
+    }
+}
+
+TEST(Kepler_suite, Kepler_lanes_match_scalar)
+{
+    // 43 lanes exercises whole blocks and a partial tail
+    const size_t n = 43;
+    std::vector<double> capu, axn, ayn, elsq;
+    make_inputs(n, capu, axn, ayn, elsq);
+    std::vector<double> s(n), c(n), ec(n), es(n);
+    csgp4::Kepler::SolveLanes(n, capu.data(), axn.data(), ayn.data(), elsq.data(),
+        s.data(), c.data(), ec.data(), es.data());
+    for (size_t i = 0; i < n; i++) {
+        double rs, rc, rec, res;
+        csgp4::Kepler::Solve(capu[i], axn[i], ayn[i], elsq[i], rs, rc, rec, res);
+        EXPECT_NEAR(rs, s[i], 1.0e-12);
+        EXPECT_NEAR(rc, c[i], 1.0e-12);
+        EXPECT_NEAR(rec, ec[i], 1.0e-12);
+        EXPECT_NEAR(res, es[i], 1.0e-12);
+    }
+}
@@ -0,0 +1,170 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/OmmCsvReader.h"
+#include "csgp4/SGP4.h"
+
+#include "omm_common.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+
+// the same element set as iss_tle1/2, as Celestrak serves it
+static const std::string iss_header =
+    "OBJECT_NAME,OBJECT_ID,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,"
+    "ARG_OF_PERICENTER,MEAN_ANOMALY,EPHEMERIS_TYPE,CLASSIFICATION_TYPE,NORAD_CAT_ID,"
+    "ELEMENT_SET_NO,REV_AT_EPOCH,BSTAR,MEAN_MOTION_DOT,MEAN_MOTION_DDOT\r\n";
+static const std::string iss_row =
+    "ISS (ZARYA),1998-067A,2022-11-10T12:05:22.994304,15.49917581,.0006814,51.6436,331.7596,"
+    "57.2751,98.3376,0,U,25544,999,36787,.263E-3,.14546E-3,0\r\n";
+
+TEST(OmmCsvReader_suite, OmmCsvReader_celestrak)
+{
+    auto dut = Read<csgp4::OmmCsvReader>(iss_header + iss_row);
+    EXPECT_TRUE(dut.errors.empty());
+    ASSERT_EQ(1u, dut.tles.size());
+
+    const csgp4::Tle& tle = dut.tles[0];
+    EXPECT_EQ("ISS (ZARYA)", tle.Name());
+    EXPECT_EQ("1998-067A", tle.IntDesignator());
+    EXPECT_EQ("U", tle.ClassificationType());
+    EXPECT_EQ(25544u, tle.NoradNumber());
+    EXPECT_EQ(36787u, tle.OrbitNumber());
+    EXPECT_EQ("2022-11-10 12:05:22.994304 UTC", tle.Epoch().ToString());
+
+    // propagates as the two line element set does
+    csgp4::Tle expect(iss_tle1, iss_tle2);
+    EXPECT_EQ(expect.MeanMotion(), tle.MeanMotion());
+    EXPECT_EQ(expect.BStar(), tle.BStar());
+    csgp4::Eci a = csgp4::SGP4(tle).FindPosition(tle.Epoch().AddMinutes(90.0));
+    csgp4::Eci b = csgp4::SGP4(expect).FindPosition(tle.Epoch().AddMinutes(90.0));
+    EXPECT_NEAR(0.0, (a.Position() - b.Position()).Magnitude(), 1e-5);
+}
+
+TEST(OmmCsvReader_suite, OmmCsvReader_split)
+{
+    // every split of the text into two pieces reads the same, with the
+    // columns in another order, quoting and a row longer than a block
+    const std::string text =
+        "\n\"NORAD_CAT_ID\",EXTRA,EPOCH,MEAN_MOTION,ECCENTRICITY,INCLINATION,RA_OF_ASC_NODE,"
+        "ARG_OF_PERICENTER,MEAN_ANOMALY,OBJECT_NAME\n"
+        "99999,\"x,y\",2022-11-10T12:05:22.994304Z,15.5,0.001,51.6,10,20,30,\"A,\"\"B\"\"\"\n"
+        "\n"
+        "99998,\"" + std::string(150, 'z') + "\",2022-11-10 12:05:22,15.5,0.001,51.6,10,20,30,C";
+    auto whole = Read<csgp4::OmmCsvReader>(text);
+    ASSERT_TRUE(whole.errors.empty());
+    ASSERT_EQ(2u, whole.tles.size());
+    EXPECT_EQ("A,\"B\"", whole.tles[0].Name());
+    EXPECT_EQ(99999u, whole.tles[0].NoradNumber());
+    EXPECT_EQ("C", whole.tles[1].Name());
+
+    for (size_t split = 0; split <= text.size(); split++)
+    {
+        Collected<csgp4::OmmCsvReader> dut;
+        csgp4::OmmCsvReader reader = dut.Reader();
+        reader.Feed(text.data(), split);
+        reader.Feed(text.data() + split, text.size() - split);
+        ASSERT_TRUE(reader.Finish());
+        ASSERT_TRUE(dut.errors.empty());
+        ASSERT_EQ(2u, dut.tles.size());
+        ASSERT_EQ(whole.tles[0].Name(), dut.tles[0].Name());
+        ASSERT_EQ(whole.tles[0].ToString(), dut.tles[0].ToString());
+        ASSERT_EQ(whole.tles[1].ToString(), dut.tles[1].ToString());
+    }
+}
+
+TEST(OmmCsvReader_suite, OmmCsvReader_record_errors)
+{
+    std::string missing = iss_row;
+    missing.replace(missing.find(",51.6436,"), 9, ",,");
+    std::string invalid = iss_row;
+    invalid.replace(invalid.find(".0006814"), 8, "0.000x");
+    std::string quote = iss_row;
+    quote.replace(0, 11, "\"ISS");
+    auto dut = Read<csgp4::OmmCsvReader>(iss_header + iss_row + missing + invalid + quote + iss_row);
+
+    EXPECT_EQ(2u, dut.tles.size());
+    ASSERT_EQ(3u, dut.errors.size());
+    EXPECT_EQ(3u, dut.errors[0].line);
+    EXPECT_EQ("Missing INCLINATION", dut.errors[0].message);
+    EXPECT_EQ(4u, dut.errors[1].line);
+    EXPECT_EQ("Invalid ECCENTRICITY", dut.errors[1].message);
+    EXPECT_EQ(5u, dut.errors[2].line);
+    EXPECT_EQ("Unterminated quote", dut.errors[2].message);
+}
+
+TEST(OmmCsvReader_suite, OmmCsvReader_parallel)
+{
+    // enough rows for several chunks, a few of them bad
+    std::string text = iss_header;
+    for (int i = 0; i < 8000; i++)
+    {
+        std::string row = iss_row;
+        row.replace(row.find("25544"), 5, std::to_string(10000 + i));
+        if (i % 997 == 0)
+        {
+            row.replace(row.find("98.3376"), 7, "98.33x6");
+        }
+        text += row;
+    }
+
+    csgp4::TleCatalog serial = csgp4::TleCatalog::ParseOmmCsv(text.data(), text.size(), 1);
+    csgp4::TleCatalog parallel = csgp4::TleCatalog::ParseOmmCsv(text.data(), text.size(), 4);
+
+    ASSERT_EQ(8000u - 9u, serial.Size());
+    ASSERT_EQ(serial.Size(), parallel.Size());
+    for (size_t i = 0; i < serial.Size(); i++)
+    {
+        ASSERT_EQ(serial.At(i).NoradNumber(), parallel.At(i).NoradNumber());
+    }
+    ASSERT_EQ(9u, parallel.Errors().size());
+    for (size_t i = 0; i < parallel.Errors().size(); i++)
+    {
+        EXPECT_EQ(2 + 997 * i, parallel.Errors()[i].line);
+        EXPECT_EQ("Invalid MEAN_ANOMALY", parallel.Errors()[i].message);
+    }
+}
+
+TEST(OmmCsvReader_suite, OmmCsvReader_load_file)
+{
+    const std::string path = ::testing::TempDir() + "test_OmmCsvReader.csv";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << iss_header << iss_row;
+    }
+    csgp4::TleCatalog dut = csgp4::TleCatalog::LoadOmmCsvFile(path);
+    std::remove(path.c_str());
+    EXPECT_TRUE(dut.Errors().empty());
+    ASSERT_EQ(1u, dut.Size());
+    EXPECT_EQ("ISS (ZARYA)", dut.At(0).Name());
+
+    dut = csgp4::TleCatalog::LoadOmmCsvFile(path);
+    EXPECT_EQ(0u, dut.Size());
+    ASSERT_EQ(1u, dut.Errors().size());
+    EXPECT_EQ(0u, dut.Errors()[0].line);
+}
@@ -0,0 +1,204 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/OmmJsonReader.h"
+#include "csgp4/SGP4.h"
+
+#include "omm_common.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+
+// the same element set as iss_tle1/2, as Celestrak serves it
+static const std::string iss_json =
+    "[{\n"
+    "    \"OBJECT_NAME\": \"ISS (ZARYA)\",\n"
+    "    \"OBJECT_ID\": \"1998-067A\",\n"
+    "    \"EPOCH\": \"2022-11-10T12:05:22.994304\",\n"
+    "    \"MEAN_MOTION\": 15.49917581,\n"
+    "    \"ECCENTRICITY\": 0.0006814,\n"
+    "    \"INCLINATION\": 51.6436,\n"
+    "    \"RA_OF_ASC_NODE\": 331.7596,\n"
+    "    \"ARG_OF_PERICENTER\": 57.2751,\n"
+    "    \"MEAN_ANOMALY\": 98.3376,\n"
+    "    \"EPHEMERIS_TYPE\": 0,\n"
+    "    \"CLASSIFICATION_TYPE\": \"U\",\n"
+    "    \"NORAD_CAT_ID\": 25544,\n"
+    "    \"ELEMENT_SET_NO\": 999,\n"
+    "    \"REV_AT_EPOCH\": 36787,\n"
+    "    \"BSTAR\": 0.000263,\n"
+    "    \"MEAN_MOTION_DOT\": 0.00014546,\n"
+    "    \"MEAN_MOTION_DDOT\": 0\n"
+    "}]\n";
+
+TEST(OmmJsonReader_suite, OmmJsonReader_celestrak)
+{
+    auto dut = Read<csgp4::OmmJsonReader>(iss_json);
+    EXPECT_TRUE(dut.errors.empty());
+    ASSERT_EQ(1u, dut.tles.size());
+
+    const csgp4::Tle& tle = dut.tles[0];
+    EXPECT_EQ("ISS (ZARYA)", tle.Name());
+    EXPECT_EQ("1998-067A", tle.IntDesignator());
+    EXPECT_EQ("U", tle.ClassificationType());
+    EXPECT_EQ(25544u, tle.NoradNumber());
+    EXPECT_EQ(36787u, tle.OrbitNumber());
+    EXPECT_EQ("2022-11-10 12:05:22.994304 UTC", tle.Epoch().ToString());
+
+    // propagates as the two line element set does
+    csgp4::Tle expect(iss_tle1, iss_tle2);
+    EXPECT_EQ(expect.MeanMotion(), tle.MeanMotion());
+    EXPECT_EQ(expect.BStar(), tle.BStar());
+    EXPECT_NEAR(0.0, (tle.Epoch() - expect.Epoch()).TotalMicroseconds(), 1.0);
+    csgp4::Eci a = csgp4::SGP4(tle).FindPosition(tle.Epoch().AddMinutes(90.0));
+    csgp4::Eci b = csgp4::SGP4(expect).FindPosition(tle.Epoch().AddMinutes(90.0));
+    EXPECT_NEAR(0.0, (a.Position() - b.Position()).Magnitude(), 1e-5);
+}
+
+TEST(OmmJsonReader_suite, OmmJsonReader_epoch_as_TleArgs)
+{
+    // the reader and Tle(TleArgs) decode a fractional second epoch alike
+    auto dut = Read<csgp4::OmmJsonReader>(iss_json);
+    ASSERT_EQ(1u, dut.tles.size());
+
+    csgp4::TleArgs args;
+    args.name = "ISS (ZARYA)";
+    args.int_designator = "1998-067A";
+    args.epoch = "2022-11-10T12:05:22.994304";
+    args.classification_type = "U";
+    args.mean_motion = 15.49917581;
+    args.eccentricity = 0.0006814;
+    args.inclination = 51.6436;
+    args.right_ascending_node = 331.7596;
+    args.argument_perigee = 57.2751;
+    args.mean_anomaly = 98.3376;
+    args.norad_number = 25544;
+    args.orbit_number = 36787;
+    args.bstar = 0.000263;
+    args.mean_motion_dot = 0.00014546;
+    args.mean_motion_ddot = 0;
+    const csgp4::Tle expect(args);
+
+    EXPECT_EQ(expect.Epoch(), dut.tles[0].Epoch());
+    EXPECT_EQ(expect.ToString(), dut.tles[0].ToString());
+}
+
+TEST(OmmJsonReader_suite, OmmJsonReader_split)
+{
+    // every split of the text into two pieces reads the same
+    const std::string text = iss_json.substr(0, iss_json.size() - 2)
+        + ",{\"OBJECT_NAME\":\"A\\u00e9\\\"B\",\"EPOCH\":\"2022-11-10T12:05:22.994304Z\","
+          "\"MEAN_MOTION\":\"15.5\",\"ECCENTRICITY\":\"0.001\",\"INCLINATION\":\"51.6\","
+          "\"RA_OF_ASC_NODE\":\"10\",\"ARG_OF_PERICENTER\":\"20\",\"MEAN_ANOMALY\":\"30\","
+          "\"NORAD_CAT_ID\":\"99999\",\"EXTRA\":{\"A\":[1,\"}\"]},\"BSTAR\":null}]";
+    auto whole = Read<csgp4::OmmJsonReader>(text);
+    ASSERT_TRUE(whole.errors.empty());
+    ASSERT_EQ(2u, whole.tles.size());
+    EXPECT_EQ("A\xc3\xa9\"B", whole.tles[1].Name());
+    EXPECT_EQ(99999u, whole.tles[1].NoradNumber());
+    EXPECT_EQ(0.0, whole.tles[1].BStar());
+
+    for (size_t split = 0; split <= text.size(); split++)
+    {
+        Collected<csgp4::OmmJsonReader> dut;
+        csgp4::OmmJsonReader reader = dut.Reader();
+        reader.Feed(text.data(), split);
+        reader.Feed(text.data() + split, text.size() - split);
+        ASSERT_TRUE(reader.Finish());
+        ASSERT_EQ(2u, dut.tles.size());
+        ASSERT_EQ(whole.tles[1].Name(), dut.tles[1].Name());
+        ASSERT_EQ(whole.tles[0].ToString(), dut.tles[0].ToString());
+        ASSERT_EQ(whole.tles[1].ToString(), dut.tles[1].ToString());
+    }
+}
+
+TEST(OmmJsonReader_suite, OmmJsonReader_record_errors)
+{
+    // one object per line, without the enclosing array
+    std::string good = iss_json.substr(1, iss_json.size() - 3);
+    std::string text;
+    for (char c : good)
+    {
+        if (c != '\n')
+        {
+            text += c;
+        }
+    }
+    std::string missing = text;
+    missing.replace(missing.find("\"INCLINATION\""), 13, "\"INCLINATIONS\"");
+    std::string invalid = text;
+    invalid.replace(invalid.find("0.0006814"), 9, "\"0.000x\" ");
+    std::string epoch = text;
+    epoch.replace(epoch.find("2022-11-10T"), 11, "2022-13-10T");
+    auto dut = Read<csgp4::OmmJsonReader>(text + "\n" + missing + "\n" + invalid + "\n" + epoch + "\n" + text + "\n");
+
+    EXPECT_EQ(2u, dut.tles.size());
+    ASSERT_EQ(3u, dut.errors.size());
+    EXPECT_EQ(2u, dut.errors[0].line);
+    EXPECT_EQ("Missing INCLINATION", dut.errors[0].message);
+    EXPECT_EQ(3u, dut.errors[1].line);
+    EXPECT_EQ("Invalid ECCENTRICITY", dut.errors[1].message);
+    EXPECT_EQ(4u, dut.errors[2].line);
+    EXPECT_EQ("Invalid EPOCH", dut.errors[2].message);
+}
+
+TEST(OmmJsonReader_suite, OmmJsonReader_syntax_errors)
+{
+    // a syntax error stops the reader
+    auto dut = Read<csgp4::OmmJsonReader>(iss_json + "\n{\"OBJECT_NAME\" \"X\"}\n" + iss_json, false);
+    EXPECT_EQ(1u, dut.tles.size());
+    ASSERT_EQ(1u, dut.errors.size());
+    EXPECT_EQ(21u, dut.errors[0].line);
+    EXPECT_EQ("Invalid JSON, unexpected '\"'", dut.errors[0].message);
+
+    // as does the text ending part way through
+    dut = Read<csgp4::OmmJsonReader>(iss_json.substr(0, 100), false);
+    EXPECT_EQ(0u, dut.tles.size());
+    ASSERT_EQ(1u, dut.errors.size());
+    EXPECT_EQ("Unexpected end of JSON", dut.errors[0].message);
+}
+
+TEST(OmmJsonReader_suite, OmmJsonReader_load_file)
+{
+    const std::string path = ::testing::TempDir() + "test_OmmJsonReader.json";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << iss_json;
+    }
+    csgp4::TleCatalog dut = csgp4::TleCatalog::LoadOmmJsonFile(path);
+    std::remove(path.c_str());
+    EXPECT_TRUE(dut.Errors().empty());
+    ASSERT_EQ(1u, dut.Size());
+    EXPECT_EQ("ISS (ZARYA)", dut.At(0).Name());
+
+    dut = csgp4::TleCatalog::LoadOmmJsonFile(path);
+    EXPECT_EQ(0u, dut.Size());
+    ASSERT_EQ(1u, dut.Errors().size());
+    EXPECT_EQ(0u, dut.Errors()[0].line);
+}
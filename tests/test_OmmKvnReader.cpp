@@ -0,0 +1,157 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/OmmKvnReader.h"
+#include "csgp4/SGP4.h"
+
+#include "omm_common.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+
+// the same element set as iss_tle1/2, as Space-Track serves it
+static const std::string iss_kvn =
+    "CCSDS_OMM_VERS = 2.0\n"
+    "COMMENT GENERATED VIA SPACE-TRACK.ORG API\n"
+    "CREATION_DATE = 2022-11-10T18:00:00\n"
+    "ORIGINATOR = 18 SPCS\n"
+    "OBJECT_NAME = ISS (ZARYA)\n"
+    "OBJECT_ID = 1998-067A\n"
+    "CENTER_NAME = EARTH\n"
+    "REF_FRAME = TEME\n"
+    "TIME_SYSTEM = UTC\n"
+    "MEAN_ELEMENT_THEORY = SGP4\n"
+    "EPOCH = 2022-11-10T12:05:22.994304\n"
+    "MEAN_MOTION = 15.49917581 [rev/day]\n"
+    "ECCENTRICITY = .00068140\n"
+    "INCLINATION = 51.6436 [deg]\n"
+    "RA_OF_ASC_NODE = 331.7596 [deg]\n"
+    "ARG_OF_PERICENTER = 57.2751 [deg]\n"
+    "MEAN_ANOMALY = 98.3376 [deg]\n"
+    "EPHEMERIS_TYPE = 0\n"
+    "CLASSIFICATION_TYPE = U\n"
+    "NORAD_CAT_ID = 25544\n"
+    "ELEMENT_SET_NO = 999\n"
+    "REV_AT_EPOCH = 36787\n"
+    "BSTAR = .26300000E-3 [1/ER]\n"
+    "MEAN_MOTION_DOT = .14546000E-3 [rev/day**2]\n"
+    "MEAN_MOTION_DDOT = 0.0 [rev/day**3]\n";
+
+TEST(OmmKvnReader_suite, OmmKvnReader_space_track)
+{
+    auto dut = Read<csgp4::OmmKvnReader>(iss_kvn);
+    EXPECT_TRUE(dut.errors.empty());
+    ASSERT_EQ(1u, dut.tles.size());
+
+    const csgp4::Tle& tle = dut.tles[0];
+    EXPECT_EQ("ISS (ZARYA)", tle.Name());
+    EXPECT_EQ("1998-067A", tle.IntDesignator());
+    EXPECT_EQ("U", tle.ClassificationType());
+    EXPECT_EQ(25544u, tle.NoradNumber());
+    EXPECT_EQ(36787u, tle.OrbitNumber());
+    EXPECT_EQ("2022-11-10 12:05:22.994304 UTC", tle.Epoch().ToString());
+
+    // propagates as the two line element set does
+    csgp4::Tle expect(iss_tle1, iss_tle2);
+    EXPECT_EQ(expect.MeanMotion(), tle.MeanMotion());
+    EXPECT_EQ(expect.BStar(), tle.BStar());
+    csgp4::Eci a = csgp4::SGP4(tle).FindPosition(tle.Epoch().AddMinutes(90.0));
+    csgp4::Eci b = csgp4::SGP4(expect).FindPosition(tle.Epoch().AddMinutes(90.0));
+    EXPECT_NEAR(0.0, (a.Position() - b.Position()).Magnitude(), 1e-5);
+}
+
+TEST(OmmKvnReader_suite, OmmKvnReader_split)
+{
+    // every split of the text into two pieces reads the same, the second
+    // record without a header line, CRLF line ends or a last line end
+    const std::string text = iss_kvn +
+        "\r\n"
+        "  OBJECT_NAME=A [B]\r\n"
+        "EPOCH = 2022-11-10T12:05:22.994304Z\r\n"
+        "MEAN_MOTION = 15.5\r\nECCENTRICITY = 0.001\r\nINCLINATION = 51.6\r\n"
+        "RA_OF_ASC_NODE = 10\r\nARG_OF_PERICENTER = 20\r\nMEAN_ANOMALY = 30\r\n"
+        "NORAD_CAT_ID = 99999";
+    auto whole = Read<csgp4::OmmKvnReader>(text);
+    ASSERT_TRUE(whole.errors.empty());
+    ASSERT_EQ(2u, whole.tles.size());
+    EXPECT_EQ("A [B]", whole.tles[1].Name());
+    EXPECT_EQ(99999u, whole.tles[1].NoradNumber());
+
+    for (size_t split = 0; split <= text.size(); split++)
+    {
+        Collected<csgp4::OmmKvnReader> dut;
+        csgp4::OmmKvnReader reader = dut.Reader();
+        reader.Feed(text.data(), split);
+        reader.Feed(text.data() + split, text.size() - split);
+        reader.Finish();
+        ASSERT_TRUE(dut.errors.empty());
+        ASSERT_EQ(2u, dut.tles.size());
+        ASSERT_EQ(whole.tles[1].Name(), dut.tles[1].Name());
+        ASSERT_EQ(whole.tles[0].ToString(), dut.tles[0].ToString());
+        ASSERT_EQ(whole.tles[1].ToString(), dut.tles[1].ToString());
+    }
+}
+
+TEST(OmmKvnReader_suite, OmmKvnReader_record_errors)
+{
+    std::string missing = iss_kvn;
+    missing.replace(missing.find("51.6436 [deg]"), 13, "");
+    std::string invalid = iss_kvn;
+    invalid.replace(invalid.find(".00068140"), 9, "0.000x");
+    std::string line = iss_kvn;
+    line.replace(line.find("REF_FRAME = TEME"), 16, "REF_FRAME TEME");
+    auto dut = Read<csgp4::OmmKvnReader>(iss_kvn + missing + invalid + line + iss_kvn);
+
+    EXPECT_EQ(2u, dut.tles.size());
+    ASSERT_EQ(3u, dut.errors.size());
+    EXPECT_EQ(26u, dut.errors[0].line);
+    EXPECT_EQ("Missing INCLINATION", dut.errors[0].message);
+    EXPECT_EQ(51u, dut.errors[1].line);
+    EXPECT_EQ("Invalid ECCENTRICITY", dut.errors[1].message);
+    EXPECT_EQ(76u, dut.errors[2].line);
+    EXPECT_EQ("Invalid line", dut.errors[2].message);
+}
+
+TEST(OmmKvnReader_suite, OmmKvnReader_load_file)
+{
+    const std::string path = ::testing::TempDir() + "test_OmmKvnReader.kvn";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << iss_kvn << iss_kvn;
+    }
+    csgp4::TleCatalog dut = csgp4::TleCatalog::LoadOmmKvnFile(path);
+    std::remove(path.c_str());
+    EXPECT_TRUE(dut.Errors().empty());
+    ASSERT_EQ(2u, dut.Size());
+    EXPECT_EQ("ISS (ZARYA)", dut.At(1).Name());
+
+    dut = csgp4::TleCatalog::LoadOmmKvnFile(path);
+    EXPECT_EQ(0u, dut.Size());
+    ASSERT_EQ(1u, dut.Errors().size());
+    EXPECT_EQ(0u, dut.Errors()[0].line);
+}
@@ -0,0 +1,164 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/OmmXmlReader.h"
+#include "csgp4/SGP4.h"
+
+#include "omm_common.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+
+// the same element set as iss_tle1/2, as Celestrak serves it
+static const std::string iss_omm =
+    "<omm id=\"CCSDS_OMM_VERS\" version=\"2.0\">\n"
+    "<header><CREATION_DATE/><ORIGINATOR/></header>\n"
+    "<body><segment><metadata>"
+    "<OBJECT_NAME>ISS (ZARYA)</OBJECT_NAME><OBJECT_ID>1998-067A</OBJECT_ID>"
+    "<CENTER_NAME>EARTH</CENTER_NAME><REF_FRAME>TEME</REF_FRAME><TIME_SYSTEM>UTC</TIME_SYSTEM>"
+    "<MEAN_ELEMENT_THEORY>SGP4</MEAN_ELEMENT_THEORY></metadata>\n"
+    "<data><meanElements><EPOCH>2022-11-10T12:05:22.994304</EPOCH>"
+    "<MEAN_MOTION>15.49917581</MEAN_MOTION><ECCENTRICITY>.0006814</ECCENTRICITY>"
+    "<INCLINATION>51.6436</INCLINATION><RA_OF_ASC_NODE>331.7596</RA_OF_ASC_NODE>"
+    "<ARG_OF_PERICENTER>57.2751</ARG_OF_PERICENTER><MEAN_ANOMALY>98.3376</MEAN_ANOMALY>"
+    "</meanElements>\n"
+    "<tleParameters><EPHEMERIS_TYPE>0</EPHEMERIS_TYPE><CLASSIFICATION_TYPE>U</CLASSIFICATION_TYPE>"
+    "<NORAD_CAT_ID>25544</NORAD_CAT_ID><ELEMENT_SET_NO>999</ELEMENT_SET_NO>"
+    "<REV_AT_EPOCH>36787</REV_AT_EPOCH><BSTAR>.263E-3</BSTAR>"
+    "<MEAN_MOTION_DOT>.14546E-3</MEAN_MOTION_DOT><MEAN_MOTION_DDOT>0</MEAN_MOTION_DDOT>"
+    "</tleParameters></data></segment></body></omm>\n";
+
+static const std::string ndm_begin =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<ndm xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\" "
+    "xsi:noNamespaceSchemaLocation=\"https://sanaregistry.org/r/ndmxml_unqualified/ndmxml-2.0.0-master-2.0.xsd\">\n";
+static const std::string ndm_end = "</ndm>\n";
+
+TEST(OmmXmlReader_suite, OmmXmlReader_celestrak)
+{
+    auto dut = Read<csgp4::OmmXmlReader>(ndm_begin + iss_omm + ndm_end);
+    EXPECT_TRUE(dut.errors.empty());
+    ASSERT_EQ(1u, dut.tles.size());
+
+    const csgp4::Tle& tle = dut.tles[0];
+    EXPECT_EQ("ISS (ZARYA)", tle.Name());
+    EXPECT_EQ("1998-067A", tle.IntDesignator());
+    EXPECT_EQ("U", tle.ClassificationType());
+    EXPECT_EQ(25544u, tle.NoradNumber());
+    EXPECT_EQ(36787u, tle.OrbitNumber());
+    EXPECT_EQ("2022-11-10 12:05:22.994304 UTC", tle.Epoch().ToString());
+
+    // propagates as the two line element set does
+    csgp4::Tle expect(iss_tle1, iss_tle2);
+    EXPECT_EQ(expect.MeanMotion(), tle.MeanMotion());
+    EXPECT_EQ(expect.BStar(), tle.BStar());
+    csgp4::Eci a = csgp4::SGP4(tle).FindPosition(tle.Epoch().AddMinutes(90.0));
+    csgp4::Eci b = csgp4::SGP4(expect).FindPosition(tle.Epoch().AddMinutes(90.0));
+    EXPECT_NEAR(0.0, (a.Position() - b.Position()).Magnitude(), 1e-5);
+}
+
+TEST(OmmXmlReader_suite, OmmXmlReader_split)
+{
+    // every split of the text into two pieces reads the same, with
+    // markup to skip, prefixes, entities and CDATA
+    const std::string text = ndm_begin + iss_omm +
+        "<!-- a -> comment -->\n"
+        "<!DOCTYPE x [ <!ENTITY y \"z\"> ]>\n"
+        "<n:omm a='>'><n:OBJECT_NAME> A&amp;&#x42;&lt;<![CDATA[&]]]]><![CDATA[>]]> </n:OBJECT_NAME>"
+        "<?pi ?> ?><EPOCH>2022-11-10T12:05:22.994304Z</EPOCH>"
+        "<MEAN_MOTION>15.5</MEAN_MOTION><ECCENTRICITY>0.001</ECCENTRICITY><INCLINATION>51.6</INCLINATION>"
+        "<RA_OF_ASC_NODE>10</RA_OF_ASC_NODE><ARG_OF_PERICENTER>20</ARG_OF_PERICENTER>"
+        "<MEAN_ANOMALY>30</MEAN_ANOMALY><NORAD_CAT_ID>99999</NORAD_CAT_ID><BSTAR/></n:omm>\n"
+        + ndm_end;
+    auto whole = Read<csgp4::OmmXmlReader>(text);
+    ASSERT_TRUE(whole.errors.empty());
+    ASSERT_EQ(2u, whole.tles.size());
+    EXPECT_EQ("A&B<&]]>", whole.tles[1].Name());
+    EXPECT_EQ(99999u, whole.tles[1].NoradNumber());
+    EXPECT_EQ(0.0, whole.tles[1].BStar());
+
+    for (size_t split = 0; split <= text.size(); split++)
+    {
+        Collected<csgp4::OmmXmlReader> dut;
+        csgp4::OmmXmlReader reader = dut.Reader();
+        reader.Feed(text.data(), split);
+        reader.Feed(text.data() + split, text.size() - split);
+        ASSERT_TRUE(reader.Finish());
+        ASSERT_TRUE(dut.errors.empty());
+        ASSERT_EQ(2u, dut.tles.size());
+        ASSERT_EQ(whole.tles[1].Name(), dut.tles[1].Name());
+        ASSERT_EQ(whole.tles[0].ToString(), dut.tles[0].ToString());
+        ASSERT_EQ(whole.tles[1].ToString(), dut.tles[1].ToString());
+    }
+}
+
+TEST(OmmXmlReader_suite, OmmXmlReader_record_errors)
+{
+    std::string missing = iss_omm;
+    missing.replace(missing.find("<INCLINATION>"), 13, "<INCLINATIONS>");
+    std::string invalid = iss_omm;
+    invalid.replace(invalid.find(".0006814"), 8, "0.000x");
+    std::string entity = iss_omm;
+    entity.replace(entity.find("ISS (ZARYA)"), 3, "&is;");
+    auto dut = Read<csgp4::OmmXmlReader>(ndm_begin + iss_omm + missing + invalid + entity + iss_omm + ndm_end);
+
+    EXPECT_EQ(2u, dut.tles.size());
+    ASSERT_EQ(3u, dut.errors.size());
+    EXPECT_EQ(8u, dut.errors[0].line);
+    EXPECT_EQ("Missing INCLINATION", dut.errors[0].message);
+    EXPECT_EQ(13u, dut.errors[1].line);
+    EXPECT_EQ("Invalid ECCENTRICITY", dut.errors[1].message);
+    EXPECT_EQ(18u, dut.errors[2].line);
+    EXPECT_EQ("Invalid entity", dut.errors[2].message);
+
+    // the text ending part way through
+    dut = Read<csgp4::OmmXmlReader>(ndm_begin + iss_omm.substr(0, 200), false);
+    EXPECT_EQ(0u, dut.tles.size());
+    ASSERT_EQ(1u, dut.errors.size());
+    EXPECT_EQ(5u, dut.errors[0].line);
+    EXPECT_EQ("Unexpected end of XML", dut.errors[0].message);
+}
+
+TEST(OmmXmlReader_suite, OmmXmlReader_load_file)
+{
+    const std::string path = ::testing::TempDir() + "test_OmmXmlReader.xml";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << ndm_begin << iss_omm << ndm_end;
+    }
+    csgp4::TleCatalog dut = csgp4::TleCatalog::LoadOmmXmlFile(path);
+    std::remove(path.c_str());
+    EXPECT_TRUE(dut.Errors().empty());
+    ASSERT_EQ(1u, dut.Size());
+    EXPECT_EQ("ISS (ZARYA)", dut.At(0).Name());
+
+    dut = csgp4::TleCatalog::LoadOmmXmlFile(path);
+    EXPECT_EQ(0u, dut.Size());
+    ASSERT_EQ(1u, dut.Errors().size());
+    EXPECT_EQ(0u, dut.Errors()[0].line);
+}
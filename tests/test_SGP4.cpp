@@ -23,6 +23,8 @@
 #include <cmath>
 #include <string>
 #include <sstream>
+#include <thread>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "csgp4/SGP4.h"
@@ -49,3 +51,228 @@ TEST(SGP4_suite, SGP4_pos_at_epoch)
     std::string actual = dut.ToString();
     EXPECT_STREQ(expect.c_str(), actual.c_str());
 }
+
+static std::string geo_tle0("XM-3");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+
+static void expect_batch_matches(const csgp4::SGP4& sgp4, const double* tsince, size_t n,
+    const double* x, const double* y, const double* z,
+    const double* xdot, const double* ydot, const double* zdot)
+{
+    for (size_t i = 0; i < n; i++) {
+        csgp4::Eci eci = sgp4.FindPosition(tsince[i]);
+        EXPECT_DOUBLE_EQ(eci.Position().x, x[i]);
+        EXPECT_DOUBLE_EQ(eci.Position().y, y[i]);
+        EXPECT_DOUBLE_EQ(eci.Position().z, z[i]);
+        EXPECT_DOUBLE_EQ(eci.Velocity().x, xdot[i]);
+        EXPECT_DOUBLE_EQ(eci.Velocity().y, ydot[i]);
+        EXPECT_DOUBLE_EQ(eci.Velocity().z, zdot[i]);
+    }
+}
+
+TEST(SGP4_suite, SGP4_find_positions_array)
+{
+    csgp4::Tle tle(iss_tle0, iss_tle1, iss_tle2);
+    csgp4::SGP4 sgp4(tle);
+    const size_t n = 5;
+    double tsince[n] = { 0.0, 1.5, -30.0, 720.0, 1440.0 };
+    double x[n], y[n], z[n], xdot[n], ydot[n], zdot[n];
+    sgp4.FindPositions(tsince, n, x, y, z, xdot, ydot, zdot);
+    expect_batch_matches(sgp4, tsince, n, x, y, z, xdot, ydot, zdot);
+}
+
+TEST(SGP4_suite, SGP4_find_positions_grid_deep_space)
+{
+    csgp4::Tle tle(geo_tle0, geo_tle1, geo_tle2);
+    csgp4::SGP4 sgp4(tle);
+    const size_t n = 8;
+    double tsince[n];
+    double x[n], y[n], z[n], xdot[n], ydot[n], zdot[n];
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = -720.0 + 480.0 * i;
+    }
+    sgp4.FindPositions(-720.0, 480.0, n, x, y, z, xdot, ydot, zdot);
+    expect_batch_matches(sgp4, tsince, n, x, y, z, xdot, ydot, zdot);
+}
+
+static std::string molniya_tle0("MOLNIYA 2-14");
+static std::string molniya_tle1("1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813");
+static std::string molniya_tle2("2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+
+// Shares one const SGP4 per resonant object between threads that each
+// sample +/-30 days in a different order. Build with
+// -DLIBCSGP4_SANITIZE_THREAD=ON to have ThreadSanitizer check for races.
+TEST(SGP4_suite, SGP4_shared_resonant_threads)
+{
+    const csgp4::SGP4 geo(csgp4::Tle(geo_tle0, geo_tle1, geo_tle2));
+    const csgp4::SGP4 molniya(csgp4::Tle(molniya_tle0, molniya_tle1, molniya_tle2));
+    const csgp4::SGP4* models[2] = { &geo, &molniya };
+
+    const size_t n = 181;
+    std::vector<double> tsince(n);
+    std::vector<double> expect_x[2], expect_vz[2];
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = -43200.0 + 480.0 * i;
+    }
+    for (int m = 0; m < 2; m++) {
+        for (size_t i = 0; i < n; i++) {
+            csgp4::SGP4::IntegratorParams fresh;
+            csgp4::Eci eci = models[m]->FindPosition(tsince[i], fresh);
+            expect_x[m].push_back(eci.Position().x);
+            expect_vz[m].push_back(eci.Velocity().z);
+        }
+    }
+
+    const int num_threads = 8;
+    std::vector<int> mismatches(num_threads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++) {
+        threads.emplace_back([&, t]() {
+            csgp4::SGP4::IntegratorParams own[2];
+            for (size_t k = 0; k < n; k++) {
+                // a different visiting order per thread, forwards and backwards
+                const size_t i = (k * (2 * t + 1) + 7 * t) % n;
+                for (int m = 0; m < 2; m++) {
+                    csgp4::Eci shared = models[m]->FindPosition(tsince[i]);
+                    csgp4::Eci owned = models[m]->FindPosition(tsince[i], own[m]);
+                    if (shared.Position().x != expect_x[m][i] ||
+                        shared.Velocity().z != expect_vz[m][i] ||
+                        owned.Position().x != expect_x[m][i] ||
+                        owned.Velocity().z != expect_vz[m][i]) {
+                        mismatches[t]++;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int t = 0; t < num_threads; t++) {
+        EXPECT_EQ(0, mismatches[t]);
+    }
+}
+
+TEST(SGP4_suite, SGP4_integrator_checkpoints)
+{
+    csgp4::SGP4 geo(csgp4::Tle(geo_tle0, geo_tle1, geo_tle2));
+    csgp4::SGP4 molniya(csgp4::Tle(molniya_tle0, molniya_tle1, molniya_tle2));
+    csgp4::SGP4* models[2] = { &geo, &molniya };
+
+    // random order times, some on and either side of step boundaries
+    std::vector<double> tsince;
+    for (int i = 0; i < 200; i++) {
+        tsince.push_back(-43200.0 + 86400.0 * ((i * 7919) % 200) / 199.0);
+    }
+    tsince.push_back(1440.0);
+    tsince.push_back(-2160.0);
+    tsince.push_back(std::nextafter(720.0, 0.0));
+    tsince.push_back(719.0);
+    tsince.push_back(0.0);
+    tsince.push_back(50000.0); // beyond the table
+
+    for (int m = 0; m < 2; m++) {
+        std::vector<csgp4::Eci> expect;
+        for (double t : tsince) {
+            csgp4::SGP4::IntegratorParams fresh;
+            expect.push_back(models[m]->FindPosition(t, fresh));
+        }
+
+        models[m]->BuildIntegratorCheckpoints(43200.0, -43200.0);
+        csgp4::SGP4::IntegratorParams integ;
+        for (size_t i = 0; i < tsince.size(); i++) {
+            csgp4::Eci shared = models[m]->FindPosition(tsince[i]);
+            csgp4::Eci owned = models[m]->FindPosition(tsince[i], integ);
+            EXPECT_EQ(expect[i].Position().x, shared.Position().x);
+            EXPECT_EQ(expect[i].Position().y, shared.Position().y);
+            EXPECT_EQ(expect[i].Velocity().z, shared.Velocity().z);
+            EXPECT_EQ(expect[i].Position().x, owned.Position().x);
+            EXPECT_EQ(expect[i].Velocity().z, owned.Velocity().z);
+        }
+    }
+}
+
+TEST(SGP4_suite, SGP4_try_find_position)
+{
+    // the STR#3 test object, drag drives its eccentricity negative within a year
+    std::string str3_tle1("1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    18");
+    std::string str3_tle2("2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518   105");
+    csgp4::SGP4 str3(csgp4::Tle(str3_tle1, str3_tle2));
+    csgp4::Vector position, velocity;
+    EXPECT_EQ(csgp4::PROPAGATION_OK, str3.TryFindPosition(0.0, position, velocity));
+    csgp4::Eci eci = str3.FindPosition(0.0);
+    EXPECT_EQ(eci.Position().x, position.x);
+    EXPECT_EQ(eci.Velocity().z, velocity.z);
+
+    const double tsince = 525600.0;
+    EXPECT_EQ(csgp4::PROPAGATION_ECCENTRICITY, str3.TryFindPosition(tsince, position, velocity));
+    EXPECT_THROW(str3.FindPosition(tsince), csgp4::SatelliteException);
+
+    std::vector<double> times = { 0.0, tsince, 90.0 };
+    std::vector<double> x(3), y(3), z(3), xdot(3), ydot(3), zdot(3);
+    std::vector<csgp4::PropagationStatus> status(3);
+    str3.FindPositions(times.data(), 3, x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data(), status.data());
+    EXPECT_EQ(csgp4::PROPAGATION_OK, status[0]);
+    EXPECT_EQ(csgp4::PROPAGATION_ECCENTRICITY, status[1]);
+    EXPECT_EQ(csgp4::PROPAGATION_OK, status[2]);
+    EXPECT_EQ(str3.FindPosition(90.0).Position().y, y[2]);
+}
+
+TEST(SGP4_suite, SGP4_position_only)
+{
+    const csgp4::SGP4 iss(csgp4::Tle(iss_tle0, iss_tle1, iss_tle2));
+    const csgp4::SGP4 geo(csgp4::Tle(geo_tle0, geo_tle1, geo_tle2));
+    const csgp4::SGP4 molniya(csgp4::Tle(molniya_tle0, molniya_tle1, molniya_tle2));
+    const csgp4::SGP4* models[3] = { &iss, &geo, &molniya };
+
+    std::vector<double> tsince;
+    for (int i = 0; i < 50; i++) {
+        tsince.push_back(-1440.0 + 97.3 * i);
+    }
+    const size_t n = tsince.size();
+
+    for (int m = 0; m < 3; m++) {
+        std::vector<double> x(n), y(n), z(n);
+        std::vector<csgp4::PropagationStatus> status(n);
+        models[m]->FindPositions(tsince.data(), n, x.data(), y.data(), z.data(), status.data());
+        for (size_t i = 0; i < n; i++) {
+            csgp4::Eci eci = models[m]->FindPosition(tsince[i]);
+            csgp4::Vector position = models[m]->FindPositionOnly(tsince[i]);
+            EXPECT_EQ(eci.Position().x, position.x);
+            EXPECT_EQ(eci.Position().y, position.y);
+            EXPECT_EQ(eci.Position().z, position.z);
+            EXPECT_EQ(csgp4::PROPAGATION_OK, status[i]);
+            EXPECT_EQ(eci.Position().x, x[i]);
+            EXPECT_EQ(eci.Position().y, y[i]);
+            EXPECT_EQ(eci.Position().z, z[i]);
+        }
+    }
+}
+
+TEST(SGP4_suite, SGP4_memory_usage)
+{
+    csgp4::SGP4 iss(csgp4::Tle(iss_tle0, iss_tle1, iss_tle2));
+    csgp4::SGP4 geo(csgp4::Tle(geo_tle0, geo_tle1, geo_tle2));
+
+    // near space objects do not carry the deep space constants
+    EXPECT_EQ(sizeof(csgp4::SGP4), iss.MemoryUsage());
+    EXPECT_GT(geo.MemoryUsage(), sizeof(csgp4::SGP4));
+    EXPECT_LT(sizeof(csgp4::SGP4), 400u);
+
+    const size_t before = geo.MemoryUsage();
+    geo.BuildIntegratorCheckpoints(0.0, 7200.0);
+    EXPECT_GT(geo.MemoryUsage(), before);
+    geo.ClearIntegratorCheckpoints();
+
+    // copies are deep and propagate identically
+    csgp4::SGP4 copy(geo);
+    csgp4::SGP4 assigned(iss);
+    assigned = geo;
+    EXPECT_EQ(geo.FindPosition(1000.0).Position().x, copy.FindPosition(1000.0).Position().x);
+    EXPECT_EQ(geo.FindPosition(1000.0).Position().x, assigned.FindPosition(1000.0).Position().x);
+    assigned = iss;
+    EXPECT_EQ(sizeof(csgp4::SGP4), assigned.MemoryUsage());
+    EXPECT_EQ(iss.FindPosition(10.0).Position().y, assigned.FindPosition(10.0).Position().y);
+}
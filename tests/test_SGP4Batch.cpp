@@ -0,0 +1,178 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/SGP4Batch.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+static std::string str3_tle1("1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    18");
+static std::string str3_tle2("2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518   105");
+
+static std::vector<csgp4::Tle> catalog()
+{
+    // 11 near space (not a whole number of blocks) plus a deep space object
+    std::vector<csgp4::Tle> tles;
+    for (int i = 0; i < 6; i++) {
+        tles.push_back(csgp4::Tle(iss_tle1, iss_tle2));
+        tles.push_back(csgp4::Tle(str3_tle1, str3_tle2));
+    }
+    tles.insert(tles.begin() + 3, csgp4::Tle(geo_tle1, geo_tle2));
+    tles.pop_back();
+    return tles;
+}
+
+static void expect_matches_scalar(const std::vector<csgp4::Tle>& tles, const double* tsince,
+    const double* x, const double* y, const double* z,
+    const double* xdot, const double* ydot, const double* zdot)
+{
+    for (size_t i = 0; i < tles.size(); i++) {
+        csgp4::SGP4 sgp4(tles[i]);
+        csgp4::Eci eci = sgp4.FindPosition(tsince[i]);
+        EXPECT_NEAR(eci.Position().x, x[i], 1.0e-8);
+        EXPECT_NEAR(eci.Position().y, y[i], 1.0e-8);
+        EXPECT_NEAR(eci.Position().z, z[i], 1.0e-8);
+        EXPECT_NEAR(eci.Velocity().x, xdot[i], 1.0e-11);
+        EXPECT_NEAR(eci.Velocity().y, ydot[i], 1.0e-11);
+        EXPECT_NEAR(eci.Velocity().z, zdot[i], 1.0e-11);
+    }
+}
+
+TEST(SGP4Batch_suite, SGP4Batch_counts)
+{
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4Batch dut(tles);
+    EXPECT_EQ(tles.size(), dut.Size());
+    EXPECT_EQ(11u, dut.NearSpaceCount());
+    EXPECT_EQ(1u, dut.DeepSpaceCount());
+}
+
+TEST(SGP4Batch_suite, SGP4Batch_tsince_matches_scalar)
+{
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4Batch dut(tles);
+    const size_t n = tles.size();
+    std::vector<double> tsince(n), x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = -1440.0 + 217.0 * i;
+    }
+    dut.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data());
+    expect_matches_scalar(tles, tsince.data(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data());
+}
+
+TEST(SGP4Batch_suite, SGP4Batch_date_matches_scalar)
+{
+    std::vector<csgp4::Tle> tles;
+    for (int i = 0; i < 9; i++) {
+        tles.push_back(csgp4::Tle(iss_tle1, iss_tle2));
+    }
+    tles.push_back(csgp4::Tle(geo_tle1, geo_tle2));
+    csgp4::SGP4Batch dut(tles);
+    const size_t n = tles.size();
+    std::vector<double> tsince(n), x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    csgp4::DateTime date = tles[0].Epoch().AddHours(3.0);
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = (date - tles[i].Epoch()).TotalMinutes();
+    }
+    dut.FindPositions(date, x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data());
+    expect_matches_scalar(tles, tsince.data(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data());
+}
+
+TEST(SGP4Batch_suite, SGP4Batch_lane_error_throws)
+{
+    // the STR#3 test object has long since decayed by the ISS epoch
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4Batch dut(tles);
+    const size_t n = tles.size();
+    std::vector<double> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    EXPECT_THROW(dut.FindPositions(tles[0].Epoch(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data()), csgp4::SatelliteException);
+}
+
+TEST(SGP4Batch_suite, SGP4Batch_lane_error_status)
+{
+    // failed lanes are marked and every other satellite is still propagated
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4Batch dut(tles);
+    const size_t n = tles.size();
+    std::vector<double> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    std::vector<csgp4::PropagationStatus> status(n);
+    std::vector<double> tsince(n);
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = (tles[0].Epoch() - tles[i].Epoch()).TotalMinutes();
+    }
+    dut.FindPositions(tles[0].Epoch(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data(), status.data());
+    for (size_t i = 0; i < n; i++) {
+        csgp4::SGP4 sgp4(tles[i]);
+        csgp4::Vector position, velocity;
+        EXPECT_EQ(sgp4.TryFindPosition(tsince[i], position, velocity), status[i]);
+        if (tles[i].NoradNumber() == 88888) {
+            EXPECT_EQ(csgp4::PROPAGATION_ECCENTRICITY, status[i]);
+        }
+        else {
+            EXPECT_EQ(csgp4::PROPAGATION_OK, status[i]);
+            EXPECT_NEAR(position.x, x[i], 1.0e-8);
+            EXPECT_NEAR(velocity.z, zdot[i], 1.0e-11);
+        }
+    }
+}
+
+TEST(SGP4Batch_suite, SGP4Batch_position_only)
+{
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4Batch dut(tles);
+    const size_t n = tles.size();
+    std::vector<double> tsince(n);
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = 10.0 * i - 30.0;
+    }
+    std::vector<double> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    std::vector<double> px(n), py(n), pz(n);
+    std::vector<csgp4::PropagationStatus> status(n), pstatus(n);
+    dut.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data(), status.data());
+    dut.FindPositions(tsince.data(), px.data(), py.data(), pz.data(), pstatus.data());
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_EQ(status[i], pstatus[i]);
+        EXPECT_EQ(x[i], px[i]);
+        EXPECT_EQ(y[i], py[i]);
+        EXPECT_EQ(z[i], pz[i]);
+    }
+}
+
+TEST(SGP4Batch_suite, SGP4Batch_memory_usage)
+{
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4Batch dut(tles);
+    EXPECT_GT(dut.MemoryUsage(), sizeof(dut) + dut.NearSpaceCount() * sizeof(double));
+}
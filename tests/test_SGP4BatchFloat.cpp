@@ -0,0 +1,165 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/SGP4BatchFloat.h"
+
+#include "sgp4_ver.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+static std::string str3_tle1("1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    18");
+static std::string str3_tle2("2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518   105");
+
+static std::vector<csgp4::Tle> catalog()
+{
+    // 20 near space (more than one block) plus a deep space object
+    std::vector<csgp4::Tle> tles;
+    for (int i = 0; i < 10; i++) {
+        tles.push_back(csgp4::Tle(iss_tle1, iss_tle2));
+        tles.push_back(csgp4::Tle(str3_tle1, str3_tle2));
+    }
+    tles.insert(tles.begin() + 5, csgp4::Tle(geo_tle1, geo_tle2));
+    return tles;
+}
+
+// the position and velocity errors against the double precision model,
+// which the grids below keep within; see SGP4BatchFloat.h for the table
+static void expect_matches_scalar(const csgp4::SGP4& sgp4, double tsince,
+    float x, float y, float z, float xdot, float ydot, float zdot)
+{
+    csgp4::Eci eci = sgp4.FindPosition(tsince);
+    const csgp4::Vector& p = eci.Position();
+    const csgp4::Vector& v = eci.Velocity();
+    EXPECT_LT(std::sqrt((p.x - x) * (p.x - x) + (p.y - y) * (p.y - y) + (p.z - z) * (p.z - z)), 0.025);
+    EXPECT_LT(std::sqrt((v.x - xdot) * (v.x - xdot) + (v.y - ydot) * (v.y - ydot)
+        + (v.z - zdot) * (v.z - zdot)), 2.5e-5);
+}
+
+TEST(SGP4BatchFloat_suite, SGP4BatchFloat_counts)
+{
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4BatchFloat dut(tles);
+    EXPECT_EQ(tles.size(), dut.Size());
+    EXPECT_EQ(20u, dut.NearSpaceCount());
+    EXPECT_EQ(1u, dut.DeepSpaceCount());
+}
+
+TEST(SGP4BatchFloat_suite, SGP4BatchFloat_verification)
+{
+    // every near space case over its own grid, up to its first failure
+    for (size_t c = 0; c < kVerificationCount; c++) {
+        if (kVerificationCases[c].regime != REGIME_NEAR_SPACE) {
+            continue;
+        }
+        SCOPED_TRACE(kVerificationCases[c].name);
+        csgp4::SGP4 sgp4(VerificationTle(kVerificationCases[c]));
+        std::vector<double> tsince = VerificationGrid(kVerificationCases[c]);
+        const size_t n = tsince.size();
+        csgp4::SGP4BatchFloat dut(std::vector<csgp4::SGP4>(n, sgp4));
+        std::vector<float> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+        std::vector<csgp4::PropagationStatus> status(n);
+        dut.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+            xdot.data(), ydot.data(), zdot.data(), status.data());
+        for (size_t i = 0; i < n; i++) {
+            csgp4::Vector position, velocity;
+            ASSERT_EQ(sgp4.TryFindPosition(tsince[i], position, velocity), status[i]);
+            if (status[i] != csgp4::PROPAGATION_OK) {
+                break;
+            }
+            expect_matches_scalar(sgp4, tsince[i], x[i], y[i], z[i], xdot[i], ydot[i], zdot[i]);
+        }
+    }
+}
+
+TEST(SGP4BatchFloat_suite, SGP4BatchFloat_long_tsince)
+{
+    // the secular angles are reduced in double, so a low drag satellite
+    // stays within tolerance for 30 days
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    const size_t n = 30;
+    std::vector<double> tsince(n);
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = 1440.0 * i + 17.0;
+    }
+    csgp4::SGP4BatchFloat dut(std::vector<csgp4::SGP4>(n, sgp4));
+    std::vector<float> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    std::vector<csgp4::PropagationStatus> status(n);
+    dut.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data(), status.data());
+    for (size_t i = 0; i < n; i++) {
+        ASSERT_EQ(csgp4::PROPAGATION_OK, status[i]);
+        expect_matches_scalar(sgp4, tsince[i], x[i], y[i], z[i], xdot[i], ydot[i], zdot[i]);
+    }
+}
+
+TEST(SGP4BatchFloat_suite, SGP4BatchFloat_lane_error_status)
+{
+    // failed lanes are marked and every other satellite is still propagated
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4BatchFloat dut(tles);
+    const size_t n = tles.size();
+    std::vector<float> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    std::vector<csgp4::PropagationStatus> status(n);
+    dut.FindPositions(tles[0].Epoch(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data(), status.data());
+    for (size_t i = 0; i < n; i++) {
+        csgp4::SGP4 sgp4(tles[i]);
+        const double tsince = (tles[0].Epoch() - tles[i].Epoch()).TotalMinutes();
+        if (tles[i].NoradNumber() == 88888) {
+            EXPECT_EQ(csgp4::PROPAGATION_ECCENTRICITY, status[i]);
+        }
+        else {
+            ASSERT_EQ(csgp4::PROPAGATION_OK, status[i]);
+            expect_matches_scalar(sgp4, tsince, x[i], y[i], z[i], xdot[i], ydot[i], zdot[i]);
+        }
+    }
+}
+
+TEST(SGP4BatchFloat_suite, SGP4BatchFloat_position_only)
+{
+    std::vector<csgp4::Tle> tles = catalog();
+    csgp4::SGP4BatchFloat dut(tles);
+    const size_t n = tles.size();
+    std::vector<double> tsince(n);
+    for (size_t i = 0; i < n; i++) {
+        tsince[i] = 10.0 * i - 30.0;
+    }
+    std::vector<float> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+    std::vector<float> px(n), py(n), pz(n);
+    std::vector<csgp4::PropagationStatus> status(n), pstatus(n);
+    dut.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+        xdot.data(), ydot.data(), zdot.data(), status.data());
+    dut.FindPositions(tsince.data(), px.data(), py.data(), pz.data(), pstatus.data());
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_EQ(status[i], pstatus[i]);
+        EXPECT_EQ(x[i], px[i]);
+        EXPECT_EQ(y[i], py[i]);
+        EXPECT_EQ(z[i], pz[i]);
+    }
+}
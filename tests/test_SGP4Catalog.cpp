@@ -0,0 +1,99 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/SGP4Catalog.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string iss_new_tle1("1 25544U 98067A   22315.13226852  .00015138  00000-0  27326-3 0  9993");
+static std::string iss_new_tle2("2 25544  51.6434 328.6441 0006853  59.8911 108.6713 15.49924513367968");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+static std::string molniya_tle1("1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813");
+static std::string molniya_tle2("2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+
+TEST(SGP4Catalog_suite, SGP4Catalog_add_and_skip)
+{
+    std::vector<csgp4::Tle> tles = {
+        csgp4::Tle(iss_tle1, iss_tle2),
+        csgp4::Tle(geo_tle1, geo_tle2),
+        csgp4::Tle(molniya_tle1, molniya_tle2)
+    };
+    csgp4::SGP4Catalog dut;
+    csgp4::SGP4Catalog::UpdateResult result = dut.Update(tles);
+    EXPECT_EQ(3u, result.added);
+    EXPECT_EQ(3u, dut.Size());
+    EXPECT_EQ(nullptr, dut.Find(99999));
+    ASSERT_NE(nullptr, dut.Find(28626));
+    EXPECT_EQ(&dut.At(1), dut.Find(28626));
+
+    // reloading the same catalog changes nothing
+    const csgp4::SGP4* before = dut.Find(25544);
+    result = dut.Update(tles);
+    EXPECT_EQ(3u, result.unchanged);
+    EXPECT_EQ(0u, result.updated);
+    EXPECT_EQ(0u, result.added);
+    EXPECT_EQ(before, dut.Find(25544));
+}
+
+TEST(SGP4Catalog_suite, SGP4Catalog_update_in_place)
+{
+    csgp4::SGP4Catalog dut;
+    dut.Update({ csgp4::Tle(iss_tle1, iss_tle2), csgp4::Tle(geo_tle1, geo_tle2) });
+    const csgp4::SGP4* iss = dut.Find(25544);
+
+    csgp4::Tle updated(iss_new_tle1, iss_new_tle2);
+    csgp4::SGP4Catalog::UpdateResult result = dut.Update(
+        { csgp4::Tle(geo_tle1, geo_tle2), updated }, 4);
+    EXPECT_EQ(1u, result.unchanged);
+    EXPECT_EQ(1u, result.updated);
+    EXPECT_EQ(0u, result.failed);
+
+    // same object, now with the new elements
+    EXPECT_EQ(iss, dut.Find(25544));
+    EXPECT_EQ(updated.Epoch(), dut.TleAt(0).Epoch());
+    csgp4::SGP4 expect(updated);
+    EXPECT_EQ(expect.FindPosition(100.0).Position().x, iss->FindPosition(100.0).Position().x);
+}
+
+TEST(SGP4Catalog_suite, SGP4Catalog_failed_update_keeps_previous)
+{
+    csgp4::SGP4Catalog dut;
+    dut.Update({ csgp4::Tle(iss_tle1, iss_tle2) });
+    const double x = dut.At(0).FindPosition(10.0).Position().x;
+
+    // eccentricity above 0.999 is rejected by SGP4
+    csgp4::TleArgs args;
+    args.norad_number = 25544;
+    args.epoch = "2022-11-11T12:00:00.000000";
+    args.mean_motion = 15.5;
+    args.eccentricity = 0.9995;
+    args.inclination = 51.6;
+    csgp4::SGP4Catalog::UpdateResult result = dut.Update({ csgp4::Tle(args) });
+    EXPECT_EQ(1u, result.failed);
+    EXPECT_EQ(0u, result.updated);
+    EXPECT_EQ(x, dut.At(0).FindPosition(10.0).Position().x);
+}
@@ -0,0 +1,192 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "csgp4/SGP4.h"
+#include "csgp4/OrbitalElements.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+// perigee below 220 km, the simple model
+static std::string low_tle1("1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    18");
+static std::string low_tle2("2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518   105");
+
+// Central differences of the state over perturbed element sets, with steps
+// large enough that the 1.0e-12 Kepler tolerance is not amplified
+static void finite_differences(const csgp4::OrbitalElements& el, double tsince,
+                               csgp4::SGP4::StateJacobian& jacobian)
+{
+    const double values[csgp4::SGP4::ELEMENT_COUNT] = {
+        el.Inclination(), el.AscendingNode(), el.Eccentricity(),
+        el.ArgumentPerigee(), el.MeanAnomoly(), el.MeanMotion(), el.BStar()
+    };
+    const double steps[csgp4::SGP4::ELEMENT_COUNT] = {
+        1.0e-6, 1.0e-6, 1.0e-6, 1.0e-6, 1.0e-6, 1.0e-6 * el.MeanMotion(), 1.0e-7
+    };
+
+    for (int j = 0; j < csgp4::SGP4::ELEMENT_COUNT; j++) {
+        double state[2][6];
+        for (int k = 0; k < 2; k++) {
+            double v[csgp4::SGP4::ELEMENT_COUNT];
+            for (int i = 0; i < csgp4::SGP4::ELEMENT_COUNT; i++) {
+                v[i] = values[i];
+            }
+            v[j] += k ? steps[j] : -steps[j];
+            csgp4::SGP4 model(csgp4::OrbitalElements(v[4], v[1], v[3], v[2], v[0], v[5], v[6],
+                                                     el.Epoch(), el.Gravity()));
+            csgp4::Eci eci = model.FindPosition(tsince);
+            state[k][0] = eci.Position().x;
+            state[k][1] = eci.Position().y;
+            state[k][2] = eci.Position().z;
+            state[k][3] = eci.Velocity().x;
+            state[k][4] = eci.Velocity().y;
+            state[k][5] = eci.Velocity().z;
+        }
+        for (int i = 0; i < 6; i++) {
+            jacobian.partials[i][j] = (state[1][i] - state[0][i]) / (2.0 * steps[j]);
+        }
+    }
+}
+
+static void expect_jacobian_near(const csgp4::SGP4::StateJacobian& a,
+                                 const csgp4::SGP4::StateJacobian& b, double tolerance)
+{
+    for (int j = 0; j < csgp4::SGP4::ELEMENT_COUNT; j++) {
+        double scale[2] = { 0.0, 0.0 };
+        for (int i = 0; i < 6; i++) {
+            scale[i / 3] = std::max(scale[i / 3], fabs(b.partials[i][j]));
+        }
+        for (int i = 0; i < 6; i++) {
+            EXPECT_NEAR(a.partials[i][j], b.partials[i][j], tolerance * scale[i / 3])
+                << "row " << i << " element " << j;
+        }
+    }
+}
+
+TEST(SGP4Jacobian_suite, SGP4Jacobian_near_space)
+{
+    csgp4::Tle tle(iss_tle1, iss_tle2);
+    csgp4::OrbitalElements elements(tle);
+    csgp4::SGP4 sgp4(tle);
+
+    for (double tsince : { 0.0, 92.5, 1440.0, 10080.0 }) {
+        csgp4::SGP4::StateJacobian jacobian;
+        csgp4::Eci eci = sgp4.FindPositionJacobian(tsince, jacobian);
+        csgp4::Eci expected = sgp4.FindPosition(tsince);
+
+        // the state is that of the double model exactly
+        EXPECT_EQ(expected.Position().x, eci.Position().x);
+        EXPECT_EQ(expected.Position().y, eci.Position().y);
+        EXPECT_EQ(expected.Position().z, eci.Position().z);
+        EXPECT_EQ(expected.Velocity().x, eci.Velocity().x);
+        EXPECT_EQ(expected.Velocity().y, eci.Velocity().y);
+        EXPECT_EQ(expected.Velocity().z, eci.Velocity().z);
+
+        csgp4::SGP4::StateJacobian differences;
+        finite_differences(elements, tsince, differences);
+        expect_jacobian_near(jacobian, differences, 1.0e-5);
+    }
+}
+
+TEST(SGP4Jacobian_suite, SGP4Jacobian_simple_model)
+{
+    csgp4::Tle tle(low_tle1, low_tle2);
+    csgp4::OrbitalElements elements(tle);
+    csgp4::SGP4 sgp4(tle);
+
+    csgp4::SGP4::StateJacobian jacobian;
+    sgp4.FindPositionJacobian(360.0, jacobian);
+
+    csgp4::SGP4::StateJacobian differences;
+    finite_differences(elements, 360.0, differences);
+    expect_jacobian_near(jacobian, differences, 1.0e-5);
+}
+
+TEST(SGP4Jacobian_suite, SGP4Jacobian_deep_space)
+{
+    csgp4::Tle tle(geo_tle1, geo_tle2);
+    csgp4::OrbitalElements elements(tle);
+    csgp4::SGP4 sgp4(tle);
+
+    csgp4::SGP4::StateJacobian jacobian;
+    csgp4::Eci eci = sgp4.FindPositionJacobian(1440.0, jacobian);
+    csgp4::Eci expected = sgp4.FindPosition(1440.0);
+    EXPECT_EQ(expected.Position().x, eci.Position().x);
+    EXPECT_EQ(expected.Velocity().z, eci.Velocity().z);
+
+    // skip eccentricity, the orbit is too near circular to step both ways
+    csgp4::SGP4::StateJacobian differences;
+    finite_differences(elements, 1440.0, differences);
+    for (int j = 0; j < csgp4::SGP4::ELEMENT_COUNT; j++) {
+        if (j == csgp4::SGP4::ELEMENT_ECCENTRICITY) {
+            continue;
+        }
+        for (int i = 0; i < 3; i++) {
+            EXPECT_NEAR(jacobian.partials[i][j], differences.partials[i][j],
+                        1.0e-4 * fabs(differences.partials[i][j]) + 1.0e-3)
+                << "row " << i << " element " << j;
+        }
+    }
+}
+
+TEST(SGP4Jacobian_suite, SGP4Jacobian_mean_anomaly_is_along_track)
+{
+    // moving the mean anomaly moves the satellite along its orbit
+    csgp4::Tle tle(iss_tle1, iss_tle2);
+    csgp4::OrbitalElements elements(tle);
+    csgp4::SGP4 sgp4(tle);
+
+    csgp4::SGP4::StateJacobian jacobian;
+    csgp4::Eci eci = sgp4.FindPositionJacobian(60.0, jacobian);
+
+    // km per radian = km/s * 60 / (radians per minute)
+    const double scale = 60.0 / elements.RecoveredMeanMotion();
+    EXPECT_NEAR(eci.Velocity().x * scale,
+                jacobian.partials[0][csgp4::SGP4::ELEMENT_MEAN_ANOMALY], 20.0);
+    EXPECT_NEAR(eci.Velocity().y * scale,
+                jacobian.partials[1][csgp4::SGP4::ELEMENT_MEAN_ANOMALY], 20.0);
+    EXPECT_NEAR(eci.Velocity().z * scale,
+                jacobian.partials[2][csgp4::SGP4::ELEMENT_MEAN_ANOMALY], 20.0);
+}
+
+TEST(SGP4Jacobian_suite, SGP4Jacobian_try)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+
+    csgp4::Vector position;
+    csgp4::Vector velocity;
+    csgp4::SGP4::StateJacobian jacobian;
+    EXPECT_EQ(csgp4::PROPAGATION_OK,
+              sgp4.TryFindPositionJacobian(30.0, position, velocity, jacobian));
+    EXPECT_EQ(sgp4.FindPosition(30.0).Position().z, position.z);
+
+    // the low object decays, the state is still returned
+    csgp4::SGP4 low(csgp4::Tle(low_tle1, low_tle2));
+    EXPECT_NE(csgp4::PROPAGATION_OK,
+              low.TryFindPositionJacobian(525600.0, position, velocity, jacobian));
+    EXPECT_ANY_THROW(low.FindPositionJacobian(525600.0, jacobian));
+}
@@ -0,0 +1,265 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/SGP4.h"
+#include "csgp4/SGP4Kernel.h"
+#include "csgp4/OrbitalElements.h"
+#include "csgp4/GravityModel.h"
+#include "csgp4/Dual.h"
+#include "csgp4/Pack.h"
+
+#include "sgp4_ver.h"
+
+// A near space model for the kernel instantiated on T
+template <class T>
+struct Model
+{
+    typedef csgp4::SGP4Kernel<T> Kernel;
+
+    typename Kernel::Elements elements;
+    bool simple;
+    typename Kernel::CommonConstants common;
+    typename Kernel::NearSpaceConstants near;
+
+    // initialise in T itself
+    void Initialise(const csgp4::OrbitalElements& el)
+    {
+        elements.mean_anomaly = el.MeanAnomoly();
+        elements.ascending_node = el.AscendingNode();
+        elements.argument_perigee = el.ArgumentPerigee();
+        elements.eccentricity = el.Eccentricity();
+        elements.inclination = el.Inclination();
+        elements.mean_motion = el.MeanMotion();
+        elements.bstar = el.BStar();
+        Kernel::template Recover<csgp4::Wgs72Gravity>(elements);
+        Kernel::template Initialise<csgp4::Wgs72Gravity>(elements, simple, common, &near);
+    }
+
+    // take the constants of a double model
+    void Convert(const Model<double>& from)
+    {
+        Kernel::template Convert<double>(from.elements, elements);
+        Kernel::template Convert<double>(from.common, common);
+        Kernel::template Convert<double>(from.near, near);
+        simple = from.simple;
+    }
+
+    csgp4::PropagationStatus Propagate(const T& tsince, T* position, T* velocity) const
+    {
+        return Kernel::template Propagate<csgp4::Wgs72Gravity, true>(elements, simple,
+                                                                   common, near,
+                                                                   tsince, position, velocity);
+    }
+};
+
+// Every near space case of the verification set with its samples up to the first failure
+struct NearCase
+{
+    const VerificationCase* c;
+    csgp4::OrbitalElements elements;
+    std::vector<double> tsince;
+    std::vector<csgp4::Vector> position;
+    std::vector<csgp4::Vector> velocity;
+};
+
+static std::vector<NearCase> near_cases()
+{
+    std::vector<NearCase> cases;
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        const csgp4::Tle tle = VerificationTle(kVerificationCases[i]);
+        const csgp4::OrbitalElements elements(tle);
+        if (elements.Period() >= 225.0) {
+            continue;
+        }
+        NearCase nc = { &kVerificationCases[i], elements, {}, {}, {} };
+        const csgp4::SGP4 sgp4(tle);
+        for (double t : VerificationGrid(kVerificationCases[i])) {
+            csgp4::Vector position, velocity;
+            if (sgp4.TryFindPosition(t, position, velocity) != csgp4::PROPAGATION_OK) {
+                break;
+            }
+            nc.tsince.push_back(t);
+            nc.position.push_back(position);
+            nc.velocity.push_back(velocity);
+        }
+        cases.push_back(nc);
+    }
+    return cases;
+}
+
+static double distance(const csgp4::Vector& a, double x, double y, double z)
+{
+    return sqrt((a.x - x) * (a.x - x) + (a.y - y) * (a.y - y) + (a.z - z) * (a.z - z));
+}
+
+TEST(SGP4Kernel_suite, SGP4Kernel_double)
+{
+    // the library runs this instantiation, so it must be SGP4 exactly
+    const std::vector<NearCase> cases = near_cases();
+    ASSERT_FALSE(cases.empty());
+    for (const NearCase& nc : cases) {
+        SCOPED_TRACE(nc.c->name);
+        Model<double> model;
+        model.Initialise(nc.elements);
+        for (size_t i = 0; i < nc.tsince.size(); i++) {
+            double pos[3]{}, vel[3]{};
+            ASSERT_EQ(csgp4::PROPAGATION_OK, model.Propagate(nc.tsince[i], pos, vel));
+            EXPECT_EQ(nc.position[i].x, pos[0]);
+            EXPECT_EQ(nc.position[i].y, pos[1]);
+            EXPECT_EQ(nc.position[i].z, pos[2]);
+            EXPECT_EQ(nc.velocity[i].x, vel[0]);
+            EXPECT_EQ(nc.velocity[i].y, vel[1]);
+            EXPECT_EQ(nc.velocity[i].z, vel[2]);
+        }
+    }
+}
+
+TEST(SGP4Kernel_suite, SGP4Kernel_dual)
+{
+    // differentiate with respect to time, against central differences
+    typedef csgp4::Dual<1> D;
+    const double h = 1.0e-3;
+    for (const NearCase& nc : near_cases()) {
+        SCOPED_TRACE(nc.c->name);
+        Model<D> model;
+        model.Initialise(nc.elements);
+        Model<double> scalar;
+        scalar.Initialise(nc.elements);
+        for (size_t i = 0; i < nc.tsince.size(); i++) {
+            D pos[3], vel[3];
+            ASSERT_EQ(csgp4::PROPAGATION_OK,
+                      model.Propagate(D::Variable(nc.tsince[i], 0), pos, vel));
+            EXPECT_EQ(nc.position[i].x, pos[0].value);
+            EXPECT_EQ(nc.position[i].y, pos[1].value);
+            EXPECT_EQ(nc.position[i].z, pos[2].value);
+            EXPECT_EQ(nc.velocity[i].z, vel[2].value);
+
+            double before[3], after[3], unused[3];
+            scalar.Propagate(nc.tsince[i] - h, before, unused);
+            scalar.Propagate(nc.tsince[i] + h, after, unused);
+            for (int k = 0; k < 3; k++) {
+                EXPECT_NEAR((after[k] - before[k]) / (2.0 * h), pos[k].partials[0], 1.0e-4);
+            }
+        }
+    }
+}
+
+TEST(SGP4Kernel_suite, SGP4Kernel_float)
+{
+    // initialised and propagated in single precision
+    for (const NearCase& nc : near_cases()) {
+        SCOPED_TRACE(nc.c->name);
+        Model<float> model;
+        model.Initialise(nc.elements);
+        for (size_t i = 0; i < nc.tsince.size(); i++) {
+            float pos[3]{}, vel[3]{};
+            ASSERT_EQ(csgp4::PROPAGATION_OK,
+                      model.Propagate(static_cast<float>(nc.tsince[i]), pos, vel));
+            EXPECT_LT(distance(nc.position[i], pos[0], pos[1], pos[2]), 0.5);
+            EXPECT_LT(distance(nc.velocity[i], vel[0], vel[1], vel[2]), 5.0e-4);
+        }
+    }
+}
+
+TEST(SGP4Kernel_suite, SGP4Kernel_pack_double)
+{
+    // consecutive samples in the lanes, each lane is SGP4 exactly
+    typedef csgp4::Pack<double, 4> P;
+    for (const NearCase& nc : near_cases()) {
+        SCOPED_TRACE(nc.c->name);
+        Model<double> scalar;
+        scalar.Initialise(nc.elements);
+        Model<P> model;
+        model.Convert(scalar);
+        for (size_t i = 0; i + 4 <= nc.tsince.size(); i += 4) {
+            P pos[3], vel[3];
+            ASSERT_EQ(csgp4::PROPAGATION_OK, model.Propagate(P::Load(&nc.tsince[i]), pos, vel));
+            for (size_t l = 0; l < 4; l++) {
+                EXPECT_EQ(nc.position[i + l].x, pos[0][l]);
+                EXPECT_EQ(nc.position[i + l].y, pos[1][l]);
+                EXPECT_EQ(nc.position[i + l].z, pos[2][l]);
+                EXPECT_EQ(nc.velocity[i + l].x, vel[0][l]);
+            }
+        }
+    }
+}
+
+TEST(SGP4Kernel_suite, SGP4Kernel_pack_float)
+{
+    // initialised in double, propagated in single precision 8 lanes at a time
+    typedef csgp4::Pack<float, 8> P;
+    for (const NearCase& nc : near_cases()) {
+        SCOPED_TRACE(nc.c->name);
+        Model<double> scalar;
+        scalar.Initialise(nc.elements);
+        Model<P> model;
+        model.Convert(scalar);
+        for (size_t i = 0; i + 8 <= nc.tsince.size(); i += 8) {
+            float tsince[8];
+            for (size_t l = 0; l < 8; l++) {
+                tsince[l] = static_cast<float>(nc.tsince[i + l]);
+            }
+            P pos[3], vel[3];
+            ASSERT_EQ(csgp4::PROPAGATION_OK, model.Propagate(P::Load(tsince), pos, vel));
+            for (size_t l = 0; l < 8; l++) {
+                EXPECT_LT(distance(nc.position[i + l], pos[0][l], pos[1][l], pos[2][l]), 0.5);
+                EXPECT_LT(distance(nc.velocity[i + l], vel[0][l], vel[1][l], vel[2][l]), 5.0e-4);
+            }
+        }
+    }
+}
+
+TEST(SGP4Kernel_suite, SGP4Kernel_pack_status)
+{
+    // a lane that fails fails the pack, the other lanes are left to be redone
+    typedef csgp4::Pack<double, 2> P;
+    const VerificationCase* str3 = nullptr;
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        if (std::string(kVerificationCases[i].name).find("STR#3") != std::string::npos) {
+            str3 = &kVerificationCases[i];
+        }
+    }
+    ASSERT_NE(nullptr, str3);
+
+    const csgp4::Tle tle = VerificationTle(*str3);
+    const csgp4::SGP4 sgp4(tle);
+    csgp4::Vector position, velocity;
+    const double good = 0.0;
+    double bad = 0.0;
+    while (sgp4.TryFindPosition(bad, position, velocity) == csgp4::PROPAGATION_OK) {
+        bad += 60.0;
+    }
+    const csgp4::PropagationStatus expected = sgp4.TryFindPosition(bad, position, velocity);
+
+    Model<double> scalar;
+    scalar.Initialise(csgp4::OrbitalElements(tle));
+    Model<P> model;
+    model.Convert(scalar);
+    const double tsince[2] = { good, bad };
+    P pos[3], vel[3];
+    EXPECT_EQ(expected, model.Propagate(P::Load(tsince), pos, vel));
+}
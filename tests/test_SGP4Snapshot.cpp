@@ -0,0 +1,163 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/SGP4Snapshot.h"
+
+#include "sgp4_ver.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string molniya_tle1("1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813");
+static std::string molniya_tle2("2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+
+static std::string ReadFile(const std::string& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void WriteFile(const std::string& path, const std::string& data)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << data;
+}
+
+TEST(SGP4Snapshot_suite, SGP4Snapshot_round_trip)
+{
+    // every verification case under every gravity model, which covers the
+    // simple, near space, deep space and both resonant models
+    std::vector<csgp4::SGP4> models;
+    std::vector<unsigned int> norad_numbers;
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        const csgp4::Tle tle = VerificationTle(kVerificationCases[i]);
+        for (csgp4::GravityModel model : { csgp4::GRAVITY_WGS72_OLD, csgp4::GRAVITY_WGS72, csgp4::GRAVITY_WGS84 }) {
+            models.emplace_back(tle, model);
+            norad_numbers.push_back(tle.NoradNumber());
+        }
+    }
+
+    const std::string path = ::testing::TempDir() + "test_SGP4Snapshot.bin";
+    ASSERT_TRUE(csgp4::SGP4Snapshot::Save(path, models, norad_numbers));
+    csgp4::SGP4Snapshot dut = csgp4::SGP4Snapshot::Load(path);
+    std::remove(path.c_str());
+    ASSERT_EQ("", dut.Error());
+    ASSERT_EQ(models.size(), dut.Size());
+
+    // restored, the propagators give the same results to the bit
+    const std::vector<csgp4::SGP4> restored = dut.Models();
+    for (size_t i = 0; i < models.size(); i++) {
+        const VerificationCase& c = kVerificationCases[i / 3];
+        SCOPED_TRACE(c.name);
+        EXPECT_EQ(norad_numbers[i], dut.NoradNumber(i));
+        EXPECT_EQ(models[i].Gravity(), restored[i].Gravity());
+
+        csgp4::SGP4::IntegratorParams integ_a;
+        csgp4::SGP4::IntegratorParams integ_b;
+        for (double t : VerificationGrid(c)) {
+            csgp4::Vector pa, va, pb, vb;
+            const csgp4::PropagationStatus a = models[i].TryFindPosition(t, integ_a, pa, va);
+            const csgp4::PropagationStatus b = restored[i].TryFindPosition(t, integ_b, pb, vb);
+            ASSERT_EQ(a, b);
+            if (a != csgp4::PROPAGATION_OK) {
+                break;
+            }
+            ASSERT_EQ(pa.x, pb.x);
+            ASSERT_EQ(pa.y, pb.y);
+            ASSERT_EQ(pa.z, pb.z);
+            ASSERT_EQ(va.x, vb.x);
+            ASSERT_EQ(va.y, vb.y);
+            ASSERT_EQ(va.z, vb.z);
+        }
+    }
+}
+
+TEST(SGP4Snapshot_suite, SGP4Snapshot_catalog)
+{
+    csgp4::SGP4Catalog catalog;
+    catalog.Update({ csgp4::Tle(iss_tle1, iss_tle2), csgp4::Tle(molniya_tle1, molniya_tle2) });
+
+    const std::string path = ::testing::TempDir() + "test_SGP4Snapshot_catalog.bin";
+    ASSERT_TRUE(csgp4::SGP4Snapshot::Save(path, catalog));
+    csgp4::SGP4Snapshot loaded = csgp4::SGP4Snapshot::Load(path);
+    std::remove(path.c_str());
+
+    // moving hands over the mapping
+    csgp4::SGP4Snapshot dut = std::move(loaded);
+    EXPECT_EQ(0u, loaded.Size());
+    ASSERT_EQ(2u, dut.Size());
+    EXPECT_EQ(25544u, dut.NoradNumber(0));
+    EXPECT_EQ(8195u, dut.NoradNumber(1));
+
+    const csgp4::Eci a = catalog.At(1).FindPosition(1440.0);
+    const csgp4::Eci b = dut.Model(1).FindPosition(1440.0);
+    EXPECT_EQ(a.Position().x, b.Position().x);
+    EXPECT_EQ(a.Velocity().z, b.Velocity().z);
+
+    // a propagator and norad number each
+    EXPECT_FALSE(csgp4::SGP4Snapshot::Save(path, catalog.Models(), { 25544 }));
+}
+
+TEST(SGP4Snapshot_suite, SGP4Snapshot_refused)
+{
+    const std::string path = ::testing::TempDir() + "test_SGP4Snapshot_refused.bin";
+    csgp4::SGP4Snapshot dut = csgp4::SGP4Snapshot::Load(path);
+    EXPECT_EQ(0u, dut.Size());
+    EXPECT_EQ("Unable to open " + path, dut.Error());
+
+    csgp4::SGP4Catalog catalog;
+    catalog.Update({ csgp4::Tle(iss_tle1, iss_tle2), csgp4::Tle(molniya_tle1, molniya_tle2) });
+    ASSERT_TRUE(csgp4::SGP4Snapshot::Save(path, catalog));
+    const std::string good = ReadFile(path);
+
+    // a file that differs from what this build writes in the given bytes
+    auto refused = [&path, &good](size_t offset, const std::string& bytes, size_t size) {
+        std::string bad = good.substr(0, size);
+        bad.replace(offset, bytes.size(), bytes);
+        WriteFile(path, bad);
+        csgp4::SGP4Snapshot snapshot = csgp4::SGP4Snapshot::Load(path);
+        EXPECT_EQ(0u, snapshot.Size());
+        return snapshot.Error();
+    };
+    EXPECT_EQ("Not a snapshot " + path, refused(0, "[\n", good.size()));
+    EXPECT_EQ("Not a snapshot " + path, refused(0, "", 10));
+    EXPECT_EQ("Other byte order in " + path, refused(8, std::string("\x01\x02\x03\x04", 4), good.size()));
+    EXPECT_EQ("Unsupported version in " + path, refused(12, std::string("\x01\0\0\0", 4), good.size()));
+    EXPECT_EQ("Other record layout in " + path, refused(20, std::string("\x08\0\0\0", 4), good.size()));
+    EXPECT_EQ("Other record layout in " + path, refused(48, std::string("\x01", 1), good.size()));
+    EXPECT_EQ("Truncated " + path, refused(0, "", good.size() - 1));
+    EXPECT_EQ("Invalid record in " + path, refused(64 + 4, std::string("\x07\0\0\0", 4), good.size()));
+
+    WriteFile(path, good);
+    dut = csgp4::SGP4Snapshot::Load(path);
+    std::remove(path.c_str());
+    EXPECT_EQ("", dut.Error());
+    EXPECT_EQ(2u, dut.Size());
+}
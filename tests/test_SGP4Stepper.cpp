@@ -0,0 +1,105 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <gtest/gtest.h>
+
+#include "csgp4/SGP4Stepper.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string molniya_tle1("1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813");
+static std::string molniya_tle2("2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+static std::string str3_tle1("1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    18");
+static std::string str3_tle2("2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518   105");
+
+static void expect_matches_scalar(const csgp4::SGP4& sgp4, double start, double step, size_t n)
+{
+    csgp4::SGP4Stepper dut(sgp4, start, step);
+    csgp4::SGP4::IntegratorParams integ;
+    csgp4::Vector pos, vel, expected_pos, expected_vel;
+    for (size_t i = 0; i < n; i++) {
+        const double tsince = start + step * i;
+        EXPECT_DOUBLE_EQ(tsince, dut.Time());
+        ASSERT_EQ(csgp4::PROPAGATION_OK, dut.Next(pos, vel));
+        ASSERT_EQ(csgp4::PROPAGATION_OK,
+            sgp4.TryFindPosition(tsince, integ, expected_pos, expected_vel));
+        ASSERT_NEAR(expected_pos.x, pos.x, 1.0e-8);
+        ASSERT_NEAR(expected_pos.y, pos.y, 1.0e-8);
+        ASSERT_NEAR(expected_pos.z, pos.z, 1.0e-8);
+        ASSERT_NEAR(expected_vel.x, vel.x, 1.0e-11);
+        ASSERT_NEAR(expected_vel.y, vel.y, 1.0e-11);
+        ASSERT_NEAR(expected_vel.z, vel.z, 1.0e-11);
+    }
+    EXPECT_EQ(n, dut.Index());
+}
+
+TEST(SGP4Stepper_suite, SGP4Stepper_one_day_at_1hz)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    expect_matches_scalar(sgp4, 0.0, 1.0 / 60.0, 86400);
+}
+
+TEST(SGP4Stepper_suite, SGP4Stepper_backwards_from_a_week_out)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    expect_matches_scalar(sgp4, 10080.0, -0.5, 20160);
+}
+
+TEST(SGP4Stepper_suite, SGP4Stepper_wgs84)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2), csgp4::GRAVITY_WGS84);
+    expect_matches_scalar(sgp4, -720.0, 0.25, 5760);
+}
+
+TEST(SGP4Stepper_suite, SGP4Stepper_deep_space)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(molniya_tle1, molniya_tle2));
+    expect_matches_scalar(sgp4, 0.0, 1.0, 2880);
+}
+
+TEST(SGP4Stepper_suite, SGP4Stepper_position_only)
+{
+    csgp4::SGP4 sgp4(csgp4::Tle(iss_tle1, iss_tle2));
+    csgp4::SGP4Stepper dut(sgp4, 0.0, 1.0 / 60.0, 16);
+    csgp4::Vector pos, expected;
+    for (int i = 0; i < 3600; i++) {
+        ASSERT_EQ(csgp4::PROPAGATION_OK, dut.Next(pos));
+        ASSERT_EQ(csgp4::PROPAGATION_OK, sgp4.TryFindPositionOnly(i / 60.0, expected));
+        ASSERT_NEAR(expected.x, pos.x, 1.0e-8);
+        ASSERT_NEAR(expected.y, pos.y, 1.0e-8);
+        ASSERT_NEAR(expected.z, pos.z, 1.0e-8);
+    }
+}
+
+TEST(SGP4Stepper_suite, SGP4Stepper_error_status)
+{
+    // STR#3 has an eccentricity error long before a year is out
+    csgp4::SGP4 sgp4(csgp4::Tle(str3_tle1, str3_tle2));
+    csgp4::SGP4Stepper dut(sgp4, 525600.0, 1.0);
+    csgp4::Vector pos, vel;
+    EXPECT_EQ(sgp4.TryFindPosition(525600.0, pos, vel), dut.Next(pos, vel));
+    EXPECT_EQ(csgp4::PROPAGATION_ECCENTRICITY, sgp4.TryFindPosition(525601.0, pos, vel));
+    EXPECT_EQ(csgp4::PROPAGATION_ECCENTRICITY, dut.Next(pos, vel));
+    EXPECT_EQ(2u, dut.Index());
+}
@@ -0,0 +1,220 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/SGP4.h"
+#include "csgp4/SGP4Batch.h"
+#include "csgp4/SGP4Stepper.h"
+#include "csgp4/CatalogPropagator.h"
+#include "csgp4/SatelliteException.h"
+#include "csgp4/DecayedException.h"
+
+#include "sgp4_ver.h"
+
+// the status of every sample of a case, from the scalar model
+static std::vector<csgp4::PropagationStatus> scalar_statuses(const csgp4::SGP4& sgp4,
+    const std::vector<double>& tsince)
+{
+    std::vector<csgp4::PropagationStatus> status;
+    csgp4::SGP4::IntegratorParams integ;
+    csgp4::Vector position, velocity;
+    for (double t : tsince) {
+        status.push_back(sgp4.TryFindPosition(t, integ, position, velocity));
+    }
+    return status;
+}
+
+static void expect_vector_near(const double* expected, const csgp4::Vector& actual, double tolerance)
+{
+    EXPECT_NEAR(expected[0], actual.x, tolerance);
+    EXPECT_NEAR(expected[1], actual.y, tolerance);
+    EXPECT_NEAR(expected[2], actual.z, tolerance);
+}
+
+TEST(SGP4Verification_suite, SGP4Verification_reference)
+{
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        const VerificationCase& c = kVerificationCases[i];
+        const VerificationReference& ref = kVerificationReferences[i];
+        SCOPED_TRACE(c.name);
+        csgp4::SGP4 sgp4(VerificationTle(c));
+        const std::vector<double> tsince = VerificationGrid(c);
+        const std::vector<csgp4::PropagationStatus> status = scalar_statuses(sgp4, tsince);
+
+        size_t samples = 0;
+        while (samples < status.size() && status[samples] == csgp4::PROPAGATION_OK) {
+            samples++;
+        }
+        EXPECT_EQ(ref.samples, samples);
+        EXPECT_EQ(ref.failure, samples < status.size() ? status[samples] : csgp4::PROPAGATION_OK);
+
+        if (samples == 0) {
+            continue;
+        }
+
+        // allow for differences in the maths library between platforms
+        csgp4::Vector position, velocity;
+        csgp4::SGP4::IntegratorParams integ;
+        ASSERT_EQ(csgp4::PROPAGATION_OK, sgp4.TryFindPosition(ref.first_tsince, integ, position, velocity));
+        expect_vector_near(ref.first_position, position, 1.0e-6);
+        expect_vector_near(ref.first_velocity, velocity, 1.0e-9);
+        ASSERT_EQ(csgp4::PROPAGATION_OK, sgp4.TryFindPosition(ref.last_tsince, integ, position, velocity));
+        expect_vector_near(ref.last_position, position, 1.0e-6);
+        expect_vector_near(ref.last_velocity, velocity, 1.0e-9);
+    }
+}
+
+TEST(SGP4Verification_suite, SGP4Verification_exceptions)
+{
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        const VerificationCase& c = kVerificationCases[i];
+        SCOPED_TRACE(c.name);
+        csgp4::SGP4 sgp4(VerificationTle(c));
+        const std::vector<double> tsince = VerificationGrid(c);
+        const std::vector<csgp4::PropagationStatus> status = scalar_statuses(sgp4, tsince);
+
+        for (size_t k = 0; k < tsince.size(); k++) {
+            if (status[k] == csgp4::PROPAGATION_OK) {
+                EXPECT_NO_THROW(sgp4.FindPosition(tsince[k]));
+            } else if (status[k] == csgp4::PROPAGATION_DECAYED) {
+                EXPECT_THROW(sgp4.FindPosition(tsince[k]), csgp4::DecayedException);
+            } else {
+                EXPECT_THROW(sgp4.FindPosition(tsince[k]), csgp4::SatelliteException);
+            }
+        }
+    }
+}
+
+TEST(SGP4Verification_suite, SGP4Verification_position_only)
+{
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        const VerificationCase& c = kVerificationCases[i];
+        SCOPED_TRACE(c.name);
+        csgp4::SGP4 sgp4(VerificationTle(c));
+        csgp4::SGP4::IntegratorParams integ, integ_only;
+
+        for (double t : VerificationGrid(c)) {
+            csgp4::Vector position, velocity, position_only;
+            const csgp4::PropagationStatus status = sgp4.TryFindPosition(t, integ, position, velocity);
+            ASSERT_EQ(status, sgp4.TryFindPositionOnly(t, integ_only, position_only));
+            if (status == csgp4::PROPAGATION_OK) {
+                EXPECT_EQ(position.x, position_only.x);
+                EXPECT_EQ(position.y, position_only.y);
+                EXPECT_EQ(position.z, position_only.z);
+            }
+        }
+    }
+}
+
+TEST(SGP4Verification_suite, SGP4Verification_batch)
+{
+    std::vector<csgp4::SGP4> models;
+    std::vector<std::vector<double>> grids;
+    size_t longest = 0;
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        models.emplace_back(VerificationTle(kVerificationCases[i]));
+        grids.push_back(VerificationGrid(kVerificationCases[i]));
+        longest = std::max(longest, grids.back().size());
+    }
+
+    // sample k of every case at once, holding shorter grids at their end
+    const csgp4::SGP4Batch batch(models);
+    const size_t n = models.size();
+    for (size_t k = 0; k < longest; k++) {
+        std::vector<double> tsince(n), x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+        std::vector<csgp4::PropagationStatus> status(n);
+        for (size_t i = 0; i < n; i++) {
+            tsince[i] = grids[i][std::min(k, grids[i].size() - 1)];
+        }
+        batch.FindPositions(tsince.data(), x.data(), y.data(), z.data(),
+            xdot.data(), ydot.data(), zdot.data(), status.data());
+
+        for (size_t i = 0; i < n; i++) {
+            SCOPED_TRACE(kVerificationCases[i].name);
+            csgp4::Vector position, velocity;
+            ASSERT_EQ(models[i].TryFindPosition(tsince[i], position, velocity), status[i]);
+            if (status[i] == csgp4::PROPAGATION_OK) {
+                EXPECT_NEAR(position.x, x[i], 1.0e-8);
+                EXPECT_NEAR(position.y, y[i], 1.0e-8);
+                EXPECT_NEAR(position.z, z[i], 1.0e-8);
+                EXPECT_NEAR(velocity.x, xdot[i], 1.0e-11);
+                EXPECT_NEAR(velocity.y, ydot[i], 1.0e-11);
+                EXPECT_NEAR(velocity.z, zdot[i], 1.0e-11);
+            }
+        }
+    }
+}
+
+TEST(SGP4Verification_suite, SGP4Verification_stepper)
+{
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        const VerificationCase& c = kVerificationCases[i];
+        SCOPED_TRACE(c.name);
+        csgp4::SGP4 sgp4(VerificationTle(c));
+        csgp4::SGP4Stepper stepper(sgp4, c.start, c.step);
+        csgp4::SGP4::IntegratorParams integ;
+
+        for (double t : VerificationGrid(c)) {
+            csgp4::Vector position, velocity, expected_position, expected_velocity;
+            const csgp4::PropagationStatus status = stepper.Next(position, velocity);
+            ASSERT_EQ(sgp4.TryFindPosition(t, integ, expected_position, expected_velocity), status);
+            if (status == csgp4::PROPAGATION_OK) {
+                EXPECT_NEAR(expected_position.x, position.x, 1.0e-8);
+                EXPECT_NEAR(expected_position.y, position.y, 1.0e-8);
+                EXPECT_NEAR(expected_position.z, position.z, 1.0e-8);
+                EXPECT_NEAR(expected_velocity.x, velocity.x, 1.0e-11);
+                EXPECT_NEAR(expected_velocity.y, velocity.y, 1.0e-11);
+                EXPECT_NEAR(expected_velocity.z, velocity.z, 1.0e-11);
+            }
+        }
+    }
+}
+
+TEST(SGP4Verification_suite, SGP4Verification_catalog_propagator)
+{
+    const csgp4::CatalogPropagator propagator(3);
+    for (size_t i = 0; i < kVerificationCount; i++) {
+        const VerificationCase& c = kVerificationCases[i];
+        SCOPED_TRACE(c.name);
+        const std::vector<csgp4::SGP4> models(1, csgp4::SGP4(VerificationTle(c)));
+        const std::vector<double> tsince = VerificationGrid(c);
+        const size_t n = tsince.size();
+        std::vector<double> x(n), y(n), z(n), xdot(n), ydot(n), zdot(n);
+        std::vector<csgp4::PropagationStatus> status(n);
+        propagator.Propagate(models, tsince.data(), n, x.data(), y.data(), z.data(),
+            xdot.data(), ydot.data(), zdot.data(), status.data());
+        EXPECT_TRUE(scalar_statuses(models[0], tsince) == status);
+
+        csgp4::SGP4::IntegratorParams integ;
+        for (size_t k = 0; k < n; k++) {
+            csgp4::Vector position, velocity;
+            if (models[0].TryFindPosition(tsince[k], integ, position, velocity) == csgp4::PROPAGATION_OK) {
+                EXPECT_EQ(position.x, x[k]);
+                EXPECT_EQ(velocity.z, zdot[k]);
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <string>
+#include <thread>
+#include <gtest/gtest.h>
+
+#include "csgp4/Stats.h"
+#include "csgp4/SGP4.h"
+#include "csgp4/Observer.h"
+#include "csgp4/CoordTopocentric.h"
+#include "csgp4/SatelliteException.h"
+#include "csgp4/DecayedException.h"
+#include "csgp4/TleException.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+static std::string str3_tle1("1 88888U          80275.98708465  .00073094  13844-3  66816-4 0    18");
+static std::string str3_tle2("2 88888  72.8435 115.9689 0086731  52.6988 110.5714 16.05824518   105");
+
+// Everything the library does on this thread, counted or not
+static void exercise()
+{
+    csgp4::SGP4 iss(csgp4::Tle(iss_tle1, iss_tle2));
+    for (int i = 0; i < 10; i++) {
+        iss.FindPosition(i * 1.0);
+    }
+
+    csgp4::SGP4 geo(csgp4::Tle(geo_tle1, geo_tle2));
+    geo.FindPosition(1440.0);
+    geo.FindPosition(2880.0);
+
+    csgp4::Observer observer(51.0, -3.0, 10.0);
+    const csgp4::Eci eci = iss.FindPosition(5.0);
+    observer.GetLookAngle(eci);
+    observer.GetLookAngle(eci);
+
+    csgp4::SGP4 str3(csgp4::Tle(str3_tle1, str3_tle2));
+    EXPECT_THROW(str3.FindPosition(525600.0), csgp4::SatelliteException);
+    std::string bad("1 25544U");
+    EXPECT_THROW(csgp4::Tle(bad, bad), csgp4::TleException);
+}
+
+TEST(Stats_suite, Stats_counts)
+{
+    csgp4::Stats::Reset();
+    exercise();
+    const csgp4::StatsCounters counts = csgp4::Stats::ThreadSnapshot();
+
+    if (!csgp4::Stats::Enabled()) {
+        EXPECT_EQ(0u, counts.kepler_solves);
+        EXPECT_EQ(0u, counts.initialise_calls);
+        EXPECT_EQ(0u, counts.satellite_exceptions);
+        return;
+    }
+
+    EXPECT_EQ(3u, counts.initialise_calls);
+    // str3 throws before it reaches the solver
+    EXPECT_EQ(13u, counts.kepler_solves);
+    EXPECT_GE(counts.kepler_iterations, counts.kepler_solves);
+    // geo starts from epoch once, then carries on forward; 2880 is 4
+    // full steps of 720
+    EXPECT_EQ(1u, counts.integrator_restarts);
+    EXPECT_EQ(4u, counts.integrator_steps);
+    EXPECT_EQ(0u, counts.integrator_checkpoints);
+    EXPECT_EQ(1u, counts.observer_cache_misses);
+    EXPECT_EQ(1u, counts.observer_cache_hits);
+    EXPECT_EQ(1u, counts.satellite_exceptions);
+    EXPECT_EQ(0u, counts.decayed_exceptions);
+    EXPECT_EQ(1u, counts.tle_exceptions);
+}
+
+TEST(Stats_suite, Stats_threads)
+{
+    csgp4::Stats::Reset();
+    exercise();
+    const csgp4::StatsCounters mine = csgp4::Stats::ThreadSnapshot();
+
+    std::thread other([]() {
+        exercise();
+        exercise();
+        // a new thread starts from zero
+    });
+    other.join();
+
+    // the finished thread is kept in the totals
+    const csgp4::StatsCounters all = csgp4::Stats::Snapshot();
+    EXPECT_EQ(3 * mine.kepler_solves, all.kepler_solves);
+    EXPECT_EQ(3 * mine.initialise_calls, all.initialise_calls);
+    EXPECT_EQ(3 * mine.tle_exceptions, all.tle_exceptions);
+    EXPECT_EQ(mine.kepler_solves, csgp4::Stats::ThreadSnapshot().kepler_solves);
+
+    csgp4::Stats::Reset();
+    EXPECT_EQ(0u, csgp4::Stats::Snapshot().kepler_solves);
+}
@@ -21,6 +21,8 @@
  ***********************************************************************************/
 
 #include <cmath>
+#include <cstdlib>
+#include <new>
 #include <string>
 #include <sstream>
 #include <gtest/gtest.h>
@@ -28,6 +30,30 @@
 #include "common.h"
 #include "csgp4/Tle.h"
 
+// count every allocation in this test program, for Tle_SetLines_no_allocation
+
+static size_t allocations = 0;
+
+void* operator new(size_t size)
+{
+    allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
 static std::string expect_string()
 {
     if(iss.length() == 0) {
@@ -164,8 +190,8 @@ TEST(Tle_suite, Tle_ctor_Args)
     args.mean_motion_ddot = 0;    
     
     csgp4::Tle dut(args);
-    // Note, iso8601 time is to 3 decimal places.
-    expect = std::string("2022-11-08 06:14:56.037000 UTC");
+    // the iso8601 time is kept to the microsecond
+    expect = std::string("2022-11-08 06:14:56.037120 UTC");
     actual = dut.Epoch().ToString();
     EXPECT_STREQ(expect.c_str(), actual.c_str());
     
@@ -178,3 +204,61 @@ TEST(Tle_suite, Tle_ctor_Args)
 
 
 
+
+TEST(Tle_suite, Tle_SetLines)
+{
+    std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+    std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+    csgp4::Tle dut(iss_tle0, iss_tle1, iss_tle2);
+
+    dut.SetLines(geo_tle1, geo_tle2);
+    csgp4::Tle expect(geo_tle1, geo_tle2);
+    EXPECT_EQ(expect.ToString(), dut.ToString());
+    EXPECT_EQ("28626", dut.Name());
+    EXPECT_EQ(geo_tle2, dut.Line2());
+
+    dut.SetLines(iss_tle0, iss_tle1, iss_tle2);
+    EXPECT_EQ(expect_string(), dut.ToString());
+    EXPECT_EQ(iss_tle0, dut.Name());
+}
+
+TEST(Tle_suite, Tle_SetLines_no_allocation)
+{
+    // decoding into an object that has held a tle reuses its storage
+    csgp4::Tle dut(iss_tle1, iss_tle2);
+    const size_t before = allocations;
+    for (int i = 0; i < 100; i++) {
+        dut.SetLines(iss_tle1, iss_tle2);
+    }
+    EXPECT_EQ(before, allocations);
+    EXPECT_EQ(25544u, dut.NoradNumber());
+    EXPECT_EQ(0.00026300, dut.BStar());
+}
+
+TEST(Tle_suite, Tle_invalid_fields)
+{
+    std::string line1(iss_tle1);
+    std::string line2(iss_tle2);
+
+    line1[20] = 'x';  // epoch day digits
+    EXPECT_THROW(csgp4::Tle(line1, line2), csgp4::TleException);
+
+    line1 = iss_tle1;
+    line1[59] = '5';  // bstar exponent sign
+    EXPECT_THROW(csgp4::Tle(line1, line2), csgp4::TleException);
+
+    line1 = iss_tle1;
+    line2[11] = ',';  // inclination decimal point
+    EXPECT_THROW(csgp4::Tle(line1, line2), csgp4::TleException);
+
+    line2 = iss_tle2;
+    line2[6] = '5';   // norad number
+    EXPECT_THROW(csgp4::Tle(line1, line2), csgp4::TleException);
+
+    // a signed or blank integer part is accepted
+    line2 = iss_tle2;
+    line1.replace(33, 10, "+.00014546");
+    EXPECT_EQ(0.00014546, csgp4::Tle(line1, line2).MeanMotionDt2());
+    line1.replace(33, 10, "-.00014546");
+    EXPECT_EQ(-0.00014546, csgp4::Tle(line1, line2).MeanMotionDt2());
+}
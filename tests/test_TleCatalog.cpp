@@ -0,0 +1,158 @@
+/*********************************************************************************
+ *   Copyright (c) 2022 Andy Kirkham  All rights reserved.
+ *
+ *   Permission is hereby granted, free of charge, to any person obtaining a copy
+ *   of this software and associated documentation files (the "Software"),
+ *   to deal in the Software without restriction, including without limitation
+ *   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *   and/or sell copies of the Software, and to permit persons to whom
+ *   the Software is furnished to do so, subject to the following conditions:
+ *
+ *   The above copyright notice and this permission notice shall be included
+ *   in all copies or substantial portions of the Software.
+ *
+ *   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *   IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ *   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+ *   IN THE SOFTWARE.
+ ***********************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+#include "csgp4/TleCatalog.h"
+
+#include "sgp4_ver.h"
+
+static std::string iss_tle1("1 25544U 98067A   22314.50373836  .00014546  00000-0  26300-3 0  9991");
+static std::string iss_tle2("2 25544  51.6436 331.7596 0006814  57.2751  98.3376 15.49917581367874");
+static std::string geo_tle1("1 28626U 05008A   06176.46683397 -.00000205  00000-0  10000-3 0  2190");
+static std::string geo_tle2("2 28626   0.0019 286.9433 0000335  13.7918  55.6504  1.00270176  4891");
+static std::string molniya_tle1("1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0   813");
+static std::string molniya_tle2("2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+
+static csgp4::TleCatalog Parse(const std::string& text, unsigned int threads = 1)
+{
+    return csgp4::TleCatalog::Parse(text.data(), text.size(), threads);
+}
+
+TEST(TleCatalog_suite, TleCatalog_names)
+{
+    // 3LE with and without the "0 " prefix, a bare 2LE and windows line endings
+    const std::string text =
+        "0 ISS (ZARYA)\n" + iss_tle1 + "\n" + iss_tle2 + "\n"
+        "\n"
+        + geo_tle1 + "\r\n" + geo_tle2 + "\r\n"
+        "MOLNIYA 1-29  \r\n" + molniya_tle1 + "\r\n" + molniya_tle2;
+    csgp4::TleCatalog dut = Parse(text);
+    EXPECT_TRUE(dut.Errors().empty());
+    ASSERT_EQ(3u, dut.Size());
+    EXPECT_EQ("ISS (ZARYA)", dut.At(0).Name());
+    EXPECT_EQ(25544u, dut.At(0).NoradNumber());
+    EXPECT_EQ("28626", dut.At(1).Name());
+    EXPECT_EQ("MOLNIYA 1-29", dut.At(2).Name());
+    EXPECT_EQ(molniya_tle2, dut.At(2).Line2());
+
+    csgp4::Tle expect(iss_tle1, iss_tle2);
+    EXPECT_EQ(expect.Epoch(), dut.At(0).Epoch());
+    EXPECT_EQ(expect.MeanMotion(), dut.At(0).MeanMotion());
+}
+
+TEST(TleCatalog_suite, TleCatalog_errors)
+{
+    std::string short_tle1 = iss_tle1.substr(0, 60);
+    const std::string text =
+        "ORPHAN\n"                                   // 1
+        "ISS\n" + short_tle1 + "\n" + iss_tle2 + "\n" // 2-4
+        + geo_tle2 + "\n"                            // 5
+        + geo_tle1 + "\n"                            // 6
+        "MOLNIYA\n" + molniya_tle1 + "\n" + molniya_tle2 + "\n" // 7-9
+        "TRAILING\n";                                // 10
+    csgp4::TleCatalog dut = Parse(text);
+    ASSERT_EQ(1u, dut.Size());
+    EXPECT_EQ("MOLNIYA", dut.At(0).Name());
+
+    ASSERT_EQ(5u, dut.Errors().size());
+    EXPECT_EQ(1u, dut.Errors()[0].line);
+    EXPECT_EQ(2u, dut.Errors()[1].line);
+    EXPECT_EQ("Invalid length for line one", dut.Errors()[1].message);
+    EXPECT_EQ(5u, dut.Errors()[2].line);
+    EXPECT_EQ("Line two without line one", dut.Errors()[2].message);
+    EXPECT_EQ(6u, dut.Errors()[3].line);
+    EXPECT_EQ("Line one without line two", dut.Errors()[3].message);
+    EXPECT_EQ(10u, dut.Errors()[4].line);
+}
+
+TEST(TleCatalog_suite, TleCatalog_parallel)
+{
+    // big enough for many chunks, with names, gaps and broken records
+    // scattered so that chunk boundaries land on all of them
+    std::string text;
+    size_t records = 0;
+    size_t orphans = 0; // errors
+    for (size_t n = 0; text.size() < 4 * 1024 * 1024; n++)
+    {
+        const VerificationCase& c = kVerificationCases[n % kVerificationCount];
+        if (n % 3 == 0)
+        {
+            text += "0 SAT " + std::to_string(n) + "\n";
+        }
+        if (n % 101 == 0)
+        {
+            text += std::string(c.line2) + "\n";
+            orphans += n % 3 == 0 ? 2 : 1; // the name goes with it
+        }
+        if (n % 53 == 0)
+        {
+            text += "\n";
+        }
+        text += std::string(c.line1) + "\n" + c.line2 + "\n";
+        records++;
+    }
+
+    const csgp4::TleCatalog serial = Parse(text, 1);
+    EXPECT_EQ(records + orphans, serial.Size() + serial.Errors().size());
+
+    for (unsigned int threads : { 2u, 7u, 16u })
+    {
+        const csgp4::TleCatalog dut = Parse(text, threads);
+        ASSERT_EQ(serial.Size(), dut.Size());
+        for (size_t i = 0; i < dut.Size(); i++)
+        {
+            ASSERT_EQ(serial.At(i).Name(), dut.At(i).Name());
+            ASSERT_EQ(serial.At(i).Line1(), dut.At(i).Line1());
+        }
+        ASSERT_EQ(serial.Errors().size(), dut.Errors().size());
+        for (size_t i = 0; i < dut.Errors().size(); i++)
+        {
+            ASSERT_EQ(serial.Errors()[i].line, dut.Errors()[i].line);
+            ASSERT_EQ(serial.Errors()[i].message, dut.Errors()[i].message);
+        }
+    }
+}
+
+TEST(TleCatalog_suite, TleCatalog_load_file)
+{
+    const std::string path = ::testing::TempDir() + "test_TleCatalog.tle";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << "ISS\n" << iss_tle1 << "\n" << iss_tle2 << "\n" << geo_tle1 << "\n" << geo_tle2 << "\n";
+    }
+    csgp4::TleCatalog dut = csgp4::TleCatalog::LoadFile(path);
+    std::remove(path.c_str());
+    EXPECT_TRUE(dut.Errors().empty());
+    ASSERT_EQ(2u, dut.Size());
+    EXPECT_EQ("ISS", dut.At(0).Name());
+    EXPECT_EQ(28626u, dut.At(1).NoradNumber());
+
+    dut = csgp4::TleCatalog::LoadFile(path);
+    EXPECT_EQ(0u, dut.Size());
+    ASSERT_EQ(1u, dut.Errors().size());
+    EXPECT_EQ(0u, dut.Errors()[0].line);
+}